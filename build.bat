@@ -1,6 +1,22 @@
 @echo off
 cd src
 echo compiling...
-g++ main.cpp game.cpp gamestate.cpp ai.cpp gameui.cpp card.cpp tensor.cpp synergy.cpp minigames.cpp -o ..\TensorConcord.exe -I C:\msys64\mingw64\include -L C:\msys64\mingw64\lib -lpdcurses
+g++ -std=c++20 main.cpp game.cpp gamestate.cpp ai.cpp gameui.cpp framestats.cpp card.cpp tensor.cpp synergy.cpp minigames.cpp rules.cpp effects.cpp minigame_engine.cpp evaluator.cpp solver.cpp spectator.cpp snapshot.cpp protocol.cpp netclient.cpp netplay.cpp ponder.cpp turnflow.cpp book.cpp mcts.cpp rollout.cpp difficulty.cpp -o ..\TensorConcord.exe -I C:\msys64\mingw64\include -L C:\msys64\mingw64\lib -lpdcurses -lws2_32
+echo compiling trainer...
+g++ -std=c++20 -O2 trainer.cpp rules.cpp effects.cpp minigame_engine.cpp evaluator.cpp dataset.cpp gamestate.cpp gameui.cpp framestats.cpp -o ..\trainer.exe -I C:\msys64\mingw64\include -L C:\msys64\mingw64\lib -lpdcurses
+echo compiling tournament...
+g++ -std=c++20 -O2 tournament.cpp mcts.cpp rollout.cpp turnflow.cpp book.cpp solver.cpp rules.cpp effects.cpp minigame_engine.cpp evaluator.cpp gamestate.cpp gameui.cpp framestats.cpp -o ..\tournament.exe -I C:\msys64\mingw64\include -L C:\msys64\mingw64\lib -lpdcurses
+echo compiling bookgen...
+g++ -std=c++20 -O2 bookgen.cpp book.cpp rollout.cpp turnflow.cpp solver.cpp rules.cpp effects.cpp minigame_engine.cpp evaluator.cpp gamestate.cpp gameui.cpp framestats.cpp -o ..\bookgen.exe -I C:\msys64\mingw64\include -L C:\msys64\mingw64\lib -lpdcurses
+echo compiling rulesweep...
+g++ -std=c++20 -O2 rulesweep.cpp rollout.cpp turnflow.cpp book.cpp solver.cpp rules.cpp effects.cpp minigame_engine.cpp evaluator.cpp gamestate.cpp gameui.cpp framestats.cpp -o ..\rulesweep.exe -I C:\msys64\mingw64\include -L C:\msys64\mingw64\lib -lpdcurses
+echo compiling tests...
+g++ -std=c++20 -O2 tests.cpp test_snapshot.cpp test_dataset.cpp test_effects.cpp test_rollout.cpp rules.cpp effects.cpp minigame_engine.cpp snapshot.cpp dataset.cpp rollout.cpp gamestate.cpp gameui.cpp framestats.cpp -o ..\tests.exe -I C:\msys64\mingw64\include -L C:\msys64\mingw64\lib -lpdcurses
+echo running tests...
+..\tests.exe
+if errorlevel 1 (
+    cd ..
+    exit /b 1
+)
 echo Build Successful!
 cd ..
\ No newline at end of file
@@ -1,165 +1,87 @@
 #include "game.h"
+#include "turnflow.h"
+#include "mcts.h"
+#include "ponder.h"
 
-void Game::performEnemyTurn() {
+Rules::Action Game::chooseEnemyAction(const TurnFlow::Match& match) {
+    // The turn's first decision searches as long as the difficulty allows; later ones
+    // follow that search's line and only search again once the position leaves it.
+    // Positions in the opening book or endgame tablebase are answered from it instead.
+    if (match.lastStep().side == Rules::ENEMY) {
+        return enemyAgent->choose(state);
+    }
+
+    // First decision of the turn: a search pondered on the player's time is played as is,
+    // otherwise the search runs inside the usual 1 second pause
     mvprintw(LINES-1, 2, "Enemy turn...");
     refresh();
-    napms(1000);  // 1 second delay
-
-    // Reset enemy champion states
-    for (auto& champ : state.enemyField) {
-        if (champ.type == Card::CHAMPION) {
-            if (champ.turnsInPlay == 0) {
-                champ.turnsInPlay = 1;
-            }
-            champ.hasAttackedThisTurn = false;
-        }
+    Mcts::Result pondered;
+    if (ponderer->lookup(state, pondered)) {
+        enemyAgent->adoptLine(state, std::move(pondered.line));
     }
+    auto start = std::chrono::steady_clock::now();
+    Rules::Action action = enemyAgent->choose(state);
+    auto spent = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    napms(std::max(0, 1000 - static_cast<int>(spent.count())));
+    return action;
+}
 
-    // Try to play cards first
-    bool playedCard = false;
-
-    // Smarter card playing: Try to maintain synergies
-    std::map<Card::Faction, int> factionCounts;
-    for (const auto& card : state.enemyField) {
-        if (card.type == Card::CHAMPION) {
-            factionCounts[card.faction]++;
-        }
-    }
+void Game::executeEnemyAction(TurnFlow::Match& match, const Rules::Action& action) {
+    // Copy what we narrate before the match moves or destroys it
+    int oldGauge = state.tensor.current;
+    if (action.type == Rules::Action::END_TURN) {
+        match.decide(action);
+        mvprintw(LINES-1, 2, "Enemy turn ended.");
+        refresh();
+        napms(1000);
+    } else if (action.type == Rules::Action::PLAY_CARD) {
+        Card card = state.cards.get(state.enemyHand[action.index]);
+        mvprintw(LINES-1, 2, "Enemy is playing a card...");
+        refresh();
+        napms(1000);
 
-    // First try to play cards that would complete synergies
-    for (size_t i = 0; i < state.enemyHand.size(); i++) {
-        const auto& card = state.enemyHand[i];
-        if (card.type == Card::CHAMPION && 
-            factionCounts[card.faction] >= 1 && 
-            card.cost <= state.enemyEnergy) {
-            mvprintw(LINES-1, 2, "Enemy is playing a card...");
-            refresh();
-            napms(1000);
-            playEnemyCard(i);
-            playedCard = true;
-            break;
-        }
-    }
+        Card target = card.type == Card::ARTIFACT ? state.cards.get(state.enemyField[action.target]) : card;
+        match.decide(action);
+        state.printGameState();
 
-    // If no synergy plays, then play highest cost affordable card
-    if (!playedCard) {
-        int bestIdx = -1;
-        int highestCost = -1;
-        for (size_t i = 0; i < state.enemyHand.size(); i++) {
-            const auto& card = state.enemyHand[i];
-            if (card.cost <= state.enemyEnergy && card.cost > highestCost) {
-                highestCost = card.cost;
-                bestIdx = i;
-            }
-        }
-        if (bestIdx != -1) {
-            mvprintw(LINES-1, 2, "Enemy is playing a card...");
-            refresh();
-            napms(1000);
-            playEnemyCard(bestIdx);
+        switch (card.type) {
+            case Card::CHAMPION:
+                mvprintw(LINES-1, 2, "Enemy plays %s (ATK:%d HP:%d)",
+                    card.name(), card.attack, card.health);
+                break;
+            case Card::ARTIFACT:
+                mvprintw(LINES-1, 2, "Enemy buffs %s with %s", target.name(), card.name());
+                break;
+            case Card::TENSOR:
+                mvprintw(LINES-1, 2, "Enemy uses %s for %d energy",
+                    card.name(), card.effect);
+                break;
         }
-    }
-
-    // Then try to attack with each champion
-    for (auto& champ : state.enemyField) {
-        if (champ.type == Card::CHAMPION && !champ.hasAttackedThisTurn && champ.turnsInPlay > 0) {
-            // Simple AI: Attack player directly if no defenders, otherwise attack first defender
-            if (state.playerField.empty()) {
-                state.playerHealth -= champ.attack;
-                mvprintw(LINES-1, 2, "Enemy %s attacks you directly for %d damage!", 
-                        champ.name.c_str(), champ.attack);
-            } else {
-                Card& target = state.playerField[0];
-                target.health -= champ.attack;
-                mvprintw(LINES-1, 2, "Enemy %s attacks your %s for %d damage!", 
-                        champ.name.c_str(), target.name.c_str(), champ.attack);
-                
-                if (target.health <= 0) {
-                    state.playerField.erase(state.playerField.begin());
-                    mvprintw(LINES-1, 2, "Your %s was destroyed!", target.name.c_str());
-                }
+        refresh();
+        napms(1500);
+    } else {
+        Card attacker = state.cards.get(state.enemyField[action.index]);
+        if (action.target < 0) {
+            match.decide(action);
+            mvprintw(LINES-1, 2, "Enemy %s attacks you directly for %d damage!",
+                    attacker.name(), attacker.attack);
+        } else {
+            Card target = state.cards.get(state.playerField[action.target]);
+            match.decide(action);
+            mvprintw(LINES-1, 2, "Enemy %s attacks your %s for %d damage!",
+                    attacker.name(), target.name(), attacker.attack);
+            if (match.lastStep().outcome.destroyed) {
+                refresh();
+                napms(1000);
+                mvprintw(LINES-1, 2, "Your %s was destroyed!", target.name());
             }
-            champ.hasAttackedThisTurn = true;
-            refresh();
-            napms(1500);
         }
+        refresh();
+        napms(1500);
     }
 
-    // Apply VM synergy effects at turn end
-    int vmCount = 0;
-    for (const auto& card : state.enemyField) {
-        if (card.type == Card::CHAMPION && card.faction == Card::Faction::VIRTU_MACHINA) {
-            vmCount++;
-        }
-    }
-    
-    if (vmCount >= 2) {
-        int synergyLevel = calculateSynergyLevel(state.enemyField, Card::Faction::VIRTU_MACHINA);
-        state.enemyEnergy += synergyLevel;
-        increaseTensorGauge(1);
+    if (match.lastStep().outcome.concordia) {
+        announceTensorConcordia();
     }
-
-    // Apply synergies and check VM effects
-    checkAndApplySynergies(state.enemyField, state.enemyHand);
-    
-    // Check for tensor peak at end of turn
-    if (state.tensor.current >= state.tensor.maximum) {
-        handleTensorPeak();
-    }
-
-    // End turn
-    state.isPlayerTurn = true;
-    state.enemyEnergy += 1;
-    drawCard(state.enemyHand);
-    
-    mvprintw(LINES-1, 2, "Enemy turn ended.");
-    refresh();
-    napms(1000);
-    state.printGameState();
+    showTensorGain(oldGauge);
 }
-
-void Game::playEnemyCard(int cardIndex) {
-    Card& card = state.enemyHand[cardIndex];
-    
-    switch (card.type) {
-        case Card::CHAMPION:
-            if (state.enemyField.size() < MAX_FIELD_SIZE) {
-                // Apply EXEC faction cost reduction if applicable
-                int originalCost = card.cost;
-                if (card.faction == Card::Faction::EXEC) {
-                    int execCount = 0;
-                    for (const auto& fieldCard : state.enemyField) {
-                        if (fieldCard.type == Card::CHAMPION && 
-                            fieldCard.faction == Card::Faction::EXEC) {
-                            execCount++;
-                        }
-                    }
-                    if (execCount >= 2) {
-                        card.cost = std::max(0, card.cost - (execCount - 1));
-                    }
-                }
-
-                state.enemyEnergy -= card.cost;
-                state.enemyField.push_back(card);
-                state.enemyHand.erase(state.enemyHand.begin() + cardIndex);
-                card.turnsInPlay = 0;
-                checkAndApplySynergies(state.enemyField, state.enemyHand);
-                
-                mvprintw(LINES-1, 2, "Enemy plays %s (ATK:%d HP:%d)", 
-                    card.name.c_str(), card.attack, card.health);
-                refresh();
-                napms(1500);
-            }
-            break;
-            
-        case Card::TENSOR:
-            state.enemyEnergy += card.effect;
-            state.enemyHand.erase(state.enemyHand.begin() + cardIndex);
-            increaseTensorGauge(1);  // Tensor shard increases gauge
-            mvprintw(LINES-1, 2, "Enemy uses %s for %d energy", 
-                card.name.c_str(), card.effect);
-            refresh();
-            napms(1500);
-            break;
-    }
-}
\ No newline at end of file
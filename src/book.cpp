@@ -0,0 +1,243 @@
+#include "book.h"
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    struct Fnv {
+        uint64_t hash = 1469598103934665603ull;
+        void add(uint32_t value) {
+            hash ^= value;
+            hash *= 1099511628211ull;
+        }
+    };
+
+    // Everything a hand card is, in one sortable word
+    uint64_t signature(const CardPool& cards, CardHandle card) {
+        uint32_t identity = cards.nameId[card] | uint32_t(uint8_t(cards.cost[card])) << 16 |
+                            uint32_t(uint8_t(cards.effect[card])) << 24;
+        uint32_t stats = uint8_t(cards.attack[card]) | uint32_t(uint8_t(cards.health[card])) << 8 |
+                         uint32_t(cards.type[card]) << 16 | uint32_t(cards.faction[card]) << 20 |
+                         uint32_t(cards.role[card]) << 24;
+        return uint64_t(identity) << 32 | stats;
+    }
+
+    void addField(Fnv& fnv, const CardPool& cards, const Field& field) {
+        fnv.add(field.liveMask());
+        for (unsigned live = field.liveMask(); live; live &= live - 1) {
+            CardHandle card = field[std::countr_zero(live)];
+            uint64_t word = signature(cards, card);
+            fnv.add(static_cast<uint32_t>(word >> 32));
+            fnv.add(static_cast<uint32_t>(word));
+            // Synergy resets restore the originals, so they matter as much as the current stats
+            fnv.add(uint8_t(cards.originalAttack[card]) | uint32_t(uint8_t(cards.originalHealth[card])) << 8 |
+                    uint32_t(uint8_t(cards.turnsInPlay[card])) << 16 | uint32_t(cards.attacked[card]) << 24 |
+                    uint32_t(cards.buffed[card]) << 25);
+        }
+    }
+}
+
+Book::Phase Book::phase(const GameState& state) {
+    if (state.deck.size() >= OPENING_MIN_DECK) return OPENING;
+    if (state.deck.size() <= ENDGAME_MAX_DECK || std::min(state.playerHealth, state.enemyHealth) <= ENDGAME_MAX_HEALTH) {
+        return ENDGAME;
+    }
+    return MIDGAME;
+}
+
+void Book::canonicalHand(const GameState& state, std::vector<int>& order) {
+    const auto& ownHand = Rules::hand(state, Rules::toMove(state));
+    order.resize(ownHand.size());
+    for (size_t i = 0; i < order.size(); i++) order[i] = static_cast<int>(i);
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        return signature(state.cards, ownHand[a]) < signature(state.cards, ownHand[b]);
+    });
+}
+
+uint64_t Book::key(const GameState& state) {
+    Rules::Side side = Rules::toMove(state);
+    Rules::Side opp = Rules::opponent(side);
+    const CardPool& cards = state.cards;
+
+    Fnv fnv;
+    fnv.add(state.isPlayerTurn);
+    fnv.add(state.playerHealth);
+    fnv.add(state.enemyHealth);
+    fnv.add(state.playerEnergy);
+    fnv.add(state.enemyEnergy);
+    fnv.add(state.tensor.current | state.tensor.maximum << 8);
+    fnv.add(static_cast<uint32_t>(state.deck.size()));
+    fnv.add(static_cast<uint32_t>(Rules::hand(state, opp).size()));
+
+    const auto& ownHand = Rules::hand(state, side);
+    std::array<uint64_t, CardPool::CAPACITY> sorted;
+    size_t count = std::min(ownHand.size(), sorted.size());
+    for (size_t i = 0; i < count; i++) sorted[i] = signature(cards, ownHand[i]);
+    std::sort(sorted.begin(), sorted.begin() + count);
+    fnv.add(static_cast<uint32_t>(count));
+    for (size_t i = 0; i < count; i++) {
+        fnv.add(static_cast<uint32_t>(sorted[i] >> 32));
+        fnv.add(static_cast<uint32_t>(sorted[i]));
+    }
+
+    addField(fnv, cards, state.playerField);
+    addField(fnv, cards, state.enemyField);
+    return fnv.hash ? fnv.hash : 1;  // 0 marks an empty slot
+}
+
+Book::Entry Book::makeEntry(const GameState& state, const Rules::Action& action, float value, Phase phase, uint8_t flags) {
+    Entry entry{};
+    entry.key = key(state);
+    entry.value = static_cast<int16_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * 10000));
+    entry.phase = phase;
+    entry.flags = flags;
+    entry.type = action.type;
+    entry.index = action.index;
+    entry.target = action.target;
+    if (action.type == Rules::Action::PLAY_CARD) {
+        std::vector<int> order;
+        canonicalHand(state, order);
+        entry.index = static_cast<int8_t>(std::find(order.begin(), order.end(), action.index) - order.begin());
+    }
+    return entry;
+}
+
+// --- Writer ---
+
+void Book::Writer::add(const Entry& entry) {
+    auto [it, inserted] = entries.emplace(entry.key, entry);
+    if (!inserted && ((entry.flags & FLAG_EXACT) || !(it->second.flags & FLAG_EXACT))) {
+        it->second = entry;
+    }
+}
+
+bool Book::Writer::save(const std::string& path) const {
+    // At most half full, so a miss ends after a couple of probes
+    uint64_t slots = 16;
+    while (slots < 2 * entries.size()) slots *= 2;
+    std::vector<Entry> table(slots, Entry{});
+    for (const auto& [key, entry] : entries) {
+        uint64_t i = key & (slots - 1);
+        while (table[i].key) i = (i + 1) & (slots - 1);
+        table[i] = entry;
+    }
+
+    FILE* file = fopen(path.c_str(), "wb");
+    if (!file) return false;
+    Header header{};
+    header.magic = MAGIC;
+    header.version = VERSION;
+    header.slots = slots;
+    header.entries = entries.size();
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    ok = fwrite(table.data(), sizeof(Entry), table.size(), file) == table.size() && ok;
+    ok = fclose(file) == 0 && ok;
+    return ok;
+}
+
+// --- Table ---
+
+Book::Table::~Table() {
+    close();
+}
+
+bool Book::Table::open(const std::string& path) {
+    close();
+#ifdef _WIN32
+    HANDLE handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER fileSize;
+    GetFileSizeEx(handle, &fileSize);
+    HANDLE mapping = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        CloseHandle(handle);
+        return false;
+    }
+    base = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    fileHandle = handle;
+    mappingHandle = mapping;
+    mappedSize = static_cast<size_t>(fileSize.QuadPart);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        ::close(fd);
+        return false;
+    }
+    void* mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) return false;
+    base = static_cast<const uint8_t*>(mapped);
+    mappedSize = info.st_size;
+#endif
+    if (!base || mappedSize < sizeof(Header)) {
+        close();
+        return false;
+    }
+
+    std::memcpy(&header, base, sizeof(header));
+    bool valid = header.magic == MAGIC && header.version == VERSION &&
+                 header.slots > 0 && std::has_single_bit(header.slots) && header.entries < header.slots &&
+                 sizeof(Header) + header.slots * sizeof(Entry) == mappedSize;
+    if (!valid) {
+        close();
+        return false;
+    }
+    table = reinterpret_cast<const Entry*>(base + sizeof(Header));
+    return true;
+}
+
+void Book::Table::close() {
+#ifdef _WIN32
+    if (base) UnmapViewOfFile(base);
+    if (mappingHandle) CloseHandle(mappingHandle);
+    if (fileHandle) CloseHandle(fileHandle);
+    fileHandle = mappingHandle = nullptr;
+#else
+    if (base) munmap(const_cast<uint8_t*>(base), mappedSize);
+#endif
+    base = nullptr;
+    mappedSize = 0;
+    table = nullptr;
+    header = Header{};
+}
+
+const Book::Entry* Book::Table::find(uint64_t key) const {
+    if (!table) return nullptr;
+    // The writer leaves half the slots empty, but a damaged file may have none: stop after one lap
+    uint64_t mask = header.slots - 1;
+    uint64_t i = key & mask;
+    for (uint64_t probes = 0; probes < header.slots && table[i].key; probes++, i = (i + 1) & mask) {
+        if (table[i].key == key) return &table[i];
+    }
+    return nullptr;
+}
+
+bool Book::Table::probe(const GameState& state, Rules::Action& action, float* value) const {
+    const Entry* entry = find(key(state));
+    if (!entry) return false;
+
+    Rules::Action stored;
+    stored.type = static_cast<Rules::Action::Type>(entry->type);
+    stored.index = entry->index;
+    stored.target = entry->target;
+    if (stored.type == Rules::Action::PLAY_CARD) {
+        std::vector<int> order;
+        canonicalHand(state, order);
+        if (stored.index < 0 || stored.index >= static_cast<int>(order.size())) return false;
+        stored.index = static_cast<int8_t>(order[stored.index]);
+    }
+    // A hash collision or a stale book must never make the AI cheat
+    if (!Rules::isLegal(state, stored)) return false;
+
+    action = stored;
+    if (value) *value = entry->value / 10000.0f;
+    return true;
+}
@@ -0,0 +1,119 @@
+#pragma once
+#include "rules.h"
+
+// Opening book and endgame tablebase for the AI.
+//
+// One open-addressed hash table, memory-mapped read-only, maps a position as
+// the side to move sees it (both fields, own hand, energies, health, gauge,
+// deck and opponent hand sizes) to the best action there and its value. The
+// offline generator (bookgen) fills it for two phases:
+//   OPENING  each side's first turn: candidate turn plans are scored by random
+//            playouts over the opponent's possible hands
+//   ENDGAME  a side at ENDGAME_MAX_HEALTH or less, or at most one card left in
+//            the deck: the next three turns are searched exhaustively, tensor
+//            peaks averaged as chance nodes. A low-health turn is stored only
+//            when it forces a win against every sampled opponent hand; with
+//            the deck nearly empty the game ends inside the search and every
+//            possible opponent hand is tried, so any result is exact.
+// Entries are written for every position along the chosen line, so a probe can
+// follow the book action by action and fall back to search when it leaves it.
+//
+// The mover's hand is keyed in a canonical (sorted) order, so the same cards
+// dealt in another order hit the same entry. Stored hand indices refer to that
+// order and probe() maps them back.
+//
+// File layout (little-endian):
+//   Header     magic, version, slot count, entry count
+//   Entry[n]   n a power of two, key 0 marks an empty slot
+namespace Book {
+    constexpr uint32_t MAGIC = 0x4B424354;  // "TCBK"
+    constexpr uint16_t VERSION = 1;
+
+    constexpr const char* DEFAULT_PATH = "tensor_book.bin";
+
+    // A fresh deck of 50 minus two hands of 5 is 40 at the player's first turn, 39 at the enemy's
+    constexpr size_t OPENING_MIN_DECK = 39;
+    constexpr size_t ENDGAME_MAX_DECK = 1;
+    constexpr int ENDGAME_MAX_HEALTH = 3;
+
+    enum Phase : uint8_t {
+        MIDGAME,
+        OPENING,
+        ENDGAME
+    };
+
+    constexpr uint8_t FLAG_EXACT = 1;  // value proven to the end of the game over every opponent hand
+
+    #pragma pack(push, 1)
+    struct Header {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t reserved;
+        uint64_t slots;
+        uint64_t entries;
+    };
+
+    struct Entry {
+        uint64_t key;
+        int16_t value;    // mover's expected result, -10000 (loss) .. 10000 (win)
+        uint8_t phase;
+        uint8_t flags;
+        uint8_t type;     // Rules::Action::Type
+        int8_t index;     // canonical hand index for PLAY_CARD, field slot for ATTACK
+        int8_t target;
+        uint8_t reserved;
+    };
+    #pragma pack(pop)
+
+    static_assert(sizeof(Entry) == 16, "Entry must stay 16 bytes");
+
+    Phase phase(const GameState& state);
+
+    // Hash of what the side to move can see, with its hand in canonical order
+    uint64_t key(const GameState& state);
+
+    // The mover's hand positions in canonical order: order[i] is the real index of canonical card i
+    void canonicalHand(const GameState& state, std::vector<int>& order);
+
+    // Packs action as taken in state (real hand index) into an entry keyed on state
+    Entry makeEntry(const GameState& state, const Rules::Action& action, float value, Phase phase, uint8_t flags);
+
+    // Collects entries in memory and writes them out as a table
+    class Writer {
+    public:
+        // A later entry replaces an earlier one unless the earlier is exact and the later is not
+        void add(const Entry& entry);
+        size_t size() const { return entries.size(); }
+        bool save(const std::string& path) const;
+
+    private:
+        std::unordered_map<uint64_t, Entry> entries;
+    };
+
+    class Table {
+    public:
+        ~Table();
+        bool open(const std::string& path);
+        void close();
+
+        uint64_t entries() const { return header.entries; }
+        uint64_t slots() const { return header.slots; }
+        const Entry& slot(uint64_t i) const { return table[i]; }
+
+        const Entry* find(uint64_t key) const;
+
+        // Book action for this exact position, with its hand index mapped back to state's order.
+        // False when the position is not in the book or the stored action is not legal here.
+        bool probe(const GameState& state, Rules::Action& action, float* value = nullptr) const;
+
+    private:
+        const uint8_t* base = nullptr;
+        size_t mappedSize = 0;
+        const Entry* table = nullptr;
+        Header header{};
+#ifdef _WIN32
+        void* fileHandle = nullptr;
+        void* mappingHandle = nullptr;
+#endif
+    };
+}
@@ -0,0 +1,458 @@
+// Offline generator for the AI's opening book and endgame tablebase (book.h).
+// Plays solver-vs-solver games and, at every turn that starts in the opening
+// or the endgame, solves that turn far harder than the AI could while a
+// player waits, storing the chosen line in the book.
+//
+//   bookgen generate <games> [book] [seed]    self-play and solve into a book (adds to an existing one)
+//   bookgen info [book]                       summary of a book
+//   bookgen check <games> [book] [seed]       how often the AI hits the book, and what it saves
+
+#include "book.h"
+#include "evaluator.h"
+#include "rollout.h"
+#include "turnflow.h"
+#include "effects.h"
+#include <unordered_set>
+
+namespace {
+    // Opening: the best few plans by the solver's own heuristic are played out this many times each
+    constexpr int OPENING_CANDIDATES = 8;
+    constexpr int OPENING_PLAYOUTS = 2000;
+    constexpr int OPENING_DETERMINIZATIONS = 8;  // guesses at the opponent's hand, playouts split evenly
+
+    // Endgame: the mover's turn, the reply and the mover's next, searched in a few worlds;
+    // a turn whose search grows past ENDGAME_MAX_NODES positions is given up
+    constexpr int ENDGAME_TURNS = 3;
+    constexpr int ENDGAME_WORLDS = 8;
+    constexpr long ENDGAME_MAX_NODES = 2000000;
+    constexpr float CERTAIN = 0.9999f;  // chance nodes sum in float: a proven win may read 0.99999
+
+    constexpr float PEAK_WIN_CHANCE = 0.5f;  // the player's minigame skill is unknown: a coin flip
+
+    double seconds(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    struct Stats {
+        int openings = 0;
+        int endgames = 0;
+        int endgamesUnsolved = 0;  // no forced win, or too big to search
+    };
+
+    // Every distinct position the mover can end its turn in, with the actions leading there
+    struct Candidate {
+        std::vector<Rules::Action> line;
+        GameState end;
+        float heuristic = 0.0f;
+    };
+
+    using KeySet = std::unordered_set<TurnSolver::Key, TurnSolver::KeyHash>;
+
+    void collectPlans(const GameState& state, std::vector<Rules::Action>& line, KeySet& seen,
+                      std::vector<Candidate>& out) {
+        TurnSolver::Key key;
+        TurnSolver::turnKey(state, key);
+        if (!seen.insert(std::move(key)).second ||
+            static_cast<int>(seen.size()) > TurnSolver::DEFAULT_MAX_POSITIONS) {
+            return;
+        }
+        out.push_back({line, state, TurnSolver::heuristic(state, Rules::toMove(state))});
+        if (Rules::result(state) != Rules::ONGOING) return;
+
+        std::vector<Rules::Action> actions;
+        Rules::legalActions(state, actions);
+        actions.pop_back();  // END_TURN is the candidate itself
+        for (const auto& action : actions) {
+            GameState next = state;
+            Rules::apply(next, action);
+            line.push_back(action);
+            collectPlans(next, line, seen, out);
+            line.pop_back();
+        }
+    }
+
+    // Writes an entry for every position along line, all carrying value
+    void storeLine(Book::Writer& writer, GameState state, const std::vector<Rules::Action>& line, float value,
+                   Book::Phase phase, uint8_t flags) {
+        for (const auto& action : line) {
+            writer.add(Book::makeEntry(state, action, value, phase, flags));
+            Rules::apply(state, action);
+        }
+        writer.add(Book::makeEntry(state, Rules::Action::endTurn(), value, phase, flags));
+    }
+
+    void solveOpening(const GameState& root, Book::Writer& writer, uint64_t seed) {
+        Rules::Side mover = Rules::toMove(root);
+        std::vector<Candidate> candidates;
+        std::vector<Rules::Action> line;
+        KeySet seen;
+        collectPlans(root, line, seen, candidates);
+
+        size_t kept = std::min<size_t>(candidates.size(), OPENING_CANDIDATES);
+        std::partial_sort(candidates.begin(), candidates.begin() + kept, candidates.end(),
+                          [](const Candidate& a, const Candidate& b) { return a.heuristic > b.heuristic; });
+
+        std::mt19937 peakRng(static_cast<uint32_t>(seed));
+        float bestValue = -2.0f;
+        size_t best = 0;
+        for (size_t c = 0; c < kept; c++) {
+            Rollout::Tally total;
+            for (int d = 0; d < OPENING_DETERMINIZATIONS; d++) {
+                GameState after = candidates[c].end;
+                Rules::determinize(after, mover, seed + d);
+                if (Rules::result(after) == Rules::ONGOING) {
+                    Rules::step(after, Rules::Action::endTurn(), peakRng);
+                }
+                Rollout::Tally tally = Rollout::run(after, mover, OPENING_PLAYOUTS / OPENING_DETERMINIZATIONS, seed ^ (c << 32 | d));
+                total.wins += tally.wins;
+                total.draws += tally.draws;
+                total.losses += tally.losses;
+            }
+            float value = 2.0f * total.score() - 1.0f;
+            if (value > bestValue) {
+                bestValue = value;
+                best = c;
+            }
+        }
+        storeLine(writer, root, candidates[best].line, bestValue, Book::OPENING, 0);
+    }
+
+    // Expectiminimax over the next ENDGAME_TURNS turns, from the player's point of view in [-1, 1].
+    // A game still going at the horizon counts as 0, so only +1 and -1 are proven results.
+    // It sees every card, so the caller runs it in several worlds: guesses at what the mover can't see.
+    class Endgame {
+    public:
+        bool tooBig() const { return nodes > ENDGAME_MAX_NODES; }
+
+        float value(const GameState& state, int turnsLeft) {
+            switch (Rules::result(state)) {
+                case Rules::PLAYER_WIN: return 1.0f;
+                case Rules::ENEMY_WIN:  return -1.0f;
+                case Rules::DRAW:       return 0.0f;
+                case Rules::ONGOING:    break;
+            }
+            if (turnsLeft == 0) return 0.0f;
+            uint64_t key = fullKey(state, turnsLeft);
+            auto found = memo.find(key);
+            if (found != memo.end()) return found->second;
+            if (++nodes > ENDGAME_MAX_NODES) return 0.0f;
+
+            std::vector<Rules::Action> actions;
+            Rules::legalActions(state, actions);
+            bool maximize = state.isPlayerTurn;
+            float bestValue = maximize ? -2.0f : 2.0f;
+            for (const auto& action : actions) {
+                float v = after(state, action, turnsLeft);
+                bestValue = maximize ? std::max(bestValue, v) : std::min(bestValue, v);
+                // Nothing beats a certain win
+                if ((maximize ? bestValue : -bestValue) >= CERTAIN || tooBig()) break;
+            }
+            memo.emplace(key, bestValue);
+            return bestValue;
+        }
+
+        // Value once action is applied, averaging over the tensor peak it may set off
+        float after(const GameState& state, const Rules::Action& action, int turnsLeft) {
+            GameState next = state;
+            bool peak = Rules::apply(next, action).tensorPeak;
+            turnsLeft -= action.type == Rules::Action::END_TURN;
+            if (!peak) return value(next, turnsLeft);
+
+            float expected = 0.0f;
+            int consequences = next.rules->stakeCount;
+            for (int won = 0; won < 2; won++) {
+                for (int c = 0; c < consequences; c++) {
+                    GameState resolved = next;
+                    Rules::resolveTensorPeak(resolved, won, c);
+                    expected += (won ? PEAK_WIN_CHANCE : 1.0f - PEAK_WIN_CHANCE) / consequences * value(resolved, turnsLeft);
+                }
+            }
+            return expected;
+        }
+
+    private:
+        static uint64_t fullKey(const GameState& state, int turnsLeft) {
+            uint64_t hash = Book::key(state);
+            auto mix = [&](uint32_t value) {
+                hash ^= value;
+                hash *= 1099511628211ull;
+            };
+            mix(turnsLeft);
+            for (CardHandle card : Rules::hand(state, Rules::opponent(Rules::toMove(state)))) {
+                mix(state.cards.nameId[card] | uint32_t(uint8_t(state.cards.attack[card])) << 16 |
+                    uint32_t(uint8_t(state.cards.health[card])) << 24);
+            }
+            // Later draws come from the deck's order, or its lazy draw state
+            mix(~0u);
+            for (CardHandle card : state.deck) mix(state.cards.nameId[card]);
+            mix(static_cast<uint32_t>(state.drawState));
+            mix(static_cast<uint32_t>(state.drawState >> 32));
+            return hash;
+        }
+
+        std::unordered_map<uint64_t, float> memo;
+        long nodes = 0;
+    };
+
+    // Walks the mover's turn along the action best on average over the worlds, into pending.
+    // With onlyWins, an action counts only if it wins in every world, and the walk stops at a
+    // position without one. A tensor peak on the way forks the walk once per minigame outcome.
+    // False if the search grew too big to trust.
+    bool walkEndgame(GameState state, std::vector<GameState> worlds, bool onlyWins, Endgame& search,
+                     std::vector<Book::Entry>& pending) {
+        Rules::Side mover = Rules::toMove(state);
+        float sign = mover == Rules::PLAYER ? 1.0f : -1.0f;
+        std::vector<Rules::Action> actions;
+        while (true) {
+            Rules::legalActions(state, actions);
+            float bestValue = -2.0f;
+            Rules::Action best;
+            for (const auto& action : actions) {
+                float total = 0.0f;
+                bool winsEverywhere = true;
+                for (const GameState& world : worlds) {
+                    float v = sign * search.after(world, action, ENDGAME_TURNS);
+                    total += v;
+                    winsEverywhere = winsEverywhere && v >= CERTAIN;
+                    if (onlyWins && !winsEverywhere) break;
+                }
+                if (search.tooBig()) return false;
+                if (onlyWins && !winsEverywhere) continue;
+                if (total / worlds.size() > bestValue) {
+                    bestValue = total / worlds.size();
+                    best = action;
+                }
+                if (onlyWins) break;
+            }
+            // onlyWins and no action wins everywhere: each world wins its own way (or not at all),
+            // so the book stops here and live search takes over
+            if (bestValue < -1.0f) return true;
+
+            pending.push_back(Book::makeEntry(state, best, bestValue, Book::ENDGAME, onlyWins ? 0 : Book::FLAG_EXACT));
+            if (best.type == Rules::Action::END_TURN) return true;
+
+            bool peak = Rules::apply(state, best).tensorPeak;
+            for (GameState& world : worlds) Rules::apply(world, best);
+            if (!peak) continue;
+
+            int consequences = state.rules->stakeCount;
+            for (int won = 0; won < 2; won++) {
+                for (int c = 0; c < consequences; c++) {
+                    GameState resolved = state;
+                    Rules::resolveTensorPeak(resolved, won, c);
+                    std::vector<GameState> resolvedWorlds = worlds;
+                    for (GameState& world : resolvedWorlds) Rules::resolveTensorPeak(world, won, c);
+                    if (Rules::result(resolved) == Rules::ONGOING &&
+                        !walkEndgame(resolved, resolvedWorlds, onlyWins, search, pending)) {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+    }
+
+    // With at most one card in the deck, all the mover can't see is which unseen card is still
+    // in it (the rest are the opponent's hand), so each choice is one equally likely world and
+    // the search reaches the end of the game. Otherwise the worlds are sampled and only forced
+    // wins are kept.
+    bool solveEndgame(const GameState& root, Book::Writer& writer, uint64_t seed) {
+        Rules::Side mover = Rules::toMove(root);
+        Rules::Side opp = Rules::opponent(mover);
+        std::vector<GameState> worlds;
+        bool exact = root.deck.size() <= Book::ENDGAME_MAX_DECK;
+        if (exact && root.deck.empty()) {
+            worlds.push_back(root);
+        } else if (exact) {
+            std::vector<CardHandle> unseen(Rules::hand(root, opp));
+            unseen.insert(unseen.end(), root.deck.begin(), root.deck.end());
+            for (size_t i = 0; i < unseen.size(); i++) {
+                GameState world = root;
+                world.deck.assign(1, unseen[i]);
+                auto& hidden = Rules::hand(world, opp);
+                hidden.clear();
+                for (size_t j = 0; j < unseen.size(); j++) {
+                    if (j != i) hidden.push_back(unseen[j]);
+                }
+                worlds.push_back(world);
+            }
+        } else {
+            for (int w = 0; w < ENDGAME_WORLDS; w++) {
+                worlds.push_back(root);
+                Rules::determinize(worlds.back(), mover, seed + w);
+            }
+        }
+
+        Endgame search;
+        std::vector<Book::Entry> pending;
+        if (!walkEndgame(root, worlds, !exact, search, pending) || pending.empty()) return false;
+        for (const auto& entry : pending) writer.add(entry);
+        return true;
+    }
+
+    std::unique_ptr<Evaluator> loadNet() {
+        auto net = std::make_unique<Evaluator>();
+        if (!net->load(Evaluator::DEFAULT_WEIGHTS)) net.reset();
+        return net;
+    }
+
+    int generate(int games, const std::string& path, uint32_t seed) {
+        Book::Writer writer;
+        {
+            Book::Table existing;
+            if (existing.open(path)) {
+                for (uint64_t i = 0; i < existing.slots(); i++) {
+                    if (existing.slot(i).key) writer.add(existing.slot(i));
+                }
+                std::cout << "Adding to " << path << " (" << writer.size() << " entries)\n";
+            }
+        }
+
+        std::unique_ptr<Evaluator> net = loadNet();
+        std::mt19937 rng(seed);
+        std::unordered_set<uint64_t> solved;
+        Stats stats;
+        auto start = std::chrono::steady_clock::now();
+        for (int g = 0; g < games; g++) {
+            GameState state;
+            Rules::setupGame(state, rng);
+            TurnFlow::SolverAgent agents[2] = {TurnFlow::SolverAgent(net.get()), TurnFlow::SolverAgent(net.get())};
+            bool turnStart = true;
+            while (Rules::result(state) == Rules::ONGOING) {
+                Book::Phase phase = Book::phase(state);
+                if (turnStart && phase != Book::MIDGAME && solved.insert(Book::key(state)).second) {
+                    if (phase == Book::OPENING) {
+                        solveOpening(state, writer, rng());
+                        stats.openings++;
+                    } else if (solveEndgame(state, writer, rng())) {
+                        stats.endgames++;
+                    } else {
+                        stats.endgamesUnsolved++;
+                    }
+                }
+                Rules::Action action = agents[Rules::toMove(state)].choose(state);
+                Rules::step(state, action, rng);
+                turnStart = action.type == Rules::Action::END_TURN;
+            }
+            if ((g + 1) % 10 == 0) {
+                std::cout << "game " << g + 1 << ": " << writer.size() << " entries\n";
+            }
+        }
+
+        if (!writer.save(path)) {
+            std::cerr << "Failed writing " << path << "\n";
+            return 1;
+        }
+        std::cout << games << " games in " << std::fixed << std::setprecision(1) << seconds(start) << "s: "
+                  << stats.openings << " opening turns, " << stats.endgames << " endgame turns solved ("
+                  << stats.endgamesUnsolved << " not), " << writer.size() << " entries -> " << path
+                  << (net ? " (guided by " + std::string(Evaluator::DEFAULT_WEIGHTS) + ")" : "") << "\n";
+        return 0;
+    }
+
+    int info(const std::string& path) {
+        Book::Table book;
+        if (!book.open(path)) {
+            std::cerr << "Cannot read book " << path << "\n";
+            return 1;
+        }
+
+        std::array<uint64_t, 3> perPhase{};
+        uint64_t exact = 0, endTurns = 0;
+        for (uint64_t i = 0; i < book.slots(); i++) {
+            const Book::Entry& entry = book.slot(i);
+            if (!entry.key) continue;
+            perPhase[std::min<int>(entry.phase, 2)]++;
+            exact += entry.flags & Book::FLAG_EXACT;
+            endTurns += entry.type == Rules::Action::END_TURN;
+        }
+        std::cout << path << ": " << book.entries() << " positions in " << book.slots() << " slots ("
+                  << book.slots() * sizeof(Book::Entry) / 1024 << " KiB)\n"
+                  << "  opening: " << perPhase[Book::OPENING] << ", endgame: " << perPhase[Book::ENDGAME]
+                  << " (" << exact << " exact)\n"
+                  << "  end-turn actions: " << endTurns << "\n";
+        return 0;
+    }
+
+    // Solver-vs-solver games, both sides using the book: how many decisions it answers per
+    // phase, and what a probe costs next to the search it replaces
+    int check(int games, const std::string& path, uint32_t seed) {
+        Book::Table book;
+        if (!book.open(path)) {
+            std::cerr << "Cannot read book " << path << "\n";
+            return 1;
+        }
+
+        std::unique_ptr<Evaluator> net = loadNet();
+        std::mt19937 rng(seed);
+        std::array<int, 3> decisions{}, hits{};
+        double probeSeconds = 0, searchSeconds = 0;
+        int probes = 0, searches = 0;
+        for (int g = 0; g < games; g++) {
+            GameState state;
+            Rules::setupGame(state, rng);
+            TurnFlow::SolverAgent agents[2] = {TurnFlow::SolverAgent(net.get()), TurnFlow::SolverAgent(net.get())};
+            while (Rules::result(state) == Rules::ONGOING) {
+                TurnFlow::SolverAgent& agent = agents[Rules::toMove(state)];
+                Book::Phase phase = Book::phase(state);
+                decisions[phase]++;
+
+                Rules::Action action;
+                auto start = std::chrono::steady_clock::now();
+                bool hit = book.probe(state, action);
+                probeSeconds += seconds(start);
+                probes++;
+                if (hit) {
+                    hits[phase]++;
+                    agent.dropPlan();
+                } else {
+                    bool searching = agent.startingTurn();
+                    start = std::chrono::steady_clock::now();
+                    action = agent.choose(state);
+                    if (searching) {
+                        searchSeconds += seconds(start);
+                        searches++;
+                    }
+                }
+                Rules::step(state, action, rng);
+            }
+        }
+
+        const char* names[] = {"midgame", "opening", "endgame"};
+        std::cout << games << " games against " << path << "\n" << std::fixed << std::setprecision(1);
+        for (int p : {Book::OPENING, Book::MIDGAME, Book::ENDGAME}) {
+            std::cout << "  " << std::left << std::setw(8) << names[p] << std::right << std::setw(8) << decisions[p]
+                      << " decisions, " << std::setw(7) << hits[p] << " from the book ("
+                      << (decisions[p] ? 100.0 * hits[p] / decisions[p] : 0.0) << "%)\n";
+        }
+        std::cout << std::setprecision(2) << "  probe " << (probes ? probeSeconds / probes * 1e6 : 0.0)
+                  << " us, turn search " << (searches ? searchSeconds / searches * 1e3 : 0.0) << " ms\n";
+        return 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::string command = argc > 1 ? argv[1] : "";
+    auto seedArg = [&](int i) { return argc > i ? static_cast<uint32_t>(std::strtoul(argv[i], nullptr, 10)) : 1u; };
+
+    // The book is only right for the rules the game plays, tensor_effects.txt included
+    std::string effectsError;
+    if (!Effects::loadDefaultFile(effectsError)) {
+        std::cerr << effectsError << "\n";
+        return 1;
+    }
+
+    if (command == "generate") {
+        int games = argc > 2 ? std::atoi(argv[2]) : 200;
+        return generate(games, argc > 3 ? argv[3] : Book::DEFAULT_PATH, seedArg(4));
+    }
+    if (command == "info") {
+        return info(argc > 2 ? argv[2] : Book::DEFAULT_PATH);
+    }
+    if (command == "check") {
+        int games = argc > 2 ? std::atoi(argv[2]) : 100;
+        return check(games, argc > 3 ? argv[3] : Book::DEFAULT_PATH, seedArg(4));
+    }
+    std::cerr << "usage: bookgen generate <games> [book] [seed] | info [book] | check <games> [book] [seed]\n";
+    return 1;
+}
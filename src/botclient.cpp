@@ -0,0 +1,277 @@
+// Scripted bot clients for load-testing the match server over TCP.
+//
+//   botclient [clients] [matches] [host|local] [port] [threads]
+//
+// Every bot keeps one connection open and queues for game after game until the
+// pool has played clients * matches / 2 games, playing random legal moves worked
+// out from the view the server sends it.
+// With host "local" (the default) an in-process server is started on an
+// ephemeral loopback port, so the whole stack is exercised without setup.
+// Exits non-zero if any game did not finish cleanly or any move was rejected.
+
+#include "server.h"
+#include <cerrno>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+    struct Bot {
+        int fd = -1;
+        bool inMatch = false;
+        std::vector<uint8_t> input;
+        GameState view;
+        std::mt19937 rng;
+        std::chrono::steady_clock::time_point sentAt;
+        bool awaitingReply = false;
+    };
+
+    struct Totals {
+        uint64_t target = 0;                // GAME_OVER reports wanted (two per game)
+        std::atomic<uint64_t> matches{0};
+        std::atomic<uint64_t> wins{0};
+        std::atomic<uint64_t> draws{0};
+        std::atomic<uint64_t> abandoned{0};
+        std::atomic<uint64_t> actions{0};
+        std::atomic<uint64_t> rejected{0};
+        std::atomic<uint64_t> failures{0};
+        std::atomic<uint64_t> latencyMicros{0};
+    };
+
+    int connectTo(const std::string& host, uint16_t port) {
+        addrinfo hints{};
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo* found = nullptr;
+        if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &found) != 0) return -1;
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd >= 0 && connect(fd, found->ai_addr, found->ai_addrlen) != 0) {
+            close(fd);
+            fd = -1;
+        }
+        freeaddrinfo(found);
+        if (fd >= 0) {
+            int on = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+        }
+        return fd;
+    }
+
+    // Frames are tiny, so a blocking send never waits long on loopback
+    bool sendFrame(Bot& bot, Protocol::MessageType type, const void* payload = nullptr, size_t size = 0) {
+        thread_local std::vector<uint8_t> frame;
+        frame.clear();
+        Protocol::appendFrame(frame, type, payload, size);
+        return send(bot.fd, frame.data(), frame.size(), MSG_NOSIGNAL) == static_cast<ssize_t>(frame.size());
+    }
+
+    bool hello(Bot& bot) {
+        Protocol::Hello message{Protocol::MAGIC, Protocol::VERSION};
+        return sendFrame(bot, Protocol::HELLO, &message, sizeof(message));
+    }
+
+    bool act(Bot& bot, const Rules::Action& action) {
+        Protocol::ActionMessage message = Protocol::packAction(action);
+        bot.sentAt = std::chrono::steady_clock::now();
+        bot.awaitingReply = true;
+        return sendFrame(bot, Protocol::ACTION, &message, sizeof(message));
+    }
+
+    // Same behaviour policy as the trainer's random games
+    Rules::Action chooseAction(Bot& bot) {
+        thread_local std::vector<Rules::Action> actions;
+        Rules::legalActions(bot.view, actions);
+        if (actions.size() == 1 || bot.rng() % 100 < 15) {
+            return actions.back();
+        }
+        return actions[bot.rng() % (actions.size() - 1)];
+    }
+
+    // Returns false when the bot is finished (or broken) and should be closed
+    bool handle(Bot& bot, const Protocol::Frame& frame, Totals& totals) {
+        switch (frame.type) {
+            case Protocol::WAITING:
+                return true;
+            case Protocol::MATCH_START:
+                bot.inMatch = true;
+                return true;
+            case Protocol::STATE: {
+                if (!Protocol::readState(frame, bot.view)) {
+                    totals.failures++;
+                    return false;
+                }
+                if (bot.awaitingReply) {
+                    auto waited = std::chrono::steady_clock::now() - bot.sentAt;
+                    totals.latencyMicros += std::chrono::duration_cast<std::chrono::microseconds>(waited).count();
+                    bot.awaitingReply = false;
+                }
+                if (bot.inMatch && bot.view.isPlayerTurn && Rules::result(bot.view) == Rules::ONGOING) {
+                    totals.actions++;
+                    return act(bot, chooseAction(bot));
+                }
+                return true;
+            }
+            case Protocol::REJECTED:
+                totals.rejected++;
+                bot.awaitingReply = false;
+                return bot.inMatch ? act(bot, Rules::Action::endTurn()) : true;
+            case Protocol::GAME_OVER: {
+                Protocol::GameOver over;
+                if (!Protocol::payloadAs(frame, over)) {
+                    totals.failures++;
+                    return false;
+                }
+                bot.inMatch = false;
+                bot.awaitingReply = false;
+                uint64_t reported = ++totals.matches;
+                totals.wins += over.outcome == Protocol::WIN;
+                totals.draws += over.outcome == Protocol::DRAW;
+                if (over.outcome == Protocol::OPPONENT_LEFT) {
+                    // Only expected once the pool is winding down and idle bots hang up
+                    totals.abandoned++;
+                    if (reported <= totals.target) totals.failures++;
+                }
+                return reported < totals.target && hello(bot);
+            }
+            default:
+                totals.failures++;
+                return false;
+        }
+    }
+
+    void runBots(int clients, const std::string& host, uint16_t port, uint32_t seed, Totals& totals) {
+        int epollFd = epoll_create1(0);
+        std::vector<Bot> bots(clients);
+        int live = 0;
+        for (int i = 0; i < clients; i++) {
+            Bot& bot = bots[i];
+            bot.rng.seed(seed + i);
+            bot.fd = connectTo(host, port);
+            epoll_event ev{};
+            ev.events = EPOLLIN;
+            ev.data.u32 = i;
+            if (bot.fd < 0 || epoll_ctl(epollFd, EPOLL_CTL_ADD, bot.fd, &ev) != 0 || !hello(bot)) {
+                totals.failures++;
+                continue;
+            }
+            live++;
+        }
+
+        epoll_event events[256];
+        uint8_t chunk[16384];
+        auto lastProgress = std::chrono::steady_clock::now();
+        while (live > 0) {
+            int count = epoll_wait(epollFd, events, 256, 100);
+            if (count == 0) {
+                // Target reached: bots still queued will never be paired
+                if (totals.matches >= totals.target) {
+                    for (auto& bot : bots) {
+                        if (bot.fd >= 0 && !bot.inMatch) {
+                            close(bot.fd);
+                            bot.fd = -1;
+                            live--;
+                        }
+                    }
+                } else if (std::chrono::steady_clock::now() - lastProgress > std::chrono::seconds(10)) {
+                    totals.failures += live;  // the server lost track of someone
+                    break;
+                }
+                continue;
+            }
+            lastProgress = std::chrono::steady_clock::now();
+            for (int e = 0; e < count; e++) {
+                Bot& bot = bots[events[e].data.u32];
+                if (bot.fd < 0) continue;
+
+                bool keep = true;
+                ssize_t got = recv(bot.fd, chunk, sizeof(chunk), 0);
+                if (got <= 0) {
+                    if (got < 0 && errno == EINTR) continue;
+                    totals.failures++;
+                    keep = false;
+                } else {
+                    bot.input.insert(bot.input.end(), chunk, chunk + got);
+                }
+
+                size_t offset = 0;
+                while (keep) {
+                    Protocol::Frame frame;
+                    bool malformed;
+                    size_t used = Protocol::parseFrame(bot.input.data() + offset, bot.input.size() - offset, frame, malformed);
+                    if (malformed) {
+                        totals.failures++;
+                        keep = false;
+                    }
+                    if (!used) break;
+                    offset += used;
+                    keep = handle(bot, frame, totals);
+                }
+                bot.input.erase(bot.input.begin(), bot.input.begin() + std::min(offset, bot.input.size()));
+
+                if (!keep) {
+                    close(bot.fd);
+                    bot.fd = -1;
+                    live--;
+                }
+            }
+        }
+        for (auto& bot : bots) {
+            if (bot.fd >= 0) close(bot.fd);
+        }
+        close(epollFd);
+    }
+}
+
+int main(int argc, char** argv) {
+    int clients = argc > 1 ? std::atoi(argv[1]) : 200;
+    int matches = argc > 2 ? std::atoi(argv[2]) : 5;
+    std::string host = argc > 3 ? argv[3] : "local";
+    uint16_t port = argc > 4 ? static_cast<uint16_t>(std::atoi(argv[4])) : Protocol::DEFAULT_PORT;
+    int threads = argc > 5 ? std::atoi(argv[5]) : std::max(1u, std::thread::hardware_concurrency());
+    clients += clients % 2;  // everyone needs an opponent
+
+    std::unique_ptr<MatchServer> server;
+    if (host == "local") {
+        server = std::make_unique<MatchServer>(0, threads, 12345);
+        if (!server->start()) {
+            std::cerr << "Cannot start loopback server\n";
+            return 1;
+        }
+        host = "127.0.0.1";
+        port = server->port();
+        std::cout << "Loopback server on port " << port << " with " << server->threads() << " workers\n";
+    }
+    Protocol::seedCardNames();
+
+    Totals totals;
+    totals.target = static_cast<uint64_t>(clients) * matches;
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; t++) {
+        int share = clients / threads + (t < clients % threads ? 1 : 0);
+        pool.emplace_back(runBots, share, host, port, 1000u * t, std::ref(totals));
+    }
+    for (auto& thread : pool) {
+        thread.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Each finished game is reported to both bots
+    uint64_t games = totals.matches / 2;
+    uint64_t expected = static_cast<uint64_t>(clients) * matches / 2;
+    std::cout << clients << " bots, " << games << " games (target " << expected << "), "
+              << totals.actions << " actions in " << std::fixed << std::setprecision(2) << seconds << "s ("
+              << std::setprecision(0) << totals.actions / seconds << " actions/s)\n"
+              << "  mean round trip: " << std::setprecision(1)
+              << (totals.actions ? double(totals.latencyMicros) / totals.actions : 0.0) << " us\n"
+              << "  draws: " << totals.draws / 2 << ", abandoned: " << totals.abandoned
+              << ", rejected: " << totals.rejected << ", failures: " << totals.failures << "\n";
+
+    if (server) server->stop();
+    bool clean = games >= expected && totals.rejected == 0 && totals.failures == 0;
+    std::cout << (clean ? "PASS" : "FAIL") << "\n";
+    return clean ? 0 : 1;
+}
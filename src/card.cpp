@@ -1,55 +1,28 @@
 #include "game.h"
+#include "turnflow.h"
 
-void Game::drawCard(std::vector<Card>& hand) {
-    if (state.deck.empty()) {
-        clear();
-        mvprintw(LINES/2, (COLS-30)/2, "Deck is empty!");
-        if (state.playerHealth > state.enemyHealth) {
-            mvprintw(LINES/2+1, (COLS-30)/2, "You have more HP - You win!");
-            state.enemyHealth = 0;
-        } else if (state.enemyHealth > state.playerHealth) {
-            mvprintw(LINES/2+1, (COLS-30)/2, "Enemy has more HP - You lose!");
-            state.playerHealth = 0;
-        } else {
-            mvprintw(LINES/2+1, (COLS-30)/2, "It's a tie!");
-            state.playerHealth = state.enemyHealth = 0;
-        }
-        refresh();
-        napms(2000);
-        return;
-    }
-    if (!state.deck.empty()) {
-        hand.push_back(state.deck.back());
-        state.deck.pop_back();
-    }
-}
-
-void Game::playCardFromHand(int cardIndex) {
+// Card and target selection only: the match applies the action once it is returned
+std::optional<Rules::Action> Game::playCardFromHand(int cardIndex) {
     if (cardIndex < 0 || cardIndex >= static_cast<int>(state.playerHand.size())) {
         std::cout << "Invalid card index\n";
-        return;
+        return std::nullopt;
     }
 
-    Card& card = state.playerHand[cardIndex];
+    const Card card = state.cards.get(state.playerHand[cardIndex]);
     if (card.cost > state.playerEnergy) {
         mvprintw(LINES-1, 2, "Not enough energy! Card costs %d, you have %d", 
             card.cost, state.playerEnergy);
         refresh();
         napms(1500);
-        return;
+        return std::nullopt;
     }
 
     switch (card.type) {
         case Card::CHAMPION:
-            if (state.playerField.size() < MAX_FIELD_SIZE) {
-                state.playerEnergy -= card.cost;
-                state.playerField.push_back(card);
-                state.playerHand.erase(state.playerHand.begin() + cardIndex);
-                card.turnsInPlay = 0;  // newly placed champion
-                mvprintw(LINES-1, 2, "Played %s to field", card.name.c_str());
-            } else {
-                mvprintw(LINES-1, 2, "Field is full!");
+            if (!state.playerField.full()) {
+                return Rules::Action::play(cardIndex);
             }
+            mvprintw(LINES-1, 2, "Field is full!");
             break;
 
         case Card::ARTIFACT: {
@@ -57,24 +30,31 @@ void Game::playCardFromHand(int cardIndex) {
                 mvprintw(LINES-1, 2, "No champions on field to buff!");
                 refresh();
                 napms(1500);
-                return;
+                return std::nullopt;
             }
 
-            int selected = 0;
+            // Field slots keep their place, so the selection skips the empty ones
+            const int slots = static_cast<int>(MAX_FIELD_SIZE);
+            int selected = std::countr_zero(state.playerField.liveMask());
             while(true) {
                 state.printGameState();
                 
                 // Show current stats and potential buff
-                for(size_t i = 0; i < state.playerField.size(); i++) {
-                    const auto& target = state.playerField[i];
+                for(int i = 0; i < slots; i++) {
+                    if (!state.playerField.occupied(i)) continue;
+                    const Card target = state.cards.get(state.playerField[i]);
                     GameUI::drawCard(stdscr, LINES/2+2, 2 + (i * 10), target, i == selected);
                     if (i == selected) {
-                        if (card.effect % 2 == 1) {
+                        // Play it on a copy, so the preview follows whatever the artifact's effect script does
+                        GameState preview = state;
+                        Rules::apply(preview, Rules::Action::play(cardIndex, i));
+                        const Card buffed = preview.cards.get(preview.playerField[i]);
+                        if (buffed.attack != target.attack) {
                             mvprintw(LINES-3, 2, "Will buff ATK from %d to %d", 
-                                    target.attack, target.attack + card.effect);
+                                    target.attack, buffed.attack);
                         } else {
                             mvprintw(LINES-3, 2, "Will buff HP from %d to %d", 
-                                    target.health, target.health + card.effect);
+                                    target.health, buffed.health);
                         }
                     }
                 }
@@ -85,69 +65,59 @@ void Game::playCardFromHand(int cardIndex) {
                 int ch = getch();
                 switch(ch) {
                     case KEY_LEFT:
-                        selected = (selected > 0) ? selected - 1 : state.playerField.size() - 1;
+                        do {
+                            selected = (selected > 0) ? selected - 1 : slots - 1;
+                        } while(!state.playerField.occupied(selected));
                         break;
                     case KEY_RIGHT:
-                        selected = (selected < state.playerField.size() - 1) ? selected + 1 : 0;
+                        do {
+                            selected = (selected < slots - 1) ? selected + 1 : 0;
+                        } while(!state.playerField.occupied(selected));
                         break;
-                    case '\n': {
-                        state.playerEnergy -= card.cost;
-                        if (card.effect % 2 == 1) {
-                            state.playerField[selected].attack += card.effect;
-                        } else {
-                            state.playerField[selected].health += card.effect;
-                        }
-                        state.playerHand.erase(state.playerHand.begin() + cardIndex);
-                        mvprintw(LINES-1, 2, "Buffed %s", state.playerField[selected].name.c_str());
-                        refresh();
-                        napms(1000);
-                        return;
-                    }
+                    case '\n':
+                        return Rules::Action::play(cardIndex, selected);
                     case 27:
-                        return;
+                        return std::nullopt;
                 }
             }
             break;
         }
 
         case Card::TENSOR:
-            int oldEnergy = state.playerEnergy;
-            state.playerEnergy += card.effect;
-            increaseTensorGauge(1);  // Add this line to properly increase tensor
-            state.playerHand.erase(state.playerHand.begin() + cardIndex);
-            mvprintw(LINES-1, 2, "Used Tensor Shard: Energy %d → %d", 
-                    oldEnergy, state.playerEnergy);
-            break;
+            return Rules::Action::play(cardIndex);
     }
     refresh();
     napms(1000);
-    state.printGameState();
+    return std::nullopt;
 }
 
-void Game::attackWithCard(int cardIndex) {
-    if (cardIndex < 0 || cardIndex >= static_cast<int>(state.playerField.size())) {
+std::optional<Rules::Action> Game::attackWithCard(int cardIndex) {
+    if (!state.playerField.occupied(cardIndex)) {
         std::cout << "Invalid card index\n";
-        return;
+        return std::nullopt;
     }
 
-    Card& attacker = state.playerField[cardIndex];
-    if(attacker.hasAttackedThisTurn) {
+    if(state.cards.attacked[state.playerField[cardIndex]]) {
         mvprintw(LINES-1, 2, "This champion has already attacked this turn!");
         refresh();
         napms(1500);
-        return;
+        return std::nullopt;
     }
 
+    // 0 is the direct attack, slot + 1 an enemy champion; empty slots are skipped
+    const int choices = static_cast<int>(MAX_FIELD_SIZE) + 1;
+    auto available = [&](int choice) { return choice == 0 || state.enemyField.occupied(choice - 1); };
     int selected = 0;
     while(true) {
         state.printGameState();
 
         // Show attacker info in a better format
         attron(A_BOLD);
-        mvprintw(LINES-4, 2, "Attacking with: %s", state.playerField[cardIndex].name.c_str());
+        const Card attacker = state.cards.get(state.playerField[cardIndex]);
+        mvprintw(LINES-4, 2, "Attacking with: %s", attacker.name());
         attroff(A_BOLD);
-        mvprintw(LINES-4, 2 + 14 + state.playerField[cardIndex].name.length(), 
-                " (ATK: %d)", state.playerField[cardIndex].attack);
+        mvprintw(LINES-4, 2 + 14 + strlen(attacker.name()), 
+                " (ATK: %d)", attacker.attack);
 
         // Show targets in a cleaner horizontal layout
         mvprintw(LINES-3, 2, "Select target:");
@@ -158,13 +128,14 @@ void Game::attackWithCard(int cardIndex) {
         mvprintw(LINES-2, xPos, "[ Direct Attack ]");
         if(selected == 0) attroff(A_REVERSE);
 
-        for(size_t i = 0; i < state.enemyField.size(); i++) {
-            const auto& target = state.enemyField[i];
+        for(int i = 0; i < static_cast<int>(MAX_FIELD_SIZE); i++) {
+            if (!state.enemyField.occupied(i)) continue;
+            const Card target = state.cards.get(state.enemyField[i]);
             xPos = 2 + ((i + 1) * 25);
             
             if(selected == i + 1) attron(A_REVERSE);
             mvprintw(LINES-2, xPos, "[ %s HP:%d ]", 
-                    target.name.c_str(), target.health);
+                    target.name(), target.health);
             if(selected == i + 1) attroff(A_REVERSE);
         }
 
@@ -172,48 +143,80 @@ void Game::attackWithCard(int cardIndex) {
         int ch = getch();
         switch(ch) {
             case KEY_LEFT:
-                selected = (selected > 0) ? selected - 1 : state.enemyField.size();
+                do {
+                    selected = (selected > 0) ? selected - 1 : choices - 1;
+                } while(!available(selected));
                 break;
             case KEY_RIGHT:
-                selected = (selected < state.enemyField.size()) ? selected + 1 : 0;
+                do {
+                    selected = (selected < choices - 1) ? selected + 1 : 0;
+                } while(!available(selected));
                 break;
             case '\n':
-                if(state.playerField[cardIndex].turnsInPlay == 0) {
+                if(state.cards.turnsInPlay[state.playerField[cardIndex]] == 0) {
                     mvprintw(LINES-1, 2, "Champion can't attack on the turn it was played!");
                     refresh();
                     napms(1500);
-                    return;
+                    return std::nullopt;
                 }
-                
-                if (selected == 0) {
-                    state.enemyHealth -= state.playerField[cardIndex].attack;
-                    mvprintw(LINES-1, 2, "%s attacks enemy directly for %d damage!", 
-                            attacker.name.c_str(), 
-                            attacker.attack);
-                } else {
-                    int enemyIndex = selected - 1;
-                    Card& defender = state.enemyField[enemyIndex];
-                    defender.health -= attacker.attack;
-                    
-                    // Use consistent name formatting like in GameUI::drawCard
-                    mvprintw(LINES-1, 2, "%s attacks %s for %d damage!", 
-                            attacker.name.c_str(),
-                            defender.name.c_str(),
-                            attacker.attack);
-                    
-                    if(defender.health <= 0) {
-                        napms(1000);
-                        mvprintw(LINES-1, 2, "%s was destroyed!", defender.name.c_str());
-                        state.enemyField.erase(state.enemyField.begin() + enemyIndex);
-                    }
-                }
-                state.playerField[cardIndex].hasAttackedThisTurn = true;  // Modified this line
-                refresh();
-                napms(1500);
-                return;
+                return Rules::Action::attack(cardIndex, selected - 1);  // 0 is the direct attack
             case 27:
-                return;
+                return std::nullopt;
+        }
+    }
+}
+
+void Game::executePlayerAction(TurnFlow::Match& match, const Rules::Action& action) {
+    // Copy what we narrate before the match moves or destroys it
+    int oldEnergy = state.playerEnergy;
+    int oldGauge = state.tensor.current;
+
+    if (action.type == Rules::Action::END_TURN) {
+        match.decide(action);
+        mvprintw(LINES-1, 2, "Ending your turn...");
+        refresh();
+        napms(1500);
+    } else if (action.type == Rules::Action::PLAY_CARD) {
+        Card card = state.cards.get(state.playerHand[action.index]);
+        match.decide(action);
+        state.printGameState();
+
+        switch (card.type) {
+            case Card::CHAMPION:
+                mvprintw(LINES-1, 2, "Played %s to field", card.name());
+                break;
+            case Card::ARTIFACT:
+                mvprintw(LINES-1, 2, "Buffed %s", state.cards.name(state.playerField[action.target]));
+                break;
+            case Card::TENSOR:
+                mvprintw(LINES-1, 2, "Used Tensor Shard: Energy %d → %d", oldEnergy, state.playerEnergy);
+                break;
         }
+        refresh();
+        napms(1000);
+    } else {
+        Card attacker = state.cards.get(state.playerField[action.index]);
+        if (action.target < 0) {
+            match.decide(action);
+            mvprintw(LINES-1, 2, "%s attacks enemy directly for %d damage!",
+                    attacker.name(), attacker.attack);
+        } else {
+            Card defender = state.cards.get(state.enemyField[action.target]);
+            match.decide(action);
+            mvprintw(LINES-1, 2, "%s attacks %s for %d damage!",
+                    attacker.name(), defender.name(), attacker.attack);
+            if (match.lastStep().outcome.destroyed) {
+                refresh();
+                napms(1000);
+                mvprintw(LINES-1, 2, "%s was destroyed!", defender.name());
+            }
+        }
+        refresh();
+        napms(1500);
+    }
+
+    if (match.lastStep().outcome.concordia) {
+        announceTensorConcordia();
     }
-    state.printGameState();
-}
\ No newline at end of file
+    showTensorGain(oldGauge);
+}
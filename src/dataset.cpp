@@ -0,0 +1,323 @@
+#include "dataset.h"
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    constexpr size_t COLUMN_ALIGN = 64;
+
+    Dataset::RowCard packCard(const CardPool& cards, CardHandle card) {
+        Dataset::RowCard out;
+        out.nameId = cards.nameId[card];
+        out.typeFaction = static_cast<uint8_t>(cards.type[card] << 4 | cards.faction[card]);
+        out.roleFlags = static_cast<uint8_t>(cards.role[card] << 4 | (cards.turnsInPlay[card] > 0) << 2 |
+                                             cards.buffed[card] << 1 | cards.attacked[card]);
+        out.cost = cards.cost[card];
+        out.attack = cards.attack[card];
+        out.health = cards.health[card];
+        out.effect = cards.effect[card];
+        return out;
+    }
+
+    bool validCard(const Dataset::RowCard& in) {
+        return (in.typeFaction >> 4) <= Card::TENSOR && (in.typeFaction & 0xF) <= Card::VIRTU_MACHINA &&
+               (in.roleFlags >> 4) <= Card::MAGE;
+    }
+
+    Card unpackCard(const Dataset::RowCard& in) {
+        Card card(static_cast<Card::Type>(in.typeFaction >> 4), in.nameId, in.cost, in.attack, in.health, in.effect);
+        card.faction = static_cast<Card::Faction>(in.typeFaction & 0xF);
+        card.role = static_cast<Card::Role>(in.roleFlags >> 4);
+        card.turnsInPlay = (in.roleFlags >> 2) & 1;
+        card.hasSynergyBuff = (in.roleFlags >> 1) & 1;
+        card.hasAttackedThisTurn = in.roleFlags & 1;
+        return card;
+    }
+
+    bool writeAligned(FILE* file, const void* data, size_t bytes, uint64_t& offset) {
+        static const uint8_t zeros[COLUMN_ALIGN] = {};
+        size_t pad = (COLUMN_ALIGN - offset % COLUMN_ALIGN) % COLUMN_ALIGN;
+        if (pad && fwrite(zeros, 1, pad, file) != pad) return false;
+        offset += pad;
+        if (bytes && fwrite(data, 1, bytes, file) != bytes) return false;
+        offset += bytes;
+        return true;
+    }
+}
+
+void Dataset::encode(const GameState& state, PositionRow& row) {
+    std::memset(&row, 0, sizeof(row));
+    row.playerHealth = state.playerHealth;
+    row.enemyHealth = state.enemyHealth;
+    row.playerEnergy = std::min(state.playerEnergy, 127);
+    row.enemyEnergy = std::min(state.enemyEnergy, 127);
+    row.tensorCurrent = state.tensor.current;
+    row.tensorMaximum = state.tensor.maximum;
+    row.isPlayerTurn = state.isPlayerTurn;
+    row.deckSize = state.deck.size();
+
+    for (int side = 0; side < 2; side++) {
+        const auto& field = Rules::field(state, static_cast<Rules::Side>(side));
+        const auto& hand = Rules::hand(state, static_cast<Rules::Side>(side));
+        row.fieldCount[side] = field.count();
+        row.fieldSlots[side] = field.liveMask();
+        row.handCount[side] = std::min<size_t>(hand.size(), HAND_SLOTS);
+        for (unsigned live = field.liveMask(); live; live &= live - 1) {
+            int slot = std::countr_zero(live);
+            row.field[side][slot] = packCard(state.cards, field[slot]);
+        }
+        for (int i = 0; i < row.handCount[side]; i++) {
+            row.hand[side][i] = packCard(state.cards, hand[i]);
+        }
+    }
+}
+
+bool Dataset::decode(const PositionRow& row, GameState& state) {
+    state.playerHealth = row.playerHealth;
+    state.enemyHealth = row.enemyHealth;
+    state.playerEnergy = row.playerEnergy;
+    state.enemyEnergy = row.enemyEnergy;
+    state.tensor.current = row.tensorCurrent;
+    state.tensor.maximum = row.tensorMaximum;
+    state.isPlayerTurn = row.isPlayerTurn != 0;
+
+    // Only the deck size is recorded; every deck entry is the same placeholder card
+    state.cards.clear();
+    state.deck.assign(row.deckSize, state.cards.add(Card(Card::TENSOR, uint16_t(0), 0, 0, 0, 0)));
+
+    for (int side = 0; side < 2; side++) {
+        auto& field = Rules::field(state, static_cast<Rules::Side>(side));
+        auto& hand = Rules::hand(state, static_cast<Rules::Side>(side));
+        field.clear();
+        hand.clear();
+        for (unsigned live = row.fieldSlots[side] & ((1u << MAX_FIELD_SIZE) - 1); live; live &= live - 1) {
+            int slot = std::countr_zero(live);
+            if (!validCard(row.field[side][slot])) return false;
+            field.place(slot, state.cards.add(unpackCard(row.field[side][slot])));
+        }
+        // The row comes straight from the file: a count past the array would overrun it and the pool
+        int handCount = std::min<int>(row.handCount[side], HAND_SLOTS);
+        for (int i = 0; i < handCount; i++) {
+            if (!validCard(row.hand[side][i])) return false;
+            hand.push_back(state.cards.add(unpackCard(row.hand[side][i])));
+        }
+    }
+    return true;
+}
+
+Dataset::PackedAction Dataset::packAction(const Rules::Action& action) {
+    return {action.type, action.index, action.target, static_cast<int8_t>(Rules::actionSlot(action))};
+}
+
+Rules::Action Dataset::unpackAction(const PackedAction& packed) {
+    Rules::Action action;
+    action.type = static_cast<Rules::Action::Type>(packed.type);
+    action.index = packed.index;
+    action.target = packed.target;
+    return action;
+}
+
+// --- Writer ---
+
+Dataset::Writer::~Writer() {
+    close();
+}
+
+bool Dataset::Writer::open(const std::string& path) {
+    close();
+    file = fopen(path.c_str(), "wb");
+    if (!file) return false;
+
+    FileHeader header{};
+    header.magic = MAGIC;
+    header.version = SCHEMA_VERSION;
+    header.columns = NUM_COLUMNS;
+    std::copy(std::begin(COLUMN_WIDTHS), std::end(COLUMN_WIDTHS), header.widths);
+    failed = fwrite(&header, sizeof(header), 1, file) != 1;
+
+    totalRows = 0;
+    index.clear();
+    positions.reserve(GROUP_ROWS);
+    actions.reserve(GROUP_ROWS);
+    outcomes.reserve(GROUP_ROWS);
+    games.reserve(GROUP_ROWS);
+    return true;
+}
+
+void Dataset::Writer::append(const PositionRow& row, const Rules::Action& action, int8_t outcome, uint32_t game) {
+    positions.push_back(row);
+    actions.push_back(packAction(action));
+    outcomes.push_back(outcome);
+    games.push_back(game);
+    totalRows++;
+    if (positions.size() == GROUP_ROWS) {
+        flushGroup();
+    }
+}
+
+// Once a write fails the file is abandoned: later groups are dropped and close() reports it
+void Dataset::Writer::flushGroup() {
+    if (positions.empty()) return;
+    if (failed) {
+        positions.clear();
+        actions.clear();
+        outcomes.clear();
+        games.clear();
+        return;
+    }
+
+    uint64_t offset = sizeof(FileHeader);
+    if (!index.empty()) {
+        const GroupIndex& last = index.back();
+        offset = last.offsets[NUM_COLUMNS - 1] + last.rows * COLUMN_WIDTHS[NUM_COLUMNS - 1];
+    }
+
+    GroupIndex group{};
+    group.firstRow = totalRows - positions.size();
+    group.rows = positions.size();
+    const void* data[NUM_COLUMNS] = {positions.data(), actions.data(), outcomes.data(), games.data()};
+    for (int c = 0; c < NUM_COLUMNS && !failed; c++) {
+        failed = !writeAligned(file, nullptr, 0, offset);
+        group.offsets[c] = offset;
+        failed = failed || !writeAligned(file, data[c], group.rows * COLUMN_WIDTHS[c], offset);
+    }
+    index.push_back(group);
+
+    positions.clear();
+    actions.clear();
+    outcomes.clear();
+    games.clear();
+}
+
+bool Dataset::Writer::close() {
+    if (!file) return true;
+    flushGroup();
+
+    uint64_t offset = sizeof(FileHeader);
+    if (!index.empty()) {
+        const GroupIndex& last = index.back();
+        offset = last.offsets[NUM_COLUMNS - 1] + last.rows * COLUMN_WIDTHS[NUM_COLUMNS - 1];
+    }
+    bool ok = !failed && writeAligned(file, nullptr, 0, offset);
+
+    Footer footer{};
+    footer.indexOffset = offset;
+    footer.groups = index.size();
+    footer.rows = totalRows;
+    footer.magic = MAGIC;
+    ok = ok && fwrite(index.data(), sizeof(GroupIndex), index.size(), file) == index.size();
+    ok = ok && fwrite(&footer, sizeof(footer), 1, file) == 1;
+    ok = fclose(file) == 0 && ok;
+    file = nullptr;
+    failed = false;
+    return ok;
+}
+
+// --- Reader ---
+
+Dataset::Reader::~Reader() {
+    close();
+}
+
+bool Dataset::Reader::open(const std::string& path) {
+    close();
+#ifdef _WIN32
+    HANDLE handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER fileSize;
+    GetFileSizeEx(handle, &fileSize);
+    HANDLE mapping = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        CloseHandle(handle);
+        return false;
+    }
+    base = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    fileHandle = handle;
+    mappingHandle = mapping;
+    mappedSize = static_cast<size_t>(fileSize.QuadPart);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        ::close(fd);
+        return false;
+    }
+    void* mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) return false;
+    base = static_cast<const uint8_t*>(mapped);
+    mappedSize = info.st_size;
+#endif
+    if (!base) {
+        close();
+        return false;
+    }
+
+    // Validate header, footer and index before handing out pointers
+    FileHeader header;
+    if (mappedSize < sizeof(FileHeader) + sizeof(Footer)) {
+        close();
+        return false;
+    }
+    std::memcpy(&header, base, sizeof(header));
+    std::memcpy(&footer, base + mappedSize - sizeof(Footer), sizeof(Footer));
+    // The index must exactly fill the gap before the footer; compare by division so a
+    // corrupt group count cannot overflow the size arithmetic
+    uint64_t indexEnd = mappedSize - sizeof(Footer);
+    bool valid = header.magic == MAGIC && header.version == SCHEMA_VERSION &&
+                 header.columns == NUM_COLUMNS && footer.magic == MAGIC &&
+                 std::equal(std::begin(COLUMN_WIDTHS), std::end(COLUMN_WIDTHS), header.widths) &&
+                 footer.indexOffset >= sizeof(FileHeader) && footer.indexOffset <= indexEnd &&
+                 (indexEnd - footer.indexOffset) % sizeof(GroupIndex) == 0 &&
+                 (indexEnd - footer.indexOffset) / sizeof(GroupIndex) == footer.groups;
+    if (!valid) {
+        close();
+        return false;
+    }
+
+    // Every column of every group must be aligned and lie between the header and the index,
+    // and groups must be full and in row order because lookups index them by row / GROUP_ROWS
+    const GroupIndex* groupsIn = reinterpret_cast<const GroupIndex*>(base + footer.indexOffset);
+    uint64_t expectedRow = 0;
+    for (uint64_t g = 0; g < footer.groups && valid; g++) {
+        GroupIndex group;
+        std::memcpy(&group, groupsIn + g, sizeof(group));
+        bool last = g + 1 == footer.groups;
+        valid = group.firstRow == expectedRow && group.rows > 0 && group.rows <= GROUP_ROWS &&
+                (last || group.rows == GROUP_ROWS);
+        for (int c = 0; c < NUM_COLUMNS && valid; c++) {
+            uint64_t offset = group.offsets[c];
+            valid = offset >= sizeof(FileHeader) && offset % COLUMN_ALIGN == 0 && offset <= footer.indexOffset &&
+                    group.rows <= (footer.indexOffset - offset) / COLUMN_WIDTHS[c];
+        }
+        expectedRow += group.rows;
+    }
+    if (!valid || expectedRow != footer.rows) {
+        close();
+        return false;
+    }
+    groupIndex = groupsIn;
+    return true;
+}
+
+void Dataset::Reader::close() {
+#ifdef _WIN32
+    if (base) UnmapViewOfFile(base);
+    if (mappingHandle) CloseHandle(mappingHandle);
+    if (fileHandle) CloseHandle(fileHandle);
+    fileHandle = mappingHandle = nullptr;
+#else
+    if (base) munmap(const_cast<uint8_t*>(base), mappedSize);
+#endif
+    base = nullptr;
+    mappedSize = 0;
+    groupIndex = nullptr;
+    footer = Footer{};
+}
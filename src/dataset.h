@@ -0,0 +1,161 @@
+#pragma once
+#include "rules.h"
+
+// Columnar, memory-mapped storage for self-play (state, action, outcome) triples.
+//
+// File layout (little-endian):
+//   FileHeader                  magic, schema version, column widths
+//   row group 0 .. N-1          each column stored contiguously for up to GROUP_ROWS rows
+//   GroupIndex[N]               first row, row count and per-column byte offsets of each group
+//   Footer                      offset of the index, group count, total rows, magic
+//
+// Writers stream one group at a time, so memory stays bounded for any corpus size;
+// readers map the file and hand out pointers straight into it.
+namespace Dataset {
+    constexpr uint32_t MAGIC = 0x53444354;  // "TCDS"
+    constexpr uint16_t SCHEMA_VERSION = 2;  // 2: field[] indexed by slot, fieldSlots mask
+    constexpr uint32_t GROUP_ROWS = 1 << 16;
+    constexpr int HAND_SLOTS = Rules::MAX_HAND_SLOTS;
+
+    constexpr const char* DEFAULT_PATH = "selfplay.tcd";
+
+    enum Column {
+        POSITION,
+        ACTION,
+        OUTCOME,
+        GAME,
+        NUM_COLUMNS
+    };
+
+    #pragma pack(push, 1)
+    struct RowCard {
+        uint16_t nameId;
+        uint8_t typeFaction;  // type << 4 | faction
+        uint8_t roleFlags;    // role << 4 | inPlay << 2 | synergy buff << 1 | attacked
+        int8_t cost;
+        int8_t attack;
+        int8_t health;
+        int8_t effect;
+    };
+
+    // Fixed-width encoding of everything a position needs except the deck order
+    // and original stats (decoded champions treat their current stats as original)
+    struct PositionRow {
+        int8_t playerHealth;
+        int8_t enemyHealth;
+        int8_t playerEnergy;
+        int8_t enemyEnergy;
+        int8_t tensorCurrent;
+        int8_t tensorMaximum;
+        uint8_t isPlayerTurn;
+        uint8_t deckSize;
+        uint8_t handCount[2];   // clamped to HAND_SLOTS
+        uint8_t fieldCount[2];
+        uint8_t fieldSlots[2];  // live slot mask
+        uint8_t reserved[2];
+        RowCard field[2][MAX_FIELD_SIZE];  // indexed by slot
+        RowCard hand[2][HAND_SLOTS];
+    };
+
+    struct PackedAction {
+        uint8_t type;
+        int8_t index;
+        int8_t target;
+        int8_t slot;    // Rules::actionSlot, -1 if none
+    };
+
+    struct FileHeader {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t columns;
+        uint32_t widths[NUM_COLUMNS];
+    };
+
+    struct GroupIndex {
+        uint64_t firstRow;
+        uint64_t rows;
+        uint64_t offsets[NUM_COLUMNS];
+    };
+
+    struct Footer {
+        uint64_t indexOffset;
+        uint64_t groups;
+        uint64_t rows;
+        uint32_t reserved;
+        uint32_t magic;
+    };
+    #pragma pack(pop)
+
+    static_assert(sizeof(RowCard) == 8, "RowCard must stay 8 bytes");
+    static_assert(sizeof(PositionRow) == 240, "PositionRow must stay 240 bytes");
+
+    constexpr uint32_t COLUMN_WIDTHS[NUM_COLUMNS] = {
+        sizeof(PositionRow), sizeof(PackedAction), sizeof(int8_t), sizeof(uint32_t)
+    };
+
+    void encode(const GameState& state, PositionRow& row);
+    // Reuses state's vector capacity. False, with state half built, if a card's type,
+    // faction or role is out of range; hand counts past HAND_SLOTS are clamped.
+    bool decode(const PositionRow& row, GameState& state);
+    PackedAction packAction(const Rules::Action& action);
+    Rules::Action unpackAction(const PackedAction& packed);
+
+    class Writer {
+    public:
+        ~Writer();
+        bool open(const std::string& path);
+        void append(const PositionRow& row, const Rules::Action& action, int8_t outcome, uint32_t game);
+        bool close();  // false if any write since open() failed
+        uint64_t rows() const { return totalRows; }
+
+    private:
+        void flushGroup();
+
+        FILE* file = nullptr;
+        bool failed = false;
+        uint64_t totalRows = 0;
+        std::vector<PositionRow> positions;
+        std::vector<PackedAction> actions;
+        std::vector<int8_t> outcomes;
+        std::vector<uint32_t> games;
+        std::vector<GroupIndex> index;
+    };
+
+    class Reader {
+    public:
+        ~Reader();
+        bool open(const std::string& path);
+        void close();
+
+        uint64_t rows() const { return footer.rows; }
+        size_t groups() const { return footer.groups; }
+
+        const PositionRow& position(uint64_t row) const { return column<PositionRow>(POSITION, row); }
+        const PackedAction& action(uint64_t row) const { return column<PackedAction>(ACTION, row); }
+        int8_t outcome(uint64_t row) const { return column<int8_t>(OUTCOME, row); }
+        uint32_t game(uint64_t row) const { return column<uint32_t>(GAME, row); }
+
+        // Whole-column spans of one group for sequential scans
+        template <typename T>
+        const T* groupColumn(size_t group, Column c, uint64_t& count) const {
+            count = groupIndex[group].rows;
+            return reinterpret_cast<const T*>(base + groupIndex[group].offsets[c]);
+        }
+
+    private:
+        template <typename T>
+        const T& column(Column c, uint64_t row) const {
+            const GroupIndex& g = groupIndex[row / GROUP_ROWS];
+            return reinterpret_cast<const T*>(base + g.offsets[c])[row - g.firstRow];
+        }
+
+        const uint8_t* base = nullptr;
+        size_t mappedSize = 0;
+        const GroupIndex* groupIndex = nullptr;
+        Footer footer{};
+#ifdef _WIN32
+        void* fileHandle = nullptr;
+        void* mappingHandle = nullptr;
+#endif
+    };
+}
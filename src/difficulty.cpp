@@ -0,0 +1,84 @@
+#include "difficulty.h"
+#include <cmath>
+#include <fstream>
+
+const char* Difficulty::name(Level level) {
+    switch (level) {
+        case EASY: return "Easy";
+        case NORMAL: return "Normal";
+        case HARD: return "Hard";
+        case EXPERT: return "Expert";
+        case ADAPTIVE: return "Adaptive";
+        case LEVEL_COUNT: break;
+    }
+    return "?";
+}
+
+Difficulty::Budget Difficulty::budgetAt(float rating) {
+    rating = std::clamp(rating, static_cast<float>(EASY), static_cast<float>(EXPERT));
+    int low = std::min(static_cast<int>(rating), EXPERT - 1);
+    float t = rating - low;
+    const Budget& a = BUDGETS[low];
+    const Budget& b = BUDGETS[low + 1];
+    Budget budget;
+    budget.playouts = static_cast<int>(std::lround(a.playouts * std::pow(static_cast<float>(b.playouts) / a.playouts, t)));
+    budget.milliseconds = static_cast<int>(std::lround(a.milliseconds * std::pow(static_cast<float>(b.milliseconds) / a.milliseconds, t)));
+    budget.book = rating >= static_cast<float>(NORMAL);
+    return budget;
+}
+
+void Difficulty::Profile::record(Rules::Result result) {
+    if (result == Rules::ONGOING) return;
+    float score = result == Rules::PLAYER_WIN ? 1.0f : result == Rules::DRAW ? 0.5f : 0.0f;
+    recent.push_back(score);
+    while (recent.size() > RECENT_MATCHES) recent.pop_front();
+
+    float winRate = 0;
+    for (float past : recent) winRate += past;
+    winRate /= recent.size();
+
+    // The window sizes the step, the latest match gates its direction: a loss after a winning
+    // streak holds the rating instead of raising it, and a draw never moves it
+    float error = winRate - TARGET_WIN_RATE;
+    if (std::abs(error) <= DEAD_BAND || score == TARGET_WIN_RATE || (error > 0) != (score > TARGET_WIN_RATE)) return;
+    rating = std::clamp(rating + ADAPT_STEP * 2 * error, static_cast<float>(EASY), static_cast<float>(EXPERT));
+}
+
+// Plain "key value" lines, so a player can read or reset it by hand
+bool Difficulty::Profile::load(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) return false;
+    Profile loaded;
+    std::string key;
+    while (in >> key) {
+        if (key == "level") {
+            int value;
+            if (!(in >> value) || value < 0 || value >= LEVEL_COUNT) return false;
+            loaded.level = static_cast<Level>(value);
+        } else if (key == "rating") {
+            if (!(in >> loaded.rating)) return false;
+            loaded.rating = std::clamp(loaded.rating, static_cast<float>(EASY), static_cast<float>(EXPERT));
+        } else if (key == "recent") {
+            std::string line;
+            std::getline(in, line);
+            std::istringstream scores(line);
+            for (float score; scores >> score && loaded.recent.size() < RECENT_MATCHES;) {
+                loaded.recent.push_back(std::clamp(score, 0.0f, 1.0f));
+            }
+        } else {
+            return false;
+        }
+    }
+    *this = loaded;
+    return true;
+}
+
+bool Difficulty::Profile::save(const std::string& path) const {
+    std::ofstream out(path);
+    out << "level " << level << "\n";
+    out << "rating " << rating << "\n";
+    out << "recent";
+    for (float score : recent) out << " " << score;
+    out << "\n";
+    return static_cast<bool>(out);
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include "rules.h"
+
+// Enemy strength as thinking budget.
+//
+// Every level runs the same search (Mcts) and differs only in how much of it
+// the enemy may do per search: a playout count and a wall-clock limit,
+// whichever runs out first. MctsAgent searches once per turn and follows the
+// line it found, so later moves of the turn cost next to nothing. Easy stops after a handful of playouts; Hard and
+// Expert are bound by time, so they get stronger on a faster machine. The book
+// is consulted from Normal up.
+//
+// ADAPTIVE keeps a rating on the same ladder (0 = Easy .. 3 = Expert) and
+// interpolates the budget between the neighbouring levels. After every
+// finished match the rating steps by how far the player's recent win rate is
+// from one half, outside a small dead band, but only in the direction of that
+// match: a win can only make the enemy harder and a loss only easier.
+namespace Difficulty {
+    enum Level {
+        EASY,
+        NORMAL,
+        HARD,
+        EXPERT,
+        ADAPTIVE,
+        LEVEL_COUNT
+    };
+
+    struct Budget {
+        int playouts;
+        int milliseconds;
+        bool book;
+    };
+
+    constexpr Budget BUDGETS[ADAPTIVE] = {
+        {10, 5, false},
+        {200, 50, true},
+        {100000, 500, true},
+        {1000000, 2000, true}
+    };
+
+    constexpr const char* DEFAULT_PATH = "tensor_profile.txt";
+    constexpr size_t RECENT_MATCHES = 8;
+    constexpr float ADAPT_STEP = 0.5f;  // ladder steps per match at a 100% (or 0%) recent win rate
+    constexpr float TARGET_WIN_RATE = 0.5f;
+    constexpr float DEAD_BAND = 0.125f;  // recent rates within one match in eight of the target hold the rating
+
+    const char* name(Level level);
+
+    // Budget at a point on the ladder; between two levels it is their geometric mean, weighted
+    Budget budgetAt(float rating);
+
+    // The player's chosen level and adaptive state, kept between sessions
+    class Profile {
+    public:
+        Level level = NORMAL;
+        float rating = NORMAL;
+        std::deque<float> recent;  // player's score in the last matches: 1 win, 0.5 draw, 0 loss
+
+        Budget budget() const { return level == ADAPTIVE ? budgetAt(rating) : BUDGETS[level]; }
+
+        // Counts a finished match; result is Rules::result() at its end
+        void record(Rules::Result result);
+
+        bool load(const std::string& path);
+        bool save(const std::string& path) const;
+    };
+}
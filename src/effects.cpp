@@ -0,0 +1,694 @@
+#include "effects.h"
+#include <fstream>
+
+// GCC and Clang dispatch through a label table (one indirect jump per opcode,
+// each with its own branch history); anything else falls back to a switch loop.
+#if defined(__GNUC__)
+#define EFFECTS_COMPUTED_GOTO 1
+#endif
+
+const char* const Effects::BUILTIN = R"(# Tensor Concord card effects
+
+on play ARTIFACT:
+    # Odd buffs sharpen, even ones armour
+    if effect % 2 == 1
+        target.attack += effect
+    else
+        target.health += effect
+    end
+
+on play TENSOR:
+    energy += effect
+    gauge += 1
+
+on field TECHNO:
+    target.attack += level
+
+on field CYBER:
+    target.health += level
+
+on hand EXEC:
+    target.cost = max(0, target.cost - level)
+
+on end_turn VIRTU_MACHINA:
+    energy += level
+    gauge += 1
+
+on concordia:
+    target.attack += concordia_attack
+    target.health += concordia_health
+    target.buffed = 1
+)";
+
+namespace {
+    enum Op : uint8_t {
+        OP_HALT,
+        OP_PUSH,        // int16 constant
+        OP_LOAD_VAR,    // var
+        OP_STORE_VAR,   // var
+        OP_ADD_VAR,     // var: var += pop
+        OP_LOAD_CARD,   // card << 4 | field
+        OP_STORE_CARD,
+        OP_ADD_CARD,
+        OP_ADD, OP_SUB, OP_MUL, OP_DIV, OP_MOD, OP_NEG, OP_MIN, OP_MAX,
+        OP_EQ, OP_NE, OP_LT, OP_LE, OP_GT, OP_GE,
+        OP_JUMP_IF_ZERO,  // int16 offset from the next instruction
+        OP_JUMP,
+        OP_COUNT
+    };
+
+    // GAUGE_MAX and everything after it are read-only
+    enum Var : uint8_t {
+        ENERGY, HEALTH, ENEMY_ENERGY, ENEMY_HEALTH, GAUGE, GAUGE_MAX, LEVEL, CONCORDIA_ATTACK, CONCORDIA_HEALTH, VAR_COUNT
+    };
+    constexpr const char* VAR_NAMES[VAR_COUNT] = {
+        "energy", "health", "enemy_energy", "enemy_health", "gauge", "gauge_max", "level",
+        "concordia_attack", "concordia_health"
+    };
+
+    // Card fields: the stat columns first, so loads and stores of those are one member pointer away
+    enum Field : uint8_t {
+        COST, ATTACK, HEALTH_FIELD, EFFECT, TURNS, BASE_ATTACK, BASE_HEALTH, INT_FIELDS,
+        ATTACKED = INT_FIELDS, BUFFED, FACTION, ROLE, TYPE, FIELD_COUNT
+    };
+    constexpr const char* FIELD_NAMES[FIELD_COUNT] = {
+        "cost", "attack", "health", "effect", "turns", "base_attack", "base_health",
+        "attacked", "buffed", "faction", "role", "type"
+    };
+    using Column = std::array<int8_t, CardPool::CAPACITY> CardPool::*;
+    constexpr Column INT_COLUMNS[INT_FIELDS] = {
+        &CardPool::cost, &CardPool::attack, &CardPool::health, &CardPool::effect,
+        &CardPool::turnsInPlay, &CardPool::originalAttack, &CardPool::originalHealth
+    };
+
+    constexpr uint8_t SELF = 0, TARGET = 1;
+    constexpr int MAX_STACK = 16;
+    constexpr int MAX_NESTING = 64;  // parentheses, unary minus and ifs, so the parser's recursion stays shallow
+
+    struct Constant { const char* name; int value; };
+    constexpr Constant CONSTANTS[] = {
+        {"CHAMPION", Card::CHAMPION}, {"ARTIFACT", Card::ARTIFACT}, {"TENSOR", Card::TENSOR},
+        {"TECHNO", Card::TECHNO}, {"CYBER", Card::CYBER}, {"EXEC", Card::EXEC},
+        {"VIRTU_MACHINA", Card::VIRTU_MACHINA},
+        {"MERC", Card::MERC}, {"NOMAD", Card::NOMAD}, {"CORPO", Card::CORPO}, {"MAGE", Card::MAGE}
+    };
+
+    int readField(const CardPool& cards, CardHandle card, uint8_t field) {
+        if (field < INT_FIELDS) return (cards.*INT_COLUMNS[field])[card];
+        switch (field) {
+            case ATTACKED: return cards.attacked[card];
+            case BUFFED:   return cards.buffed[card];
+            case FACTION:  return cards.faction[card];
+            case ROLE:     return cards.role[card];
+            default:       return cards.type[card];
+        }
+    }
+
+    void writeField(CardPool& cards, CardHandle card, uint8_t field, int value) {
+        if (field < INT_FIELDS) {
+            // Stats are a byte wide in the pool: saturate instead of wrapping a big buff negative
+            (cards.*INT_COLUMNS[field])[card] = static_cast<int8_t>(std::clamp(value, -128, 127));
+        } else if (field == ATTACKED) {
+            cards.attacked[card] = value != 0;
+        } else {
+            cards.buffed[card] = value != 0;  // the compiler only lets the two flags through here
+        }
+    }
+
+    // Compiled script: one code buffer, offset 0 is a HALT that stands for "no section"
+    struct Table {
+        std::vector<uint8_t> code{OP_HALT};
+        std::array<std::array<uint32_t, 5>, Effects::SCOPE_COUNT> entries{};
+        std::vector<uint32_t> byName;  // play sections of single cards, indexed by nameId
+        bool stock = false;            // compiled from BUILTIN
+    };
+
+    struct Token {
+        enum Kind { END, IDENT, NUMBER, STRING, PUNCT } kind = END;
+        std::string text;
+        int value = 0;
+        int line = 1;
+    };
+
+    class Compiler {
+    public:
+        Compiler(const std::string& source, Table& table) : source(source), table(table) { advance(); }
+
+        bool compile(std::string& error) {
+            while (token.kind != Token::END) {
+                if (!section()) break;
+            }
+            if (!failure.empty()) {
+                error = failure;
+                return false;
+            }
+            return true;
+        }
+
+    private:
+        const std::string& source;
+        Table& table;
+        size_t pos = 0;
+        int line = 1;
+        Token token;
+        std::string failure;
+        int depth = 0;
+        int nesting = 0;
+        bool hasCards = true;  // self/target exist in the section being compiled
+
+        bool fail(const std::string& message) {
+            if (failure.empty()) failure = "line " + std::to_string(token.line) + ": " + message;
+            return false;
+        }
+
+        void advance() {
+            while (pos < source.size()) {
+                char c = source[pos];
+                if (c == '\n') {
+                    line++;
+                    pos++;
+                } else if (std::isspace(static_cast<unsigned char>(c))) {
+                    pos++;
+                } else if (c == '#') {
+                    while (pos < source.size() && source[pos] != '\n') pos++;
+                } else {
+                    break;
+                }
+            }
+
+            token = Token{};
+            token.line = line;
+            if (pos >= source.size()) return;
+
+            char c = source[pos];
+            if (std::isalpha(static_cast<unsigned char>(c)) || c == '_') {
+                size_t start = pos;
+                while (pos < source.size() && (std::isalnum(static_cast<unsigned char>(source[pos])) || source[pos] == '_')) pos++;
+                token.kind = Token::IDENT;
+                token.text = source.substr(start, pos - start);
+            } else if (std::isdigit(static_cast<unsigned char>(c))) {
+                long value = 0;
+                while (pos < source.size() && std::isdigit(static_cast<unsigned char>(source[pos]))) {
+                    value = std::min(value * 10 + (source[pos++] - '0'), 100000L);
+                }
+                token.kind = Token::NUMBER;
+                token.value = static_cast<int>(value);
+            } else if (c == '"') {
+                size_t end = source.find('"', pos + 1);
+                if (end == std::string::npos || source.find('\n', pos) < end) {
+                    pos = source.size();
+                    fail("unterminated string");
+                    return;
+                }
+                token.kind = Token::STRING;
+                token.text = source.substr(pos + 1, end - pos - 1);
+                pos = end + 1;
+            } else {
+                static const char* const TWO[] = {"+=", "-=", "==", "!=", "<=", ">="};
+                token.kind = Token::PUNCT;
+                token.text = std::string(1, c);
+                for (const char* two : TWO) {
+                    if (source.compare(pos, 2, two) == 0) token.text = two;
+                }
+                pos += token.text.size();
+            }
+        }
+
+        bool is(const char* text) const {
+            return (token.kind == Token::PUNCT || token.kind == Token::IDENT) && token.text == text;
+        }
+
+        bool expect(const char* text) {
+            if (!is(text)) return fail(std::string("expected '") + text + "'");
+            advance();
+            return true;
+        }
+
+        void emit(uint8_t byte) { table.code.push_back(byte); }
+
+        void emit16(int value) {
+            emit(static_cast<uint8_t>(value & 0xFF));
+            emit(static_cast<uint8_t>((value >> 8) & 0xFF));
+        }
+
+        // Stack effect of what was just emitted; the interpreter's stack is fixed-size
+        bool adjust(int delta) {
+            depth += delta;
+            return depth <= MAX_STACK || fail("expression too deep");
+        }
+
+        // Counts one level of parser recursion for as long as it lives
+        struct Nested {
+            int& nesting;
+            explicit Nested(int& n) : nesting(++n) {}
+            ~Nested() { nesting--; }
+        };
+
+        bool tooNested() {
+            return nesting > MAX_NESTING && !fail("nested too deeply");
+        }
+
+        size_t emitJump(Op op) {
+            emit(op);
+            emit16(0);
+            return table.code.size();
+        }
+
+        bool patch(size_t from, size_t to) {
+            long offset = static_cast<long>(to) - static_cast<long>(from);
+            if (offset < INT16_MIN || offset > INT16_MAX) return fail("section too long");
+            table.code[from - 2] = static_cast<uint8_t>(offset & 0xFF);
+            table.code[from - 1] = static_cast<uint8_t>((offset >> 8) & 0xFF);
+            return true;
+        }
+
+        int keyFor(const std::vector<const char*>& names) {
+            if (token.kind != Token::IDENT) return -1;
+            for (const auto& constant : CONSTANTS) {
+                if (token.text != constant.name) continue;
+                for (const char* name : names) {
+                    if (token.text == name) return constant.value;
+                }
+            }
+            return -1;
+        }
+
+        // on <scope> <key>:
+        bool section() {
+            if (!expect("on")) return false;
+
+            uint32_t* slot = nullptr;
+            std::string scope = token.text;
+            if (token.kind != Token::IDENT) return fail("expected a scope");
+            advance();
+
+            hasCards = scope != "end_turn";
+            if (scope == "play") {
+                if (token.kind == Token::STRING) {
+                    uint16_t id = CardNames::intern(token.text.c_str());
+                    if (id == CardNames::INVALID) return fail("too many card names");
+                    if (table.byName.size() <= id) table.byName.resize(id + 1, 0);
+                    slot = &table.byName[id];
+                } else {
+                    int type = keyFor({"CHAMPION", "ARTIFACT", "TENSOR"});
+                    if (type < 0) return fail("play needs a card type or a quoted card name");
+                    slot = &table.entries[Effects::PLAY][type];
+                }
+                advance();
+            } else if (scope == "concordia") {
+                slot = &table.entries[Effects::CONCORDIA][0];
+            } else {
+                Effects::Scope id = scope == "field" ? Effects::FIELD :
+                                    scope == "hand" ? Effects::HAND :
+                                    scope == "end_turn" ? Effects::END_TURN : Effects::SCOPE_COUNT;
+                if (id == Effects::SCOPE_COUNT) return fail("unknown scope '" + scope + "'");
+                int faction = keyFor({"TECHNO", "CYBER", "EXEC", "VIRTU_MACHINA"});
+                if (faction < 0) return fail(scope + " needs a faction");
+                slot = &table.entries[id][faction];
+                advance();
+            }
+            if (*slot) return fail("section defined twice");
+            if (!expect(":")) return false;
+
+            *slot = static_cast<uint32_t>(table.code.size());
+            while (token.kind != Token::END && !is("on")) {
+                if (!statement()) return false;
+            }
+            emit(OP_HALT);
+            return true;
+        }
+
+        // A variable reference: returns the load opcode and its operand
+        bool reference(Op& op, uint8_t& operand, bool forWrite) {
+            if (token.kind != Token::IDENT) return fail("expected a variable");
+            std::string name = token.text;
+            advance();
+
+            if (name == "self" || name == "target") {
+                if (!hasCards) return fail("no cards in end_turn sections");
+                if (!expect(".")) return false;
+                if (token.kind != Token::IDENT) return fail("expected a card field");
+                for (uint8_t f = 0; f < FIELD_COUNT; f++) {
+                    if (token.text != FIELD_NAMES[f]) continue;
+                    if (forWrite && f > BUFFED) return fail(token.text + " is read-only");
+                    advance();
+                    op = OP_LOAD_CARD;
+                    operand = static_cast<uint8_t>((name == "self" ? SELF : TARGET) << 4 | f);
+                    return true;
+                }
+                return fail("unknown card field '" + token.text + "'");
+            }
+            if (name == "effect") {
+                if (!hasCards) return fail("no cards in end_turn sections");
+                op = OP_LOAD_CARD;
+                operand = SELF << 4 | EFFECT;
+                return true;
+            }
+            for (uint8_t v = 0; v < VAR_COUNT; v++) {
+                if (name != VAR_NAMES[v]) continue;
+                if (forWrite && v >= GAUGE_MAX) return fail(name + " is read-only");
+                op = OP_LOAD_VAR;
+                operand = v;
+                return true;
+            }
+            return fail("unknown variable '" + name + "'");
+        }
+
+        bool statement() {
+            if (is("if")) {
+                Nested nested(nesting);
+                if (tooNested()) return false;
+                advance();
+                if (!expression()) return false;
+                adjust(-1);
+                size_t skip = emitJump(OP_JUMP_IF_ZERO);
+                while (!is("else") && !is("end")) {
+                    if (token.kind == Token::END || is("on")) return fail("'if' without 'end'");
+                    if (!statement()) return false;
+                }
+                if (is("else")) {
+                    advance();
+                    size_t over = emitJump(OP_JUMP);
+                    if (!patch(skip, table.code.size())) return false;
+                    skip = over;
+                    while (!is("end")) {
+                        if (token.kind == Token::END || is("on")) return fail("'if' without 'end'");
+                        if (!statement()) return false;
+                    }
+                }
+                advance();
+                return patch(skip, table.code.size());
+            }
+
+            Op load;
+            uint8_t operand;
+            if (!reference(load, operand, true)) return false;
+            bool cardField = load == OP_LOAD_CARD;
+
+            std::string assign = token.text;
+            if (token.kind != Token::PUNCT || (assign != "=" && assign != "+=" && assign != "-=")) {
+                return fail("expected '=', '+=' or '-='");
+            }
+            advance();
+
+            if (assign == "-=") {
+                // x -= e is x = x - e
+                emit(load);
+                emit(operand);
+                if (!adjust(1) || !expression()) return false;
+                emit(OP_SUB);
+                adjust(-1);
+            } else if (!expression()) {
+                return false;
+            }
+
+            if (assign == "+=") {
+                emit(cardField ? OP_ADD_CARD : OP_ADD_VAR);
+            } else {
+                emit(cardField ? OP_STORE_CARD : OP_STORE_VAR);
+            }
+            emit(operand);
+            adjust(-1);
+            return true;
+        }
+
+        bool expression() {
+            if (!sum()) return false;
+            static const std::pair<const char*, Op> COMPARISONS[] = {
+                {"==", OP_EQ}, {"!=", OP_NE}, {"<", OP_LT}, {"<=", OP_LE}, {">", OP_GT}, {">=", OP_GE}
+            };
+            for (const auto& [text, op] : COMPARISONS) {
+                if (token.kind == Token::PUNCT && token.text == text) {
+                    advance();
+                    if (!sum()) return false;
+                    emit(op);
+                    adjust(-1);
+                    return true;
+                }
+            }
+            return true;
+        }
+
+        bool sum() {
+            if (!term()) return false;
+            while (is("+") || is("-")) {
+                Op op = is("+") ? OP_ADD : OP_SUB;
+                advance();
+                if (!term()) return false;
+                emit(op);
+                adjust(-1);
+            }
+            return true;
+        }
+
+        bool term() {
+            if (!unary()) return false;
+            while (is("*") || is("/") || is("%")) {
+                Op op = is("*") ? OP_MUL : is("/") ? OP_DIV : OP_MOD;
+                advance();
+                if (!unary()) return false;
+                emit(op);
+                adjust(-1);
+            }
+            return true;
+        }
+
+        bool unary() {
+            Nested nested(nesting);
+            if (tooNested()) return false;
+            if (is("-")) {
+                advance();
+                if (!unary()) return false;
+                emit(OP_NEG);
+                return true;
+            }
+            return primary();
+        }
+
+        bool primary() {
+            if (token.kind == Token::NUMBER) {
+                if (token.value > INT16_MAX) return fail("constant out of range");
+                emit(OP_PUSH);
+                emit16(token.value);
+                advance();
+                return adjust(1);
+            }
+            if (is("(")) {
+                advance();
+                return expression() && expect(")");
+            }
+            if (is("min") || is("max")) {
+                Op op = is("min") ? OP_MIN : OP_MAX;
+                advance();
+                if (!expect("(") || !expression() || !expect(",") || !expression() || !expect(")")) return false;
+                emit(op);
+                adjust(-1);
+                return true;
+            }
+            for (const auto& constant : CONSTANTS) {
+                if (token.kind == Token::IDENT && token.text == constant.name) {
+                    emit(OP_PUSH);
+                    emit16(constant.value);
+                    advance();
+                    return adjust(1);
+                }
+            }
+
+            Op load;
+            uint8_t operand;
+            if (!reference(load, operand, false)) return false;
+            emit(load);
+            emit(operand);
+            return adjust(1);
+        }
+    };
+
+    Table compileBuiltin() {
+        Table table;
+        std::string error;
+        Compiler(Effects::BUILTIN, table).compile(error);
+        table.stock = true;
+        return table;
+    }
+
+    Table& active() {
+        static Table table = compileBuiltin();
+        return table;
+    }
+}
+
+Effects::Context::Context(GameState& state, Rules::Side side, int level)
+    : cards(state.cards), level(level), concordia{state.rules->concordiaAttack, state.rules->concordiaHealth} {
+    Rules::Side other = Rules::opponent(side);
+    vars = {&Rules::energy(state, side), &Rules::health(state, side),
+            &Rules::energy(state, other), &Rules::health(state, other),
+            &state.tensor.current, &state.tensor.maximum, &this->level, &concordia[0], &concordia[1]};
+}
+
+bool Effects::stock() {
+    return active().stock;
+}
+
+uint32_t Effects::entry(Scope scope, int key) {
+    return active().entries[scope][key];
+}
+
+uint32_t Effects::playEntry(const CardPool& cards, CardHandle card) {
+    const Table& table = active();
+    uint16_t nameId = cards.nameId[card];
+    if (nameId < table.byName.size() && table.byName[nameId]) {
+        return table.byName[nameId];
+    }
+    return table.entries[PLAY][cards.type[card]];
+}
+
+void Effects::run(uint32_t entry, Context& context) {
+    const uint8_t* pc = active().code.data() + entry;
+    int stack[MAX_STACK];
+    int* top = stack;  // one past the last value
+    CardPool& pool = context.cards;
+    const CardHandle cards[2] = {context.self, context.target};
+    int* const* vars = context.vars.data();
+
+    auto read16 = [&pc]() {
+        int16_t value = static_cast<int16_t>(pc[0] | pc[1] << 8);
+        pc += 2;
+        return value;
+    };
+
+#if EFFECTS_COMPUTED_GOTO
+    static const void* const LABELS[OP_COUNT] = {
+        &&L_OP_HALT, &&L_OP_PUSH, &&L_OP_LOAD_VAR, &&L_OP_STORE_VAR, &&L_OP_ADD_VAR,
+        &&L_OP_LOAD_CARD, &&L_OP_STORE_CARD, &&L_OP_ADD_CARD,
+        &&L_OP_ADD, &&L_OP_SUB, &&L_OP_MUL, &&L_OP_DIV, &&L_OP_MOD, &&L_OP_NEG, &&L_OP_MIN, &&L_OP_MAX,
+        &&L_OP_EQ, &&L_OP_NE, &&L_OP_LT, &&L_OP_LE, &&L_OP_GT, &&L_OP_GE,
+        &&L_OP_JUMP_IF_ZERO, &&L_OP_JUMP
+    };
+    #define VM_CASE(op) L_##op:
+    #define VM_NEXT() goto *LABELS[*pc++]
+    VM_NEXT();
+#else
+    #define VM_CASE(op) case op:
+    #define VM_NEXT() continue
+    for (;;) switch (*pc++) {
+#endif
+
+    VM_CASE(OP_HALT)
+        return;
+    VM_CASE(OP_PUSH)
+        *top++ = read16();
+        VM_NEXT();
+    VM_CASE(OP_LOAD_VAR)
+        *top++ = *vars[*pc++];
+        VM_NEXT();
+    VM_CASE(OP_STORE_VAR)
+        *vars[*pc++] = *--top;
+        VM_NEXT();
+    VM_CASE(OP_ADD_VAR)
+        *vars[*pc++] += *--top;
+        VM_NEXT();
+    VM_CASE(OP_LOAD_CARD)
+        *top++ = readField(pool, cards[*pc >> 4], *pc & 0xF);
+        pc++;
+        VM_NEXT();
+    VM_CASE(OP_STORE_CARD)
+        writeField(pool, cards[*pc >> 4], *pc & 0xF, *--top);
+        pc++;
+        VM_NEXT();
+    VM_CASE(OP_ADD_CARD) {
+        CardHandle card = cards[*pc >> 4];
+        uint8_t field = *pc++ & 0xF;
+        writeField(pool, card, field, readField(pool, card, field) + *--top);
+        VM_NEXT();
+    }
+    VM_CASE(OP_ADD)
+        top--; top[-1] += top[0];
+        VM_NEXT();
+    VM_CASE(OP_SUB)
+        top--; top[-1] -= top[0];
+        VM_NEXT();
+    VM_CASE(OP_MUL)
+        top--; top[-1] *= top[0];
+        VM_NEXT();
+    VM_CASE(OP_DIV)
+        top--; top[-1] = top[0] ? top[-1] / top[0] : 0;  // a bad script must not take the engine down
+        VM_NEXT();
+    VM_CASE(OP_MOD)
+        top--; top[-1] = top[0] ? top[-1] % top[0] : 0;
+        VM_NEXT();
+    VM_CASE(OP_NEG)
+        top[-1] = -top[-1];
+        VM_NEXT();
+    VM_CASE(OP_MIN)
+        top--; top[-1] = std::min(top[-1], top[0]);
+        VM_NEXT();
+    VM_CASE(OP_MAX)
+        top--; top[-1] = std::max(top[-1], top[0]);
+        VM_NEXT();
+    VM_CASE(OP_EQ)
+        top--; top[-1] = top[-1] == top[0];
+        VM_NEXT();
+    VM_CASE(OP_NE)
+        top--; top[-1] = top[-1] != top[0];
+        VM_NEXT();
+    VM_CASE(OP_LT)
+        top--; top[-1] = top[-1] < top[0];
+        VM_NEXT();
+    VM_CASE(OP_LE)
+        top--; top[-1] = top[-1] <= top[0];
+        VM_NEXT();
+    VM_CASE(OP_GT)
+        top--; top[-1] = top[-1] > top[0];
+        VM_NEXT();
+    VM_CASE(OP_GE)
+        top--; top[-1] = top[-1] >= top[0];
+        VM_NEXT();
+    VM_CASE(OP_JUMP_IF_ZERO) {
+        int offset = read16();
+        if (*--top == 0) pc += offset;
+        VM_NEXT();
+    }
+    VM_CASE(OP_JUMP) {
+        int offset = read16();
+        pc += offset;
+        VM_NEXT();
+    }
+
+#if !EFFECTS_COMPUTED_GOTO
+        default:
+            return;
+    }
+#endif
+    #undef VM_CASE
+    #undef VM_NEXT
+}
+
+bool Effects::load(const std::string& source, std::string& error) {
+    // Names are sent and hashed as ids: a script's own names must come after the catalogue's
+    CardNames::seedCatalogue();
+    Table table;
+    if (!Compiler(source, table).compile(error)) return false;
+    table.stock = source == BUILTIN;
+    active() = std::move(table);
+    return true;
+}
+
+bool Effects::loadFile(const std::string& path, std::string& error) {
+    std::ifstream in(path);
+    if (!in) {
+        error = "cannot open " + path;
+        return false;
+    }
+    std::stringstream source;
+    source << in.rdbuf();
+    if (!load(source.str(), error)) {
+        error = path + ": " + error;
+        return false;
+    }
+    return true;
+}
+
+bool Effects::loadDefaultFile(std::string& error) {
+    if (!std::ifstream(DEFAULT_FILE)) return true;
+    return loadFile(DEFAULT_FILE, error);
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include "rules.h"
+
+// Card effects as scripts.
+//
+// What a played card does and what each faction synergy grants is written in a
+// small effect language, compiled once to bytecode and run by Rules through a
+// tight interpreter, so designers can rebalance cards or give one card its own
+// effect by editing tensor_effects.txt instead of rebuilding. A script is a
+// list of sections:
+//
+//   on play ARTIFACT:                 # every artifact; "on play \"Neural Link\":" for one card
+//       if effect % 2 == 1
+//           target.attack += effect
+//       else
+//           target.health += effect
+//       end
+//
+// Scopes and what self/target are while they run:
+//   play <TYPE|"name">     the card just played; target is the artifact's target, else the card itself
+//   field <FACTION>        each champion of an active synergy's faction, after stats are reset
+//   hand <FACTION>         each hand card of an active synergy's faction
+//   end_turn <FACTION>     once when the turn ends with the synergy active (no cards)
+//   concordia              each champion while Tensor Concordia is active
+//
+// Statements: `x = e`, `x += e`, `x -= e`, `if e ... [else ...] end`. Expressions
+// have + - * / % == != < <= > >=, unary minus, parentheses, min(a, b), max(a, b),
+// integers and the faction/type names as constants. Variables: energy, health,
+// enemy_energy, enemy_health, gauge, and read-only gauge_max, level (the synergy
+// level) and concordia_attack/concordia_health (the RuleSet's Concordia bonus),
+// effect (self.effect) and self./target. cost, attack, health, effect, turns,
+// base_attack, base_health, attacked, buffed, plus read-only faction, role, type.
+namespace Effects {
+    constexpr const char* DEFAULT_FILE = "tensor_effects.txt";
+
+    // The stock card rules, active until load() succeeds
+    extern const char* const BUILTIN;
+
+    enum Scope : uint8_t {
+        PLAY,       // keyed by Card::Type (or a card name, see play())
+        FIELD,      // keyed by Card::Faction
+        HAND,
+        END_TURN,
+        CONCORDIA,  // key 0
+        SCOPE_COUNT
+    };
+
+    // What a running script can read and write
+    class Context {
+    public:
+        Context(GameState& state, Rules::Side side, int level = 0);
+        Context(const Context&) = delete;
+        Context& operator=(const Context&) = delete;
+
+        CardHandle self = 0;    // handles into the state's CardPool
+        CardHandle target = 0;
+
+    private:
+        friend void run(uint32_t entry, Context& context);
+        CardPool& cards;
+        int level;
+        std::array<int, 2> concordia;
+        std::array<int*, 9> vars;
+    };
+
+    // True while BUILTIN is active. Its writes stay in the ranges the engine relies on,
+    // so Rules only clamps what a script wrote (energy, costs, gauge, champion stats and
+    // destroyed champions) when another script is loaded.
+    bool stock();
+
+    // Entry point of a section, 0 if the loaded script has none
+    uint32_t entry(Scope scope, int key);
+    uint32_t playEntry(const CardPool& cards, CardHandle card);  // the card's own section, else its type's
+    void run(uint32_t entry, Context& context);
+
+    // Compiles source and, only if all of it compiles, replaces the active effects.
+    // Not thread-safe: load before any matches start.
+    bool load(const std::string& source, std::string& error);
+    bool loadFile(const std::string& path, std::string& error);
+    bool loadDefaultFile(std::string& error);  // DEFAULT_FILE if there is one; false only if it fails to compile
+}
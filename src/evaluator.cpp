@@ -0,0 +1,375 @@
+#include "evaluator.h"
+#include <cmath>
+#include <fstream>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define EVALUATOR_AVX2 1
+#endif
+
+namespace {
+    constexpr uint32_t WEIGHTS_MAGIC = 0x4e4e4354;  // "TCNN"
+    constexpr uint32_t WEIGHTS_VERSION = 1;
+    constexpr int MAX_WIDTH = 128;                  // widest layer input/output
+
+    // dst[0..n) += a * w[0..n)
+    inline void axpy(float* __restrict dst, const float* __restrict w, float a, int n) {
+        for (int j = 0; j < n; j++) {
+            dst[j] += a * w[j];
+        }
+    }
+
+    // out[b][o] = bias[o] + sum_i in[b][i] * w[i][o], four rows per pass so each
+    // weight row is pulled into cache once per block. Zero inputs (one-hot features,
+    // dead ReLUs) are skipped.
+    void gemmFloatPortable(const float* in, int batch, const Evaluator::Layer& layer, float* out) {
+        const int n = layer.outputs;
+        const int k = layer.inputs;
+        for (int b = 0; b < batch; b += 4) {
+            int rows = std::min(4, batch - b);
+            for (int r = 0; r < rows; r++) {
+                std::copy(layer.bias.begin(), layer.bias.end(), out + (b + r) * n);
+            }
+            for (int i = 0; i < k; i++) {
+                const float* w = &layer.weights[i * n];
+                for (int r = 0; r < rows; r++) {
+                    float a = in[(b + r) * k + i];
+                    if (a != 0.0f) {
+                        axpy(out + (b + r) * n, w, a, n);
+                    }
+                }
+            }
+        }
+    }
+
+#ifdef EVALUATOR_AVX2
+    // The same loop with 8-wide fused multiply-adds. It is compiled for AVX2/FMA
+    // whatever the build flags, and gemmFloat() only calls it on a CPU that has them.
+    __attribute__((target("avx2,fma")))
+    void gemmFloatAvx2(const float* in, int batch, const Evaluator::Layer& layer, float* out) {
+        const int n = layer.outputs;
+        const int k = layer.inputs;
+        for (int b = 0; b < batch; b += 4) {
+            int rows = std::min(4, batch - b);
+            for (int r = 0; r < rows; r++) {
+                std::copy(layer.bias.begin(), layer.bias.end(), out + (b + r) * n);
+            }
+            for (int i = 0; i < k; i++) {
+                const float* w = &layer.weights[i * n];
+                for (int r = 0; r < rows; r++) {
+                    float a = in[(b + r) * k + i];
+                    if (a == 0.0f) continue;
+                    float* dst = out + (b + r) * n;
+                    __m256 va = _mm256_set1_ps(a);
+                    int j = 0;
+                    for (; j + 8 <= n; j += 8) {
+                        _mm256_storeu_ps(dst + j, _mm256_fmadd_ps(va, _mm256_loadu_ps(w + j), _mm256_loadu_ps(dst + j)));
+                    }
+                    for (; j < n; j++) {
+                        dst[j] += a * w[j];
+                    }
+                }
+            }
+        }
+    }
+
+    bool cpuHasAvx2() {
+        static const bool has = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+        return has;
+    }
+#endif
+
+    void gemmFloat(const float* in, int batch, const Evaluator::Layer& layer, float* out) {
+#ifdef EVALUATOR_AVX2
+        if (cpuHasAvx2()) {
+            gemmFloatAvx2(in, batch, layer, out);
+            return;
+        }
+#endif
+        gemmFloatPortable(in, batch, layer, out);
+    }
+
+    // Same product with symmetric int8 quantization: per-row activation scale,
+    // per-output weight scale, int32 accumulation.
+    void gemmInt8(const float* in, int batch, const Evaluator::Layer& layer, float* out) {
+        const int n = layer.outputs;
+        const int k = layer.inputs;
+        int8_t qin[MAX_WIDTH];
+        int32_t acc[MAX_WIDTH];
+
+        for (int b = 0; b < batch; b++) {
+            const float* row = in + b * k;
+            float* dst = out + b * n;
+
+            float maxAbs = 0.0f;
+            for (int i = 0; i < k; i++) maxAbs = std::max(maxAbs, std::fabs(row[i]));
+            if (maxAbs == 0.0f) {
+                std::copy(layer.bias.begin(), layer.bias.end(), dst);
+                continue;
+            }
+            float scale = maxAbs / 127.0f;
+            for (int i = 0; i < k; i++) qin[i] = static_cast<int8_t>(std::lround(row[i] / scale));
+
+            std::fill(acc, acc + n, 0);
+            for (int i = 0; i < k; i++) {
+                if (qin[i] == 0) continue;
+                const int8_t* w = &layer.qweights[i * n];
+                int16_t a = qin[i];
+                for (int o = 0; o < n; o++) {
+                    acc[o] += a * w[o];
+                }
+            }
+            for (int o = 0; o < n; o++) {
+                dst[o] = layer.bias[o] + acc[o] * scale * layer.qscale[o];
+            }
+        }
+    }
+
+    void relu(float* data, int count) {
+        for (int i = 0; i < count; i++) {
+            data[i] = std::max(0.0f, data[i]);
+        }
+    }
+}
+
+Evaluator::Evaluator() {
+    const int dims[4] = {NUM_FEATURES, HIDDEN1, HIDDEN2, NUM_OUTPUTS};
+    for (int l = 0; l < 3; l++) {
+        layers[l].inputs = dims[l];
+        layers[l].outputs = dims[l + 1];
+        layers[l].weights.assign(dims[l] * dims[l + 1], 0.0f);
+        layers[l].bias.assign(dims[l + 1], 0.0f);
+        layers[l].velocity.assign(dims[l] * dims[l + 1] + dims[l + 1], 0.0f);
+    }
+}
+
+void Evaluator::extractFeatures(const GameState& state, Rules::Side perspective, float* out) {
+    std::fill(out, out + NUM_FEATURES, 0.0f);
+    const CardPool& cards = state.cards;
+    int f = 0;
+
+    const Rules::Side sides[2] = {perspective, Rules::opponent(perspective)};
+    for (Rules::Side side : sides) {
+        const auto& field = Rules::field(state, side);
+        for (size_t slot = 0; slot < MAX_FIELD_SIZE; slot++, f += 9) {
+            if (!field.occupied(slot)) continue;
+            CardHandle card = field[slot];
+            out[f + 0] = 1.0f;
+            out[f + 1] = cards.attack[card] / 10.0f;
+            out[f + 2] = cards.health[card] / 10.0f;
+            out[f + 3] = (cards.turnsInPlay[card] > 0 && !cards.attacked[card]) ? 1.0f : 0.0f;
+            if (cards.faction[card] != Card::FACTION_NONE) {
+                out[f + 3 + cards.faction[card]] = 1.0f;  // slots 4..7
+            }
+            out[f + 8] = cards.buffed[card] ? 1.0f : 0.0f;
+        }
+    }
+
+    for (Rules::Side side : sides) {
+        for (CardHandle card : Rules::field(state, side)) {
+            if (cards.faction[card] != Card::FACTION_NONE) {
+                out[f + cards.faction[card] - 1] += 0.25f;
+            }
+        }
+        f += 4;
+    }
+
+    for (Rules::Side side : sides) {
+        out[f++] = Rules::health(state, side) / 10.0f;
+        out[f++] = Rules::energy(state, side) / 10.0f;
+    }
+
+    out[f++] = state.tensor.current / float(GameState::TensorState::ABSOLUTE_MAX);
+    out[f++] = state.tensor.maximum / float(GameState::TensorState::ABSOLUTE_MAX);
+
+    // Only our own hand is visible; the opponent contributes its size
+    int energy = Rules::energy(state, perspective);
+    for (CardHandle card : Rules::hand(state, perspective)) {
+        out[f + cards.type[card]] += 0.1f;
+        if (cards.cost[card] <= energy) out[f + 3] += 0.1f;
+    }
+    f += 4;
+    out[f++] = Rules::hand(state, sides[1]).size() / 10.0f;
+    out[f++] = state.deck.size() / 50.0f;
+    out[f++] = Rules::toMove(state) == perspective ? 1.0f : 0.0f;
+}
+
+void Evaluator::initRandom(std::mt19937& rng) {
+    for (auto& layer : layers) {
+        // He-uniform keeps ReLU activations in range
+        std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+        float limit = std::sqrt(6.0f / layer.inputs);
+        for (auto& w : layer.weights) w = dist(rng) * limit;
+        std::fill(layer.bias.begin(), layer.bias.end(), 0.0f);
+        std::fill(layer.velocity.begin(), layer.velocity.end(), 0.0f);
+    }
+    quantize();
+}
+
+bool Evaluator::load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+
+    uint32_t header[3];
+    in.read(reinterpret_cast<char*>(header), sizeof(header));
+    if (!in || header[0] != WEIGHTS_MAGIC || header[1] != WEIGHTS_VERSION || header[2] != layers.size()) {
+        return false;
+    }
+    for (auto& layer : layers) {
+        int32_t dims[2];
+        in.read(reinterpret_cast<char*>(dims), sizeof(dims));
+        if (!in || dims[0] != layer.inputs || dims[1] != layer.outputs) return false;
+        in.read(reinterpret_cast<char*>(layer.weights.data()), layer.weights.size() * sizeof(float));
+        in.read(reinterpret_cast<char*>(layer.bias.data()), layer.bias.size() * sizeof(float));
+    }
+    if (!in) return false;
+
+    quantize();
+    return true;
+}
+
+bool Evaluator::save(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) return false;
+
+    uint32_t header[3] = {WEIGHTS_MAGIC, WEIGHTS_VERSION, static_cast<uint32_t>(layers.size())};
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+    for (const auto& layer : layers) {
+        int32_t dims[2] = {layer.inputs, layer.outputs};
+        out.write(reinterpret_cast<const char*>(dims), sizeof(dims));
+        out.write(reinterpret_cast<const char*>(layer.weights.data()), layer.weights.size() * sizeof(float));
+        out.write(reinterpret_cast<const char*>(layer.bias.data()), layer.bias.size() * sizeof(float));
+    }
+    return static_cast<bool>(out);
+}
+
+void Evaluator::quantize() {
+    for (auto& layer : layers) {
+        const int n = layer.outputs;
+        layer.qweights.assign(layer.weights.size(), 0);
+        layer.qscale.assign(n, 0.0f);
+        for (int o = 0; o < n; o++) {
+            float maxAbs = 0.0f;
+            for (int i = 0; i < layer.inputs; i++) {
+                maxAbs = std::max(maxAbs, std::fabs(layer.weights[i * n + o]));
+            }
+            float scale = maxAbs > 0.0f ? maxAbs / 127.0f : 1.0f;
+            layer.qscale[o] = scale;
+            for (int i = 0; i < layer.inputs; i++) {
+                layer.qweights[i * n + o] = static_cast<int8_t>(std::lround(layer.weights[i * n + o] / scale));
+            }
+        }
+    }
+}
+
+void Evaluator::evaluate(const float* features, int batch, float* values, float* priors) const {
+    thread_local std::vector<float> h1(MAX_BATCH * HIDDEN1);
+    thread_local std::vector<float> h2(MAX_BATCH * HIDDEN2);
+    thread_local std::vector<float> out(MAX_BATCH * NUM_OUTPUTS);
+    auto gemm = precision == INT8 ? gemmInt8 : gemmFloat;
+
+    for (int start = 0; start < batch; start += MAX_BATCH) {
+        int rows = std::min(MAX_BATCH, batch - start);
+        gemm(features + start * NUM_FEATURES, rows, layers[0], h1.data());
+        relu(h1.data(), rows * HIDDEN1);
+        gemm(h1.data(), rows, layers[1], h2.data());
+        relu(h2.data(), rows * HIDDEN2);
+        gemm(h2.data(), rows, layers[2], out.data());
+
+        for (int r = 0; r < rows; r++) {
+            const float* o = &out[r * NUM_OUTPUTS];
+            values[start + r] = std::tanh(o[0]);
+            if (priors) {
+                std::copy(o + 1, o + NUM_OUTPUTS, priors + (start + r) * Rules::NUM_ACTION_SLOTS);
+            }
+        }
+    }
+}
+
+float Evaluator::evaluate(const GameState& state, Rules::Side perspective) const {
+    float features[NUM_FEATURES];
+    float value;
+    extractFeatures(state, perspective, features);
+    evaluate(features, 1, &value);
+    return value;
+}
+
+float Evaluator::train(const float* features, const float* valueTargets, const int* actionTargets,
+                       int batch, float learningRate) {
+    batch = std::min(batch, MAX_BATCH);
+    std::vector<float> h1(batch * HIDDEN1), h2(batch * HIDDEN2), out(batch * NUM_OUTPUTS);
+    gemmFloat(features, batch, layers[0], h1.data());
+    relu(h1.data(), h1.size());
+    gemmFloat(h1.data(), batch, layers[1], h2.data());
+    relu(h2.data(), h2.size());
+    gemmFloat(h2.data(), batch, layers[2], out.data());
+
+    // Output gradient: tanh value head (MSE) + softmax policy head (cross-entropy)
+    std::vector<float> dOut(batch * NUM_OUTPUTS, 0.0f);
+    float loss = 0.0f;
+    for (int b = 0; b < batch; b++) {
+        float* o = &out[b * NUM_OUTPUTS];
+        float* d = &dOut[b * NUM_OUTPUTS];
+
+        float v = std::tanh(o[0]);
+        float err = v - valueTargets[b];
+        loss += err * err;
+        d[0] = 2.0f * err * (1.0f - v * v) / batch;
+
+        int target = actionTargets ? actionTargets[b] : -1;
+        if (target >= 0) {
+            float maxLogit = *std::max_element(o + 1, o + NUM_OUTPUTS);
+            float sum = 0.0f;
+            for (int a = 1; a < NUM_OUTPUTS; a++) sum += std::exp(o[a] - maxLogit);
+            for (int a = 1; a < NUM_OUTPUTS; a++) {
+                float p = std::exp(o[a] - maxLogit) / sum;
+                d[a] = (p - (a - 1 == target ? 1.0f : 0.0f)) / batch;
+                if (a - 1 == target) loss -= std::log(std::max(p, 1e-7f));
+            }
+        }
+    }
+
+    // Backpropagate layer by layer, updating weights with momentum as we go
+    const float* inputs[3] = {features, h1.data(), h2.data()};
+    std::vector<float> delta = std::move(dOut);
+    for (int l = 2; l >= 0; l--) {
+        Layer& layer = layers[l];
+        const int n = layer.outputs;
+        const int k = layer.inputs;
+        const float* in = inputs[l];
+
+        std::vector<float> prevDelta;
+        if (l > 0) {
+            prevDelta.assign(batch * k, 0.0f);
+            for (int b = 0; b < batch; b++) {
+                for (int i = 0; i < k; i++) {
+                    if (in[b * k + i] <= 0.0f) continue;  // ReLU gate
+                    float sum = 0.0f;
+                    const float* w = &layer.weights[i * n];
+                    for (int o = 0; o < n; o++) sum += w[o] * delta[b * n + o];
+                    prevDelta[b * k + i] = sum;
+                }
+            }
+        }
+
+        for (int i = 0; i < k; i++) {
+            for (int o = 0; o < n; o++) {
+                float grad = 0.0f;
+                for (int b = 0; b < batch; b++) grad += in[b * k + i] * delta[b * n + o];
+                float& vel = layer.velocity[i * n + o];
+                vel = 0.9f * vel - learningRate * grad;
+                layer.weights[i * n + o] += vel;
+            }
+        }
+        for (int o = 0; o < n; o++) {
+            float grad = 0.0f;
+            for (int b = 0; b < batch; b++) grad += delta[b * n + o];
+            float& vel = layer.velocity[k * n + o];
+            vel = 0.9f * vel - learningRate * grad;
+            layer.bias[o] += vel;
+        }
+
+        delta = std::move(prevDelta);
+    }
+
+    return loss / batch;
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include "rules.h"
+
+// Small MLP that scores positions for the AI: a value in [-1, 1] from one side's
+// point of view plus prior logits over Rules action slots. No external deps; the
+// forward pass runs a batch of leaf positions through blocked GEMM kernels, in
+// float (with AVX2/FMA when the CPU has them, checked at run time) or with
+// int8-quantized weights.
+class Evaluator {
+public:
+    static constexpr int NUM_FEATURES = 96;  // padded to a multiple of 16 lanes
+    static constexpr int HIDDEN1 = 64;
+    static constexpr int HIDDEN2 = 32;
+    static constexpr int NUM_OUTPUTS = 1 + Rules::NUM_ACTION_SLOTS;  // value + policy logits
+    static constexpr int MAX_BATCH = 256;
+
+    static constexpr const char* DEFAULT_WEIGHTS = "tensor_ai.bin";
+
+    enum Precision {
+        FLOAT32,
+        INT8
+    };
+
+    struct Layer {
+        int inputs = 0;
+        int outputs = 0;
+        std::vector<float> weights;   // [inputs][outputs] so the kernel streams contiguous outputs
+        std::vector<float> bias;
+        std::vector<int8_t> qweights; // same layout, per-output scale
+        std::vector<float> qscale;
+        std::vector<float> velocity;  // SGD momentum, only touched by train()
+    };
+
+    Evaluator();
+
+    // Side-relative encoding: perspective's field/hand first, opponent second
+    static void extractFeatures(const GameState& state, Rules::Side perspective, float* out);
+
+    void initRandom(std::mt19937& rng);
+    bool load(const std::string& path);
+    bool save(const std::string& path) const;
+
+    // Int8 inference needs quantize() after loading or training
+    void quantize();
+    void setPrecision(Precision p) { precision = p; }
+
+    // features: [batch][NUM_FEATURES]; values: [batch]; priors (optional): [batch][NUM_ACTION_SLOTS] logits
+    void evaluate(const float* features, int batch, float* values, float* priors = nullptr) const;
+    float evaluate(const GameState& state, Rules::Side perspective) const;
+
+    // One SGD step on value MSE + policy cross-entropy; actionTargets of -1 skip the policy loss.
+    // Returns the mean loss of the batch.
+    float train(const float* features, const float* valueTargets, const int* actionTargets,
+                int batch, float learningRate);
+
+private:
+    std::array<Layer, 3> layers;
+    Precision precision = FLOAT32;
+};
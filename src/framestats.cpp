@@ -0,0 +1,95 @@
+#include "framestats.h"
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+const char* const FrameStats::SECTION_NAMES[SECTION_COUNT] = {
+    "printGameState", "drawField", "drawHand", "drawTensorGauge", "refresh"
+};
+
+namespace {
+    bool collecting = false;
+    bool hud = false;
+    bool frameOpen = false;
+    FrameStats::Frame current;
+    FrameStats::Frame last;
+    uint64_t bytesAtStart = 0;
+
+    // Bytes this process has written so far (write(2) and friends), 0 where the OS doesn't say
+    uint64_t bytesWritten() {
+#ifdef __linux__
+        static int fd = open("/proc/self/io", O_RDONLY);
+        if (fd < 0) return 0;
+        char buffer[512];
+        ssize_t size = pread(fd, buffer, sizeof(buffer) - 1, 0);
+        if (size <= 0) return 0;
+        buffer[size] = '\0';
+        const char* wchar = std::strstr(buffer, "wchar:");
+        return wchar ? std::strtoull(wchar + 6, nullptr, 10) : 0;
+#else
+        return 0;
+#endif
+    }
+}
+
+bool FrameStats::enabled() {
+    return collecting;
+}
+
+void FrameStats::enable(bool on) {
+    collecting = on;
+    frameOpen = false;
+    if (!on) hud = false;
+}
+
+bool FrameStats::hudVisible() {
+    return hud;
+}
+
+void FrameStats::showHud(bool on) {
+    if (on) enable(true);
+    hud = on;
+}
+
+uint64_t FrameStats::now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void FrameStats::record(Section section, uint64_t nanos) {
+    current.nanos[section] += nanos;
+    current.calls[section]++;
+}
+
+void FrameStats::beginFrame() {
+    if (!collecting) return;
+    endFrame();
+    current = Frame{};
+    bytesAtStart = bytesWritten();
+    frameOpen = true;
+}
+
+void FrameStats::endFrame() {
+    if (!frameOpen) return;
+    current.bytes = bytesWritten() - bytesAtStart;
+    last = current;
+    frameOpen = false;
+}
+
+const FrameStats::Frame& FrameStats::lastFrame() {
+    return last;
+}
+
+void FrameStats::drawHud() {
+    if (!hud) return;
+    auto ms = [](uint64_t nanos) { return nanos / 1e6; };
+    char line[128];
+    int length = std::snprintf(line, sizeof(line), " frame %.2fms  field %.2f  hand %.2f  gauge %.2f  refresh %.2f  %llu B ",
+                               ms(last.nanos[PRINT_GAME_STATE]), ms(last.nanos[DRAW_FIELD]), ms(last.nanos[DRAW_HAND]),
+                               ms(last.nanos[DRAW_TENSOR_GAUGE]), ms(last.nanos[REFRESH]),
+                               static_cast<unsigned long long>(last.bytes));
+    attron(A_REVERSE);
+    mvprintw(0, std::max(1, COLS - length - 1), "%s", line);
+    attroff(A_REVERSE);
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include "game.h"
+
+// Frame timing for the curses front end.
+//
+// A frame starts with every GameState::printGameState() and runs until the
+// next one, so it covers the board, whatever menu is drawn over it and the
+// refreshes that send it to the terminal. The draw helpers time themselves
+// with a Timer. Bytes are what the process wrote to the terminal during the
+// frame; only Linux reports them (from /proc/self/io), elsewhere they read 0.
+// Everything is off until enable(), and a Timer is then one clock read each
+// way. The HUD (toggled with F in the action menu, or on from the start with
+// TENSOR_FRAME_HUD set) draws the last frame's numbers in the top border.
+namespace FrameStats {
+    enum Section : uint8_t {
+        PRINT_GAME_STATE,   // the whole board, including the sections below
+        DRAW_FIELD,
+        DRAW_HAND,
+        DRAW_TENSOR_GAUGE,
+        REFRESH,            // curses diffing the screen and writing it out
+        SECTION_COUNT
+    };
+
+    extern const char* const SECTION_NAMES[SECTION_COUNT];
+
+    struct Frame {
+        std::array<uint64_t, SECTION_COUNT> nanos{};
+        std::array<uint32_t, SECTION_COUNT> calls{};
+        uint64_t bytes = 0;
+    };
+
+    bool enabled();
+    void enable(bool on);
+    bool hudVisible();
+    void showHud(bool on);  // also enables collection
+
+    uint64_t now();  // steady clock, ns
+    void record(Section section, uint64_t nanos);
+
+    class Timer {
+    public:
+        explicit Timer(Section section) : section(section), start(enabled() ? now() : 0) {}
+        ~Timer() { if (start) record(section, now() - start); }
+        Timer(const Timer&) = delete;
+        Timer& operator=(const Timer&) = delete;
+
+    private:
+        Section section;
+        uint64_t start;
+    };
+
+    // Closes the frame in progress (if any) and starts the next
+    void beginFrame();
+    void endFrame();
+    const Frame& lastFrame();
+
+    void drawHud();
+}
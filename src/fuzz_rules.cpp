@@ -0,0 +1,125 @@
+// Fuzzing harness for the headless rules engine.
+//
+// Input bytes drive a whole match: the first four seed the deck shuffle and the
+// minigame rng, every following byte picks the next action. Bytes below 0xC0
+// choose among the legal actions (so inputs reach deep positions quickly); the
+// rest build a raw action from the next two bytes, which is usually illegal and
+// must leave the state untouched. After every step Rules::checkInvariants() has
+// to pass, otherwise the harness aborts with the broken invariant and the input
+// that found it.
+//
+//   libFuzzer: clang++ -std=c++20 -g -O1 -fsanitize=fuzzer,address,undefined -DTENSOR_LIBFUZZER ...
+//   AFL++:     afl-clang-fast++ -std=c++20 -O2 ...,  then afl-fuzz -i seeds -o findings -- ./fuzz_rules @@
+//   Built-in:  fuzz_rules [iterations] [seed]       (random byte streams, prints execs/s)
+//              fuzz_rules file...                   (replays saved inputs, e.g. crashes)
+
+#include "rules.h"
+#include "snapshot.h"
+#include <fstream>
+
+namespace {
+    constexpr size_t MAX_STEPS = 4096;  // a match never lasts this long; keeps huge inputs bounded
+
+    [[noreturn]] void fail(const char* what, const GameState& state, size_t step, const Rules::Action& action) {
+        std::cerr << "invariant broken after step " << step << ": " << what << "\n"
+                  << "  action type " << int(action.type) << " index " << int(action.index)
+                  << " target " << int(action.target) << "\n"
+                  << "  health " << state.playerHealth << "/" << state.enemyHealth
+                  << " energy " << state.playerEnergy << "/" << state.enemyEnergy
+                  << " tensor " << state.tensor.current << "/" << state.tensor.maximum << "\n";
+        std::abort();
+    }
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    if (size < 4) return 0;
+
+    thread_local std::vector<Rules::Action> actions;
+    thread_local std::vector<uint8_t> before, after;
+
+    uint32_t seed;
+    std::memcpy(&seed, data, sizeof(seed));
+    std::mt19937 rng(seed);
+    GameState state;
+    Rules::setupGame(state, rng);
+    if (const char* broken = Rules::checkInvariants(state)) {
+        fail(broken, state, 0, Rules::Action::endTurn());
+    }
+
+    size_t pos = 4;
+    for (size_t step = 1; pos < size && step <= MAX_STEPS && Rules::result(state) == Rules::ONGOING; step++) {
+        uint8_t byte = data[pos++];
+        Rules::Action action;
+        if (byte < 0xC0) {
+            Rules::legalActions(state, actions);
+            action = actions[byte % actions.size()];
+        } else {
+            action.type = static_cast<Rules::Action::Type>(byte % 3);
+            action.index = pos < size ? static_cast<int8_t>(data[pos++]) : 0;
+            action.target = pos < size ? static_cast<int8_t>(data[pos++]) : -1;
+        }
+
+        bool legal = Rules::isLegal(state, action);
+        if (!legal) {
+            Snapshot::write(state, nullptr, before);
+        }
+
+        Rules::Outcome outcome = Rules::apply(state, action);
+        if (outcome.legal != legal) {
+            fail("apply() and isLegal() disagree", state, step, action);
+        }
+        if (!legal) {
+            Snapshot::write(state, nullptr, after);
+            if (before != after) fail("illegal action changed the state", state, step, action);
+            continue;
+        }
+
+        if (const char* broken = Rules::checkInvariants(state, outcome.tensorPeak)) {
+            fail(broken, state, step, action);
+        }
+        if (outcome.tensorPeak) {
+            Rules::resolveTensorPeak(state, rng);
+            if (const char* broken = Rules::checkInvariants(state)) {
+                fail(broken, state, step, action);
+            }
+        }
+    }
+    return 0;
+}
+
+#ifndef TENSOR_LIBFUZZER
+int main(int argc, char** argv) {
+    // Replay mode: any non-numeric argument is an input file
+    if (argc > 1 && !std::isdigit(static_cast<unsigned char>(argv[1][0]))) {
+        for (int i = 1; i < argc; i++) {
+            std::ifstream file(argv[i], std::ios::binary);
+            if (!file) {
+                std::cerr << "Cannot open " << argv[i] << "\n";
+                return 1;
+            }
+            std::vector<uint8_t> input((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+            LLVMFuzzerTestOneInput(input.data(), input.size());
+        }
+        std::cout << "Replayed " << argc - 1 << " input(s) cleanly\n";
+        return 0;
+    }
+
+    uint64_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+    uint32_t seed = argc > 2 ? static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10)) : 1;
+
+    std::mt19937 rng(seed);
+    std::vector<uint8_t> input;
+    uint64_t bytes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < iterations; i++) {
+        input.resize(4 + rng() % 512);
+        for (auto& byte : input) byte = static_cast<uint8_t>(rng());
+        bytes += input.size();
+        LLVMFuzzerTestOneInput(input.data(), input.size());
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << iterations << " inputs (" << bytes << " bytes) in " << std::fixed << std::setprecision(2)
+              << seconds << "s, " << std::setprecision(0) << iterations / seconds << " execs/s, no invariant broken\n";
+    return 0;
+}
+#endif
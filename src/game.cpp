@@ -1,9 +1,40 @@
 #include "game.h"
+#include "evaluator.h"
+#include "solver.h"
+#include "snapshot.h"
+#include "ponder.h"
+#include "turnflow.h"
+#include "mcts.h"
+#include "book.h"
+#include "difficulty.h"
+#include "framestats.h"
 
 // Game class implementation
 Game::Game() : rng(std::chrono::steady_clock::now().time_since_epoch().count()) {
     initializeUI();
     GameUI::initializeAllColors();  // Initialize all colors at once
+
+    // Hints use the learned evaluator only when trainer output is present
+    evaluator = std::make_unique<Evaluator>();
+    if (!evaluator->load(Evaluator::DEFAULT_WEIGHTS)) {
+        evaluator.reset();
+    }
+    ponderer = std::make_unique<Ponderer>(evaluator.get());
+
+    // Likewise the book, which bookgen writes
+    book = std::make_unique<Book::Table>();
+    if (!book->open(Book::DEFAULT_PATH)) {
+        book.reset();
+    }
+
+    // A missing or unreadable profile just means Normal
+    profile = std::make_unique<Difficulty::Profile>();
+    if (!profile->load(Difficulty::DEFAULT_PATH)) {
+        *profile = Difficulty::Profile{};
+    }
+    enemyAgent = std::make_unique<MctsAgent>();
+    applyDifficulty();
+
     initializeGame();
 }
 
@@ -23,81 +54,168 @@ void Game::cleanupUI() {
 
 void Game::initializeGame()
 {
-    state.initializeDeck();
-    state.playerEnergy = 1;
-    state.enemyEnergy = 1;
-    
-    // Draw initial hands
-    for(int i = 0; i < 5; i++)
-    {
-        drawCard(state.playerHand);
-        drawCard(state.enemyHand);
-    }
+    // Shuffled deck, five cards each, one energy each
+    Rules::setupGame(state, rng);
 }
 
 void Game::run() {
-    std::vector<std::string> mainMenuOptions = {
-        "Start Game",
-        "Practice Minigames",
-        "Quit"
-    };
-    
     bool running = true;
     while(running) {
+        std::vector<std::string> mainMenuOptions = {
+            "Start Game",
+            "Resume Saved Game",
+            std::string("Difficulty: ") + Difficulty::name(profile->level),
+            "Spectate AI vs AI",
+            "Play Online",
+            "Practice Minigames",
+            "Quit"
+        };
+
         int choice = showMenu(mainMenuOptions, "TENSOR CONCORD");
         switch(choice) {
             case 0: playMainGame(); break;
-            case 1: playMinigameMenu(); break;
-            case 2: /* fallthrough */
+            case 1: resumeSavedGame(); break;
+            case 2: chooseDifficulty(); break;
+            case 3: playSpectatorMatch(); break;
+            case 4: playOnlineMatch(); break;
+            case 5: playMinigameMenu(); break;
+            case 6: /* fallthrough */
             case -1: running = false; break;
         }
     }
 }
 
-// Rename the original run() to:
+void Game::chooseDifficulty() {
+    std::vector<std::string> options;
+    for (int level = Difficulty::EASY; level < Difficulty::ADAPTIVE; level++) {
+        char label[40];
+        snprintf(label, sizeof(label), "%-8s %5d ms", Difficulty::name(static_cast<Difficulty::Level>(level)),
+                 Difficulty::BUDGETS[level].milliseconds);
+        options.push_back(label);
+    }
+    char adaptive[40];
+    snprintf(adaptive, sizeof(adaptive), "%-8s %5d ms", Difficulty::name(Difficulty::ADAPTIVE),
+             Difficulty::budgetAt(profile->rating).milliseconds);
+    options.push_back(adaptive);
+
+    int choice = showMenu(options, "Enemy Thinking Time");
+    if (choice < 0) {
+        return;
+    }
+    profile->level = static_cast<Difficulty::Level>(choice);
+    profile->save(Difficulty::DEFAULT_PATH);
+    applyDifficulty();
+}
+
+void Game::applyDifficulty() {
+    Difficulty::Budget budget = profile->budget();
+    Mcts::Options options;
+    options.iterations = budget.playouts;
+    options.milliseconds = budget.milliseconds;
+    options.threads = static_cast<int>(std::clamp(std::thread::hardware_concurrency(), 1u, 8u));
+    options.seed = rng();
+    enemyAgent->setOptions(options);
+    ponderer->setReplyOptions(options);  // replies pondered for the enemy get the same budget
+    enemyAgent->setBook(budget.book ? book.get() : nullptr);
+}
+
+void Game::resumeSavedGame() {
+    if (!Snapshot::loadFile(Snapshot::DEFAULT_SAVE, state, &rng)) {
+        clear();
+        box(stdscr, 0, 0);
+        mvprintw(LINES/2, (COLS-30)/2, "No valid saved game found");
+        refresh();
+        napms(1500);
+        return;
+    }
+    playMainGame();
+}
+
+// The order of play lives in TurnFlow::play(); this loop only answers whatever it asks next
 void Game::playMainGame() {
-    int selectedAction = 0;
-    bool running = true;
-    
     clear();
     box(stdscr, 0, 0);
     mvprintw(LINES/2, (COLS-20)/2, "Welcome to Tensor Concord!");
     refresh();
     napms(2000);
-    
-    while(running && !isGameOver()) {
+
+    applyDifficulty();  // the adaptive budget may have moved since the last match
+    TurnFlow::Match match = TurnFlow::play(state);
+    while(!match.done()) {
         state.printGameState();
-        
-        if(state.isPlayerTurn) {
-            GameUI::drawActionMenu(selectedAction);
-            GameUI::drawStatusBar("Your turn - Choose an action");
-            GameUI::drawNavigationHints();
-            refresh();
-
-            int ch = getch();
-            switch(ch) {
-                case KEY_LEFT:
-                    selectedAction = (selectedAction > 0) ? selectedAction - 1 : GameUI::ACTION_QUIT;
-                    break;
-                case KEY_RIGHT:
-                    selectedAction = (selectedAction < GameUI::ACTION_QUIT) ? selectedAction + 1 : 0;
-                    break;
-                case '\n':
-                    handleAction(selectedAction);
-                    break;
-                case 27: // ESC
-                    if(promptYesNo("Quit game?")) {
-                        running = false;
-                    }
-                    break;
+
+        const TurnFlow::Request& request = match.request();
+        if(request.type == TurnFlow::TENSOR_PEAK) {
+            match.resolvePeak(playTensorPeak());
+        } else if(request.side == Rules::PLAYER) {
+            // Analyse the position for hints and enemy replies while the player thinks; a no-op if nothing changed
+            ponderer->ponder(state);
+
+            std::optional<Rules::Action> action = choosePlayerAction();
+            if(!action) {
+                break;
             }
+            executePlayerAction(match, *action);
         } else {
-            performEnemyTurn();
+            ponderer->cancel();  // the enemy's thinking time is its difficulty, so it gets the machine; cached replies stay
+            executeEnemyAction(match, chooseEnemyAction(match));
+        }
+    }
+    ponderer->cancel();
+    if (Rules::result(state) != Rules::ONGOING) {
+        profile->record(Rules::result(state));
+        profile->save(Difficulty::DEFAULT_PATH);
+    }
+    isGameOver();
+}
+
+std::optional<Rules::Action> Game::choosePlayerAction() {
+    while(Rules::result(state) == Rules::ONGOING) {
+        state.printGameState();
+        GameUI::drawActionMenu(selectedAction);
+        GameUI::drawStatusBar("Your turn - Choose an action");
+        GameUI::drawNavigationHints();
+        refresh();
+
+        int ch = getch();
+        switch(ch) {
+            case KEY_LEFT:
+                selectedAction = (selectedAction > 0) ? selectedAction - 1 : GameUI::ACTION_QUIT;
+                break;
+            case KEY_RIGHT:
+                selectedAction = (selectedAction < GameUI::ACTION_QUIT) ? selectedAction + 1 : 0;
+                break;
+            case '\n':
+                if(std::optional<Rules::Action> action = handleAction(selectedAction)) {
+                    return action;
+                }
+                break;
+            case 'h':
+            case 'H':
+                showHint();
+                break;
+            case 'f':
+            case 'F':
+                FrameStats::showHud(!FrameStats::hudVisible());
+                break;
+            case 's':
+            case 'S':
+                GameUI::drawStatusBar(Snapshot::saveFile(Snapshot::DEFAULT_SAVE, state, &rng)
+                                      ? "Game saved" : "Could not write save file");
+                refresh();
+                napms(1000);
+                break;
+            case 27: // ESC
+                if(promptYesNo("Quit game?")) {
+                    return std::nullopt;
+                }
+                break;
         }
     }
+    return std::nullopt;  // conceded from the menu
 }
 
-void Game::handleAction(int action) {
+std::optional<Rules::Action> Game::handleAction(int action) {
     switch(action) {
         case GameUI::ACTION_PLAY:
             if(!state.playerHand.empty()) {
@@ -105,14 +223,14 @@ void Game::handleAction(int action) {
                 const size_t cardsPerPage = 4;
                 while(true) {
                     state.printGameState();
-                    GameUI::drawHand(stdscr, LINES-8, 2, state.playerHand, selected);
+                    GameUI::drawHand(stdscr, LINES-8, 2, state.cards, state.playerHand, selected);
                     
                     // Show card details at the bottom
-                    const auto& selectedCard = state.playerHand[selected];
+                    Card::Type selectedType = state.cards.type[state.playerHand[selected]];
                     std::string details;
-                    if (selectedCard.type == Card::CHAMPION) {
+                    if (selectedType == Card::CHAMPION) {
                         details = "Champion - Can attack enemy or enemy champions";
-                    } else if (selectedCard.type == Card::ARTIFACT) {
+                    } else if (selectedType == Card::ARTIFACT) {
                         details = "Artifact - Buffs champion's ATK or HP";
                     } else {
                         details = "Tensor - Provides immediate energy";
@@ -129,10 +247,9 @@ void Game::handleAction(int action) {
                             selected = (selected < state.playerHand.size() - 1) ? selected + 1 : 0;
                             break;
                         case '\n':
-                            playCardFromHand(selected);
-                            return;
+                            return playCardFromHand(selected);
                         case 27:
-                            return;
+                            return std::nullopt;
                     }
                 }
             }
@@ -140,31 +257,25 @@ void Game::handleAction(int action) {
 
         case GameUI::ACTION_ATTACK:
             if(!state.playerField.empty()) {
-                // Check if there are any available attackers first
-                bool hasAvailableAttackers = false;
-                for(const auto& card : state.playerField) {
-                    if(!card.hasAttackedThisTurn && card.turnsInPlay > 0) {
-                        hasAvailableAttackers = true;
-                        break;
-                    }
-                }
-
-                if(!hasAvailableAttackers) {
+                // Ready attackers as a bitboard; the selection only ever lands on a set bit
+                uint8_t ready = Rules::fieldMasks(state, Rules::PLAYER).ready;
+                if(!ready) {
                     GameUI::drawStatusBar("No champions available to attack!");
                     refresh();
                     napms(1500);
-                    return;
+                    return std::nullopt;
                 }
 
-                int selected = 0;
+                const int slots = static_cast<int>(MAX_FIELD_SIZE);
+                int selected = std::countr_zero(ready);
                 while(true) {
                     state.printGameState();
                     
                     // Highlight available attackers
-                    for(size_t i = 0; i < state.playerField.size(); i++) {
-                        const auto& card = state.playerField[i];
-                        bool canAttack = !card.hasAttackedThisTurn && card.turnsInPlay > 0;
-                        GameUI::drawCard(stdscr, LINES/2+2, 2 + (i * 10), card, i == selected && canAttack);
+                    for(int i = 0; i < slots; i++) {
+                        if(!state.playerField.occupied(i)) continue;
+                        bool canAttack = ready >> i & 1;
+                        GameUI::drawCard(stdscr, LINES/2+2, 2 + (i * 10), state.cards.get(state.playerField[i]), i == selected && canAttack);
                     }
 
                     GameUI::drawStatusBar("Select attacker (Left/Right to choose, Enter to select, ESC to cancel)");
@@ -174,32 +285,28 @@ void Game::handleAction(int action) {
                     switch(ch) {
                         case KEY_LEFT:
                             do {
-                                selected = (selected > 0) ? selected - 1 : state.playerField.size() - 1;
-                            } while(state.playerField[selected].hasAttackedThisTurn || 
-                                   state.playerField[selected].turnsInPlay == 0);
+                                selected = (selected > 0) ? selected - 1 : slots - 1;
+                            } while(!(ready >> selected & 1));
                             break;
                         case KEY_RIGHT:
                             do {
-                                selected = (selected < state.playerField.size() - 1) ? selected + 1 : 0;
-                            } while(state.playerField[selected].hasAttackedThisTurn || 
-                                   state.playerField[selected].turnsInPlay == 0);
+                                selected = (selected < slots - 1) ? selected + 1 : 0;
+                            } while(!(ready >> selected & 1));
                             break;
                         case '\n':
-                            if(!state.playerField[selected].hasAttackedThisTurn && 
-                               state.playerField[selected].turnsInPlay > 0) {
-                                attackWithCard(selected);
-                                return;
-                            }
-                            break;
+                            return attackWithCard(selected);
                         case 27:
-                            return;
+                            return std::nullopt;
                     }
                 }
             }
             break;
 
         case GameUI::ACTION_END:
-            endPlayerTurn();
+            return Rules::Action::endTurn();
+
+        case GameUI::ACTION_HINT:
+            showHint();
             break;
 
         case GameUI::ACTION_HELP:
@@ -212,68 +319,74 @@ void Game::handleAction(int action) {
             }
             break;
     }
+    return std::nullopt;
 }
 
-bool Game::promptYesNo(const std::string& question) {
-    GameUI::drawStatusBar(question + " (Y/N)");
-    refresh();
-    
-    while(true) {
-        int ch = getch();
-        if(tolower(ch) == 'y') {
-            return true;
-        } else if(tolower(ch) == 'n') {
-            return false;
+namespace {
+    // "Hint (62%, 16000 playouts): Play ..., Attack ..., End turn"
+    std::string describeHint(const GameState& state, const Ponderer::Hint& hint) {
+        std::string text = "Hint";
+        if (hint.playouts > 0) {
+            text += " (" + std::to_string(static_cast<int>(std::lround(hint.score * 100))) + "%, " +
+                    std::to_string(hint.playouts) + " playouts)";
+        }
+        text += hint.final ? ":" : ", refining:";
+
+        // Replay the plan on a scratch copy so every index refers to the state it applies to
+        GameState scratch = state;
+        for (const auto& action : hint.actions) {
+            text += " " + GameUI::describeAction(scratch, action);
+            text += action.type == Rules::Action::END_TURN ? "" : ",";
+            Rules::apply(scratch, action);
+        }
+        // A plan that fills the tensor gauge stops there: the minigame decides the rest
+        if (!hint.actions.empty() && hint.actions.back().type != Rules::Action::END_TURN) {
+            text += " then the tensor peak";
         }
+        return text;
     }
 }
 
-void Game::endPlayerTurn() {
-    for (auto& champ : state.playerField) {
-        if (champ.type == Card::CHAMPION) {
-            if (champ.turnsInPlay == 0) {
-                champ.turnsInPlay = 1;
-            }
-            champ.hasAttackedThisTurn = false;  // Reset attack flag
-        }
+// The analysis began with the player's decision (see Ponderer); this only shows it,
+// replacing the first answer with each deeper one until a key is pressed
+void Game::showHint() {
+    ponderer->ponder(state);  // a no-op unless something changed since the decision began
+    Ponderer::Hint hint;
+    if (!ponderer->waitHint(state, 0, std::chrono::milliseconds(HINT_FIRST_WAIT_MS), hint)) {
+        // Not there in time: the turn solver alone takes well under a millisecond
+        TurnSolver solver(evaluator.get());
+        hint = Ponderer::Hint{};
+        hint.actions = solver.solve(state).actions;
+        hint.final = true;
     }
 
-    // Check for Virtu-Machina synergy effects at turn end
-    int vmCount = 0;
-    for (const auto& card : state.playerField) {
-        if (card.type == Card::CHAMPION && card.faction == Card::Faction::VIRTU_MACHINA) {
-            vmCount++;
+    while(true) {
+        GameUI::drawStatusBar(describeHint(state, hint));
+        refresh();
+        if(hint.final) {
+            getch();
+            return;
         }
+        timeout(HINT_POLL_MS);
+        int ch = getch();
+        timeout(-1);
+        if(ch != ERR) {
+            return;
+        }
+        ponderer->waitHint(state, hint.revision, std::chrono::milliseconds(0), hint);
     }
-    
-    if (vmCount >= 2) {  // If VM synergy is active
-        int synergyLevel = calculateSynergyLevel(state.playerField, Card::Faction::VIRTU_MACHINA);
-        state.playerEnergy += synergyLevel;  // Energy buff
-        increaseTensorGauge(1);  // Tensor increase from VM synergy
-    }
-
-    state.isPlayerTurn = false;
-    state.playerEnergy += 1;
-    drawCard(state.playerHand);
-    checkAndApplySynergies(state.playerField, state.playerHand);  // Recheck synergies
+}
 
-    mvprintw(LINES-1, 2, "Ending your turn...");
+bool Game::promptYesNo(const std::string& question) {
+    GameUI::drawStatusBar(question + " (Y/N)");
     refresh();
-    napms(1500);
     
-    // Check for tensor peak before enemy turn
-    if (state.tensor.current >= state.tensor.maximum) {
-        handleTensorPeak();
+    while(true) {
+        int ch = getch();
+        if(tolower(ch) == 'y') {
+            return true;
+        } else if(tolower(ch) == 'n') {
+            return false;
+        }
     }
-    
-    performEnemyTurn();
-}
-
-// Remove these duplicate function implementations since they exist in their respective files
-/* void Game::performEnemyTurn() {
-    // Remove this stub implementation - real one is in ai.cpp
 }
-
-void Game::playCardFromHand(int cardIndex) {
-    // Remove this stub implementation - real one is in card.cpp
-} */
\ No newline at end of file
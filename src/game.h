@@ -2,8 +2,11 @@
 
 #include <iostream>
 #include <string>
+#include <string_view>
+#include <cstdint>
 #include <cstring>
 #include <vector>
+#include <deque>
 #include <random>
 #include <algorithm>
 #include <chrono>
@@ -11,8 +14,12 @@
 #include <sstream>
 #include <thread>
 #include <map>
+#include <unordered_map>
 #include <array>
 #include <set>
+#include <memory>
+#include <optional>
+#include <bit>
 // Using PDCurses on windows, please follow README.md for instructions if compilation does not work
 #include <curses.h>
 // #include "gameui.h"  // do NOT make this header, it will break things...
@@ -21,17 +28,44 @@ struct Card;
 struct GameState;
 class Game;
 class GameUI;
+class Evaluator;
+class Ponderer;
+class MctsAgent;
+namespace Rules { struct Action; }
+namespace TurnFlow { class Match; struct PeakResult; }
+namespace Book { class Table; }
+namespace Difficulty { class Profile; }
+namespace Minigames { enum Id : uint8_t; }
+
+constexpr size_t MAX_FIELD_SIZE = 4;
+
+// Process-wide string table for card names, filled while building the deck and compiling
+// effect scripts. Interning is serialised; get() and count() never block, so names can be
+// added (e.g. by an effect reload) while matches on other threads read them.
+struct CardNames
+{
+    static constexpr uint16_t CAPACITY = 4096;
+    static constexpr uint16_t INVALID = 0xFFFF;  // intern() once the table is full
+
+    static uint16_t intern(const char* name);
+    static const char* get(uint16_t id);
+    static size_t count();
+
+    // Interns every deck card's name, so their ids don't depend on what was interned before.
+    // Effects::load calls it before a script can intern names of its own.
+    static void seedCatalogue();
+};
 
 struct Card
 {
-    enum Type
+    enum Type : uint8_t
     {
         CHAMPION,
         ARTIFACT,
         TENSOR
     } type;
 
-    enum Faction {
+    enum Faction : uint8_t {
         FACTION_NONE,    // Changed from NONE to FACTION_NONE
         TECHNO,      // ATK buff
         CYBER,       // HP buff
@@ -39,7 +73,7 @@ struct Card
         VIRTU_MACHINA // Energy + Tensor
     } faction = FACTION_NONE;
 
-    enum Role {
+    enum Role : uint8_t {
         ROLE_NONE,      // Changed from NONE to ROLE_NONE
         MERC,
         NOMAD,
@@ -47,7 +81,7 @@ struct Card
         MAGE
     } role = ROLE_NONE;
 
-    std::string name;
+    uint16_t nameId;     // Index into CardNames, cards never own their name string
     int cost;
     int attack;
     int health;
@@ -58,40 +92,227 @@ struct Card
     int originalHealth;
     bool hasSynergyBuff = false;
 
+    // Display names indexed by the Faction/Role enums
+    static constexpr std::string_view FACTION_NAMES[] = {"None", "Techno", "Cyber", "Exec", "Virtu-Machina"};
+    static constexpr std::string_view ROLE_NAMES[] = {"None", "Merc", "Nomad", "Corpo", "Mage"};
+
     // Add constructors with default values
-    Card(Type t, const std::string& n, int c, int atk, int hp, int eff) :
-        type(t), name(n), cost(c), attack(atk), health(hp), effect(eff),
+    Card(Type t, const char* n, int c, int atk, int hp, int eff) :
+        Card(t, CardNames::intern(n), c, atk, hp, eff) {}
+
+    // For already-interned names (snapshots, pools), skips the table lookup
+    Card(Type t, uint16_t id, int c, int atk, int hp, int eff) :
+        type(t), faction(FACTION_NONE), role(ROLE_NONE), nameId(id),
+        cost(c), attack(atk), health(hp), effect(eff), turnsInPlay(0), hasAttackedThisTurn(false),
         originalAttack(atk), originalHealth(hp),  // Initialize original stats
-        faction(FACTION_NONE), role(ROLE_NONE), turnsInPlay(0), 
-        hasAttackedThisTurn(false), hasSynergyBuff(false) {}
+        hasSynergyBuff(false) {}
+
+    const char* name() const { return CardNames::get(nameId); }
+    std::string_view factionName() const { return FACTION_NAMES[static_cast<int>(faction)]; }
+    std::string_view roleName() const { return ROLE_NAMES[static_cast<int>(role)]; }
 
     // Factory methods now use the constructor
-    static Card createChampion(const std::string& name, int cost, int attack, int health) {
+    static Card createChampion(const char* name, int cost, int attack, int health) {
         return Card(CHAMPION, name, cost, attack, health, 0);
     }
 
-    static Card createTensor(const std::string& name, int cost, int energyAmount) {
+    static Card createTensor(const char* name, int cost, int energyAmount) {
         return Card(TENSOR, name, cost, 0, 0, energyAmount);
     }
 
-    static Card createArtifact(const std::string& name, int cost, int effectValue) {
+    static Card createArtifact(const char* name, int cost, int effectValue) {
         return Card(ARTIFACT, name, cost, 0, 0, effectValue);
     }
 };
 
+// Every card of a match lives in the state's CardPool, addressed by an 8-bit
+// handle; the deck, hands and fields only hold handles, so drawing, playing
+// and destroying a card moves one byte. The pool stores cards by column
+// (structure of arrays, one byte per stat) so a state copy is a few flat
+// arrays and rules that sweep one stat over many cards read it contiguously.
+// A dealt match's pool is the deck in build order, so a card's handle is
+// also its build index. Card stays the by-value form for building decks and
+// for display; get() assembles one from the columns.
+using CardHandle = uint8_t;
+
+struct CardPool
+{
+    static constexpr size_t CAPACITY = 64;
+
+    // Printed, fixed once the card is in the pool
+    std::array<uint16_t, CAPACITY> nameId{};
+    std::array<Card::Type, CAPACITY> type{};
+    std::array<Card::Faction, CAPACITY> faction{};
+    std::array<Card::Role, CAPACITY> role{};
+    std::array<int8_t, CAPACITY> originalAttack{};
+    std::array<int8_t, CAPACITY> originalHealth{};
+    // Changed by play
+    std::array<int8_t, CAPACITY> cost{};
+    std::array<int8_t, CAPACITY> attack{};
+    std::array<int8_t, CAPACITY> health{};
+    std::array<int8_t, CAPACITY> effect{};
+    std::array<int8_t, CAPACITY> turnsInPlay{};
+    std::array<uint8_t, CAPACITY> attacked{};  // hasAttackedThisTurn
+    std::array<uint8_t, CAPACITY> buffed{};    // hasSynergyBuff
+    uint8_t size = 0;
+
+    bool full() const { return size == CAPACITY; }
+    void clear() { size = 0; }
+
+    // The caller checks full() first
+    CardHandle add(const Card& card) {
+        CardHandle h = size++;
+        set(h, card);
+        return h;
+    }
+
+    void set(CardHandle h, const Card& card) {
+        nameId[h] = card.nameId;
+        type[h] = card.type;
+        faction[h] = card.faction;
+        role[h] = card.role;
+        originalAttack[h] = static_cast<int8_t>(card.originalAttack);
+        originalHealth[h] = static_cast<int8_t>(card.originalHealth);
+        cost[h] = static_cast<int8_t>(card.cost);
+        attack[h] = static_cast<int8_t>(card.attack);
+        health[h] = static_cast<int8_t>(card.health);
+        effect[h] = static_cast<int8_t>(card.effect);
+        turnsInPlay[h] = static_cast<int8_t>(card.turnsInPlay);
+        attacked[h] = card.hasAttackedThisTurn;
+        buffed[h] = card.hasSynergyBuff;
+    }
+
+    Card get(CardHandle h) const {
+        Card card(type[h], nameId[h], cost[h], attack[h], health[h], effect[h]);
+        card.faction = faction[h];
+        card.role = role[h];
+        card.originalAttack = originalAttack[h];
+        card.originalHealth = originalHealth[h];
+        card.turnsInPlay = turnsInPlay[h];
+        card.hasAttackedThisTurn = attacked[h];
+        card.hasSynergyBuff = buffed[h];
+        return card;
+    }
+
+    const char* name(CardHandle h) const { return CardNames::get(nameId[h]); }
+};
+
+// A side's champions in MAX_FIELD_SIZE fixed slots. A champion keeps its slot
+// from the turn it is played until it is destroyed, so action indices and
+// targets stay valid while other champions come and go. Removing one only
+// clears its bit in the live mask (the old handle stays behind as a tombstone
+// until place() reuses the slot), and place() takes the lowest free slot.
+// Iterating visits the live champions' handles in slot order; index with
+// operator[] only after checking occupied().
+class Field
+{
+public:
+    class Iterator {
+    public:
+        Iterator(const CardHandle* slots, unsigned remaining) : slots(slots), remaining(remaining) {}
+        CardHandle operator*() const { return slots[std::countr_zero(remaining)]; }
+        Iterator& operator++() { remaining &= remaining - 1; return *this; }
+        bool operator==(const Iterator& other) const { return remaining == other.remaining; }
+        bool operator!=(const Iterator& other) const { return remaining != other.remaining; }
+
+    private:
+        const CardHandle* slots;
+        unsigned remaining;
+    };
+
+    bool occupied(int slot) const { return slot >= 0 && slot < static_cast<int>(MAX_FIELD_SIZE) && (live >> slot & 1); }
+    uint8_t liveMask() const { return live; }
+    int count() const { return std::popcount(live); }
+    bool empty() const { return live == 0; }
+    bool full() const { return live == FULL; }
+
+    CardHandle operator[](int slot) const { return slots[slot]; }
+
+    // Lowest free slot; the caller checks full() first
+    int place(CardHandle card) {
+        int slot = std::countr_one(live);
+        place(slot, card);
+        return slot;
+    }
+    void place(int slot, CardHandle card) {
+        slots[slot] = card;
+        live |= uint8_t(1u << slot);
+    }
+    void remove(int slot) { live &= uint8_t(~(1u << slot)); }
+    void clear() { live = 0; }
+
+    Iterator begin() const { return {slots.data(), live}; }
+    Iterator end() const { return {slots.data(), 0}; }
+
+private:
+    static constexpr uint8_t FULL = (1u << MAX_FIELD_SIZE) - 1;
+    std::array<CardHandle, MAX_FIELD_SIZE> slots{};
+    uint8_t live = 0;
+};
+
+// The game's tunable constants. The engine reads them through GameState::rules,
+// so balance sweeps can play variants side by side on any number of threads.
+// The defaults are the game as shipped (STANDARD, a constant expression the
+// engine compiles against, see Rules::Standard), and everything outside the
+// engine assumes them: the curses UI and minigames, the evaluator's feature
+// scaling, saved games and the network protocol.
+struct RuleSet
+{
+    // A tensor peak's stake: the player wins or loses this much health or energy
+    struct Stake {
+        bool health = false;
+        int value = 0;
+    };
+    static constexpr size_t MAX_STAKES = 8;
+    static constexpr int MAX_TENSOR = 15;  // highest gauge maximum a variant may use
+
+    int startingHealth = 10;   // also the most a peak can heal to
+    int startingEnergy = 1;
+    int startingHand = 5;
+    int tensorStart = 3;       // gauge maximum at the start
+    int tensorCap = 7;         // the maximum grows by one per peak up to this
+    int concordiaAttack = 3;   // read by the concordia script as concordia_attack
+    int concordiaHealth = 3;
+    int synergyCards = 2;      // champions of one faction on the field for synergy level 1
+    int synergyMaxLevel = 3;
+    int fieldSize = MAX_FIELD_SIZE;
+    int champions = 37;        // deck composition
+    int artifacts = 8;
+    int tensors = 5;
+    std::array<Stake, MAX_STAKES> stakes = {{{false, 2}, {true, 1}, {false, 3}, {true, 2}, {false, 1}}};
+    int stakeCount = 5;
+
+    static const RuleSet STANDARD;
+
+    int deckSize() const { return champions + artifacts + tensors; }
+    int synergyLevel(int count) const { return std::min(count - synergyCards + 1, synergyMaxLevel); }
+
+    // Why this variant can't be played, or nullptr
+    const char* validate() const;
+};
+
+inline constexpr RuleSet RuleSet::STANDARD{};
+
 struct GameState
 {
+    const RuleSet* rules = &RuleSet::STANDARD;  // set by Rules::setupGame, never owned
     int playerHealth = 10;
     int enemyHealth = 10;
     int playerEnergy = 1;
     int enemyEnergy = 1;
     bool isPlayerTurn = true;
     
-    std::vector<Card> deck;
-    std::vector<Card> playerHand;
-    std::vector<Card> enemyHand;
-    std::vector<Card> playerField;
-    std::vector<Card> enemyField;
+    CardPool cards;
+    std::vector<CardHandle> deck;
+    // Lazy deck: deck stays in build order and Rules::drawCard() samples the
+    // next card from drawState, so a shuffle costs one draw's worth of work
+    // per card actually drawn instead of the whole deck up front
+    bool lazyDeck = false;
+    uint64_t drawState = 0;
+    std::vector<CardHandle> playerHand;
+    std::vector<CardHandle> enemyHand;
+    Field playerField;
+    Field enemyField;
 
     struct TensorState {
         int current = 0;
@@ -100,7 +321,7 @@ struct GameState
         static const int RAINBOW_COLORS[7];
     } tensor;
     
-    void initializeDeck();
+    void initializeDeck(std::mt19937& rng, bool lazy = false);  // the deck and gauge *rules asks for
     void printGameState() const;
 };
 
@@ -110,6 +331,15 @@ private:
     GameState state;
     std::mt19937 rng;
     WINDOW* mainwin;  // Main window for the game
+    std::unique_ptr<Evaluator> evaluator;  // Learned value/policy net for hints, empty if no weights file
+    std::unique_ptr<Ponderer> ponderer;    // Hints and enemy replies on the player's time, declared after evaluator so it is destroyed first
+    std::unique_ptr<Book::Table> book;     // Opening book and endgame tablebase, empty if no book file
+    std::unique_ptr<Difficulty::Profile> profile;  // Chosen difficulty and adaptive rating, saved between sessions
+    std::unique_ptr<MctsAgent> enemyAgent;  // Answers the match's enemy requests within the difficulty's budget
+    int selectedAction = 0;                // Action menu cursor, kept between player decisions
+
+    static constexpr int HINT_FIRST_WAIT_MS = 100;  // longest a hint may take to appear
+    static constexpr int HINT_POLL_MS = 50;         // how often a shown hint looks for a refinement
 
 public:
     Game();
@@ -124,38 +354,38 @@ private:
     void displayMenu();
     void handleKeyboardInput();
     void initializeGame();
-    void drawCard(std::vector<Card>& hand);
     void handleCommand(const std::string& cmd);
-    void playCardFromHand(int cardIndex);
-    void attackWithCard(int cardIndex);
-    void endPlayerTurn();
-    void performEnemyTurn();
-    void playEnemyCard(int cardIndex);
+
+    // The match itself runs in TurnFlow::play(); these answer its requests and narrate the results
+    std::optional<Rules::Action> choosePlayerAction();  // empty when the player leaves the match
+    std::optional<Rules::Action> handleAction(int action);
+    std::optional<Rules::Action> playCardFromHand(int cardIndex);
+    std::optional<Rules::Action> attackWithCard(int cardIndex);
+    void executePlayerAction(TurnFlow::Match& match, const Rules::Action& action);
+    Rules::Action chooseEnemyAction(const TurnFlow::Match& match);
+    void executeEnemyAction(TurnFlow::Match& match, const Rules::Action& action);
+    void showHint();
     void printHelp() const;
     void showHelpMenu() const;
     bool isGameOver() const;
-    void handleAction(int action);  // Add these new method declarations
-    bool promptYesNo(const std::string& question);  // Add these new method declarations
-
-    // Add minigame methods
-    bool playCoinToss();
-    bool playHighLow();
-    bool playRoulette();
-    bool playDiceRoll();
-    bool playRPS();
-    void applyMinigameConsequence(bool won);
-
-    // Update synergy method calls to include hand parameter
-    void checkAndApplySynergies(std::vector<Card>& field, std::vector<Card>& hand);
-    int calculateSynergyLevel(const std::vector<Card>& field, Card::Faction faction);
-    void applySynergyEffects(std::vector<Card>& field, std::vector<Card>& hand, Card::Faction faction, int level);
-
-    // Add tensor-related checks to these methods
-    void increaseTensorGauge(int amount);
-    void handleTensorPeak();
-    void resetTensorGauge();
+    bool promptYesNo(const std::string& question);
+
+    // Minigames are data (minigame_engine.h); this renders one and returns whether the player won
+    bool playMinigame(Minigames::Id id);
+    void showMinigameConsequence(const TurnFlow::PeakResult& peak);
+
+    void announceTensorConcordia();
+
+    // Tensor gauge feedback; the gauge itself is kept by Rules
+    void showTensorGain(int oldValue);
+    TurnFlow::PeakResult playTensorPeak();
 
     void playMainGame();
+    void resumeSavedGame();
+    void chooseDifficulty();
+    void applyDifficulty();  // hands the profile's current budget to enemyAgent
+    void playSpectatorMatch();
+    void playOnlineMatch();
     void playMinigameMenu();
 
     // Consolidate menu handling into one method
@@ -218,8 +448,9 @@ public:
     static constexpr int ACTION_PLAY = 0;
     static constexpr int ACTION_ATTACK = 1;
     static constexpr int ACTION_END = 2;
-    static constexpr int ACTION_HELP = 3;
-    static constexpr int ACTION_QUIT = 4;
+    static constexpr int ACTION_HINT = 3;
+    static constexpr int ACTION_HELP = 4;
+    static constexpr int ACTION_QUIT = 5;
 
     // Color constants
     static constexpr int TENSOR_COLOR_START = 1;
@@ -228,10 +459,13 @@ public:
     static constexpr int TOTAL_COLORS = 13;
 
     // Drawing methods
+    static void formatFullName(char* buf, size_t size, const Card& card);
+    static std::string describeAction(const GameState& state, const Rules::Action& action);
     static void drawBox(int y, int x, int height, int width);
     static void drawCard(WINDOW* win, int y, int x, const Card& card, bool isSelected = false);
-    static void drawField(WINDOW* win, int y, int x, const std::vector<Card>& field, int selectedIndex = -1);
-    static void drawHand(WINDOW* win, int y, int x, const std::vector<Card>& hand, int selectedIndex = -1);
+    static void drawField(WINDOW* win, int y, int x, const CardPool& cards, const Field& field, int selectedIndex = -1);
+    static void drawEmptySlot(WINDOW* win, int y, int x);
+    static void drawHand(WINDOW* win, int y, int x, const CardPool& cards, const std::vector<CardHandle>& hand, int selectedIndex = -1);
     static void drawStats(WINDOW* win, int y, int x, int health, int energy);
     static void drawHealthBar(int y, int x, int current, int max, bool isEnergy = false);
     static void drawTensorGauge(int y, int x, int current, int maximum);
@@ -248,5 +482,3 @@ public:
     static void initializeAllColors();
     static void initializeTensorColors();
 };
-
-constexpr size_t MAX_FIELD_SIZE = 4;
\ No newline at end of file
@@ -1,70 +1,167 @@
 #include "game.h"
+#include "framestats.h"
+#include <atomic>
+#include <mutex>
+
+namespace {
+    // Strings live in the deque (stable c_str() as it grows, touched only under the mutex);
+    // readers go through the fixed pointer array, whose slots are written once and then
+    // published by the release store to count
+    struct NameTable {
+        std::mutex mutex;
+        std::deque<std::string> strings;
+        std::array<const char*, CardNames::CAPACITY> names{};
+        std::atomic<size_t> count{0};
+    };
+
+    NameTable& nameTable() {
+        static NameTable table;
+        return table;
+    }
+}
+
+uint16_t CardNames::intern(const char* name) {
+    auto& table = nameTable();
+    std::lock_guard<std::mutex> lock(table.mutex);
+    for (size_t i = 0; i < table.strings.size(); i++) {
+        if (table.strings[i] == name) {
+            return static_cast<uint16_t>(i);
+        }
+    }
+    size_t id = table.strings.size();
+    if (id >= CAPACITY) return INVALID;
+    table.names[id] = table.strings.emplace_back(name).c_str();
+    table.count.store(id + 1, std::memory_order_release);
+    return static_cast<uint16_t>(id);
+}
+
+const char* CardNames::get(uint16_t id) {
+    return nameTable().names[id];
+}
+
+size_t CardNames::count() {
+    return nameTable().count.load(std::memory_order_acquire);
+}
 
 const int GameState::TensorState::RAINBOW_COLORS[7] = {
     COLOR_RED, COLOR_YELLOW, COLOR_GREEN,
     COLOR_CYAN, COLOR_BLUE, COLOR_MAGENTA, COLOR_WHITE
 };
 
-void GameState::initializeDeck() {
-    deck.clear();
-    
-    const char* championNames[] = {
-        "Netrunner", "Cybermage", "Datascraper", "GridKnight",
-        "ByteBlade", "SyncMaster", "CodeWeaver", "VoidHacker"
+namespace {
+    // Every card a deck can hold, by type, in build order. Names are interned
+    // once, here, so decks of any composition can be cut from it on any thread.
+    // A standard deck is the first 37 champions, 8 artifacts and 5 tensors.
+    struct Catalogue {
+        std::vector<Card> champions, artifacts, tensors;
     };
+
+    Catalogue buildCatalogue() {
+        const char* championNames[] = {
+            "Netrunner", "Cybermage", "Datascraper", "GridKnight",
+            "ByteBlade", "SyncMaster", "CodeWeaver", "VoidHacker"
+        };
     
-    const char* artifactNames[] = {
-        "Neural Link", "BioAugment", "DataCore", "SynapseBoost",
-        "TechPlating", "QuickChips", "PowerNode", "GridAmp"
-    };
+        const char* artifactNames[] = {
+            "Neural Link", "BioAugment", "DataCore", "SynapseBoost",
+            "TechPlating", "QuickChips", "PowerNode", "GridAmp"
+        };
     
-    const char* tensorNames[] = {
-        "Data Shard", "Energy Core", "Power Node", "Logic Gate", "Sync Crystal"
-    };
-
-    const char* roleNames[4][8] = {
-        // MERC names
-        {"Bounty", "Hunter", "Merc", "Gunner", "Soldier", "Warrior", "Fighter", "Sniper"},
-        // NOMAD names
-        {"Wanderer", "Drifter", "Ranger", "Scout", "Tracker", "Pathfinder", "Guide", "Explorer"},
-        // CORPO names
-        {"Executive", "Manager", "Director", "Leader", "Chief", "Boss", "Head", "Commander"},
-        // MAGE names
-        {"Wizard", "Sorcerer", "Mage", "Caster", "Mystic", "Sage", "Scholar", "Adept"}
-    };
+        const char* tensorNames[] = {
+            "Data Shard", "Energy Core", "Power Node", "Logic Gate", "Sync Crystal"
+        };
+
+        const char* roleNames[4][8] = {
+            // MERC names
+            {"Bounty", "Hunter", "Merc", "Gunner", "Soldier", "Warrior", "Fighter", "Sniper"},
+            // NOMAD names
+            {"Wanderer", "Drifter", "Ranger", "Scout", "Tracker", "Pathfinder", "Guide", "Explorer"},
+            // CORPO names
+            {"Executive", "Manager", "Director", "Leader", "Chief", "Boss", "Head", "Commander"},
+            // MAGE names
+            {"Wizard", "Sorcerer", "Mage", "Caster", "Mystic", "Sage", "Scholar", "Adept"}
+        };
+
+        Catalogue catalogue;
+        const int most = static_cast<int>(CardPool::CAPACITY);
+
+        // Create champions with role-appropriate names
+        for (int i = 0; i < most; i++) {
+            int roleIdx = (i / 4) % 4;
+            Card champion = Card::createChampion(
+                roleNames[roleIdx][i % 8],
+                1 + (i % 3),      // cost
+                1 + (i % 3),      // attack
+                2 + (i % 2)       // health
+            );
+            champion.faction = Card::Faction(1 + (i % 4));  // TECHNO to VIRTU_MACHINA
+            champion.role = Card::Role(1 + ((i / 4) % 4));  // MERC to MAGE
+            catalogue.champions.push_back(champion);
+        }
+
+        // Create artifacts with themed names
+        for (int i = 0; i < most; i++) {
+            int buff = (i % 2 == 0) ? 1 : 2;
+            catalogue.artifacts.push_back(Card::createArtifact(artifactNames[i % 8], buff, buff));
+        }
+
+        // Create tensors with themed names
+        for (int i = 0; i < most; i++) {
+            int energyBoost = (i % 2 == 0) ? 1 : 2;
+            catalogue.tensors.push_back(Card::createTensor(tensorNames[i % 5], 0, energyBoost));
+        }
+
+        return catalogue;
+    }
 
-    // Create champions with role-appropriate names
-    for (int i = 0; i < 37; i++) {
-        int roleIdx = (i / 4) % 4;
-        Card champion = Card::createChampion(
-            roleNames[roleIdx][i % 8],
-            1 + (i % 3),      // cost
-            1 + (i % 3),      // attack
-            2 + (i % 2)       // health
-        );
-        champion.faction = Card::Faction(1 + (i % 4));  // TECHNO to VIRTU_MACHINA
-        champion.role = Card::Role(1 + ((i / 4) % 4));  // MERC to MAGE
-        deck.push_back(champion);
+    const Catalogue& catalogue() {
+        static const Catalogue built = buildCatalogue();
+        return built;
     }
 
-    // Create artifacts with themed names
-    for (int i = 0; i < 8; i++) {
-        int buff = (i % 2 == 0) ? 1 : 2;
-        deck.push_back(Card::createArtifact(artifactNames[i], buff, buff));
+    // The pool for rules' deck composition, rebuilt only when a thread switches composition
+    const CardPool& prototype(const RuleSet& rules) {
+        const Catalogue& source = catalogue();
+        thread_local CardPool pool;
+        thread_local std::array<int, 3> built = {-1, -1, -1};
+        std::array<int, 3> wanted = {rules.champions, rules.artifacts, rules.tensors};
+        if (built != wanted) {
+            pool.clear();
+            for (int i = 0; i < rules.champions; i++) pool.add(source.champions[i]);
+            for (int i = 0; i < rules.artifacts; i++) pool.add(source.artifacts[i]);
+            for (int i = 0; i < rules.tensors; i++) pool.add(source.tensors[i]);
+            built = wanted;
+        }
+        return pool;
     }
+}
 
-    // Create tensors with themed names
-    for (int i = 0; i < 5; i++) {
-        int energyBoost = (i % 2 == 0) ? 1 : 2;
-        deck.push_back(Card::createTensor(tensorNames[i], 0, energyBoost));
+void CardNames::seedCatalogue() {
+    catalogue();
+}
+
+void GameState::initializeDeck(std::mt19937& rng, bool lazy) {
+    cards = prototype(*rules);
+    deck.resize(cards.size);
+    for (size_t i = 0; i < deck.size(); i++) {
+        deck[i] = static_cast<CardHandle>(i);
     }
 
-    std::shuffle(deck.begin(), deck.end(), std::mt19937(std::random_device{}()));
+    lazyDeck = lazy;
+    if (lazy) {
+        uint64_t high = rng();
+        drawState = (high << 32) | rng();
+    } else {
+        drawState = 0;
+        std::shuffle(deck.begin(), deck.end(), rng);
+    }
     tensor.current = 0;
-    tensor.maximum = 3;
+    tensor.maximum = rules->tensorStart;
 }
 
 void GameState::printGameState() const {
+    FrameStats::beginFrame();
+    FrameStats::Timer timer(FrameStats::PRINT_GAME_STATE);
     clear();
     box(stdscr, 0, 0);
 
@@ -78,7 +175,7 @@ void GameState::printGameState() const {
     // Enemy section
     GameUI::drawHealthBar(4, 2, enemyHealth, 10);
     GameUI::drawHealthBar(5, 2, enemyEnergy, 10, true);
-    GameUI::drawField(stdscr, 7, 2, enemyField);
+    GameUI::drawField(stdscr, 7, 2, cards, enemyField);
 
     // Info panel with better organization
     int infoX = gameWidth + 1;
@@ -121,9 +218,11 @@ void GameState::printGameState() const {
     attroff(A_BOLD);
 
     // Player section
-    GameUI::drawField(stdscr, LINES/2+2, 2, playerField);
-    GameUI::drawHand(stdscr, LINES-9, 2, playerHand);
+    GameUI::drawField(stdscr, LINES/2+2, 2, cards, playerField);
+    GameUI::drawHand(stdscr, LINES-9, 2, cards, playerHand);
 
+    FrameStats::drawHud();
+    FrameStats::Timer refreshTimer(FrameStats::REFRESH);
     refresh();
 }
 
@@ -1,4 +1,6 @@
 #include "game.h"
+#include "rules.h"
+#include "framestats.h"
 
 void Game::printHelp() const {
     std::cout << "\nCommands:\n"
@@ -39,8 +41,12 @@ void Game::showHelpMenu() const {
                     mvprintw(3, 2, "[Play card]");
                     mvprintw(4, 2, "[Attack]");
                     mvprintw(5, 2, "[End turn]");
-                    mvprintw(6, 2, "[Help]");
-                    mvprintw(7, 2, "[Quit]");
+                    mvprintw(6, 2, "[Hint] - Suggested turn plan, refined while shown");
+                    mvprintw(7, 2, "[Help]");
+                    mvprintw(8, 2, "[Quit]");
+                    mvprintw(10, 2, "Press H during your turn for a hint too");
+                    mvprintw(11, 2, "Press S during your turn to save (resume from the main menu)");
+                    mvprintw(12, 2, "Press F during your turn to show frame timings");
                     mvprintw(LINES-1, 2, "Press any key to continue...");
                     refresh();
                     getch();
@@ -113,6 +119,44 @@ int GameUI::getFactionColor(Card::Faction faction) {
     }
 }
 
+void GameUI::formatFullName(char* buf, size_t size, const Card& card) {
+    // Champions are shown as "Faction - Role", everything else keeps its card name
+    if (card.type == Card::CHAMPION) {
+        std::string_view faction = card.factionName();
+        std::string_view role = card.roleName();
+        snprintf(buf, size, "%.*s - %.*s",
+                 static_cast<int>(faction.size()), faction.data(),
+                 static_cast<int>(role.size()), role.data());
+    } else {
+        snprintf(buf, size, "%s", card.name());
+    }
+}
+
+std::string GameUI::describeAction(const GameState& state, const Rules::Action& action) {
+    Rules::Side side = Rules::toMove(state);
+    char name[32];
+    switch (action.type) {
+        case Rules::Action::PLAY_CARD: {
+            const Card card = state.cards.get(Rules::hand(state, side)[action.index]);
+            formatFullName(name, sizeof(name), card);
+            if (card.type == Card::ARTIFACT) {
+                return std::string("buff ") + state.cards.name(Rules::field(state, side)[action.target]) + " with " + name;
+            }
+            return std::string("play ") + name;
+        }
+        case Rules::Action::ATTACK: {
+            std::string text = std::string(state.cards.name(Rules::field(state, side)[action.index])) + " attacks ";
+            if (action.target < 0) {
+                return text + (side == Rules::PLAYER ? "enemy" : "player");
+            }
+            return text + state.cards.name(Rules::field(state, Rules::opponent(side))[action.target]);
+        }
+        case Rules::Action::END_TURN:
+            break;
+    }
+    return "end turn";
+}
+
 void GameUI::drawCard(WINDOW* win, int y, int x, const Card& card, bool isSelected) {
     // Simplified borders using basic ASCII
     const char* border;
@@ -141,13 +185,10 @@ void GameUI::drawCard(WINDOW* win, int y, int x, const Card& card, bool isSelect
     attroff(COLOR_PAIR(FACTION_COLOR_START + static_cast<int>(card.faction)));
     
     // Format full name properly
-    std::string factionNames[] = {"None", "Techno", "Cyber", "Exec", "Virtu-Machina"};
-    std::string roleNames[] = {"None", "Merc", "Nomad", "Corpo", "Mage"};
-    std::string fullName = factionNames[static_cast<int>(card.faction)] + 
-                          " - " + 
-                          roleNames[static_cast<int>(card.role)];
+    char fullName[32];
+    formatFullName(fullName, sizeof(fullName), card);
     
-    mvprintw(y + 1, x, "|%-22s|", fullName.c_str());
+    mvprintw(y + 1, x, "|%-22s|", fullName);
     
     if (card.type == Card::CHAMPION) {
         mvprintw(y + 2, x, "|ATK:");
@@ -179,22 +220,39 @@ void GameUI::drawCard(WINDOW* win, int y, int x, const Card& card, bool isSelect
     mvprintw(y + 4, x, "+%s+", border);
 }
 
-void GameUI::drawField(WINDOW* win, int y, int x, const std::vector<Card>& field, int selectedIndex) {
-    for(size_t i = 0; i < field.size(); ++i) {
-        drawCard(win, y, x + (i * 20), field[i], i == selectedIndex);  // Reduced spacing to 20
+void GameUI::drawField(WINDOW* win, int y, int x, const CardPool& cards, const Field& field, int selectedIndex) {
+    FrameStats::Timer timer(FrameStats::DRAW_FIELD);
+    // Every slot keeps its place, so champions don't shift when one dies
+    for(int i = 0; i < static_cast<int>(MAX_FIELD_SIZE); ++i) {
+        if (field.occupied(i)) {
+            drawCard(win, y, x + (i * 20), cards.get(field[i]), i == selectedIndex);  // Reduced spacing to 20
+        } else {
+            drawEmptySlot(win, y, x + (i * 20));
+        }
     }
 }
 
+void GameUI::drawEmptySlot(WINDOW* win, int y, int x) {
+    attron(A_DIM);
+    mvprintw(y, x, "+ - - - - +");
+    mvprintw(y + 1, x, "|  empty  |");
+    mvprintw(y + 2, x, "|         |");
+    mvprintw(y + 3, x, "|         |");
+    mvprintw(y + 4, x, "+ - - - - +");
+    attroff(A_DIM);
+}
+
 void GameUI::drawStats(WINDOW* win, int y, int x, int health, int energy) {
     mvprintw(y, x, "Health: %d | Energy: %d", health, energy);
 }
 
 void GameUI::drawActionMenu(int selectedAction) {
-    const char* actions[] = {"[Play]", "[Attack]", "[End Turn]", "[Help]", "[Quit]"};
+    const char* actions[] = {"[Play]", "[Attack]", "[End Turn]", "[Hint]", "[Help]", "[Quit]"};
+    const int count = sizeof(actions) / sizeof(actions[0]);
     int menuY = LINES - 2;
-    int spacing = COLS / (sizeof(actions) / sizeof(actions[0]));
+    int spacing = COLS / count;
     
-    for(int i = 0; i < 5; i++) {
+    for(int i = 0; i < count; i++) {
         int x = (spacing * i) + (spacing/2) - strlen(actions[i])/2;
         if(i == selectedAction) {
             attron(A_REVERSE);
@@ -218,7 +276,8 @@ void GameUI::drawNavigationHints() {
     attroff(A_DIM);
 }
 
-void GameUI::drawHand(WINDOW* win, int y, int x, const std::vector<Card>& hand, int selectedIndex) {
+void GameUI::drawHand(WINDOW* win, int y, int x, const CardPool& cards, const std::vector<CardHandle>& hand, int selectedIndex) {
+    FrameStats::Timer timer(FrameStats::DRAW_HAND);
     const size_t cardsPerPage = 4;
     size_t currentPage = selectedIndex >= 0 ? selectedIndex / cardsPerPage : 0;
     size_t startIndex = currentPage * cardsPerPage;
@@ -231,38 +290,29 @@ void GameUI::drawHand(WINDOW* win, int y, int x, const std::vector<Card>& hand,
     
     // Draw cards with better formatting
     for(size_t i = startIndex; i < endIndex; i++) {
-        const auto& card = hand[i];
+        const Card card = cards.get(hand[i]);
         int xPos = x + ((i - startIndex) * 20);  // Use consistent 20-space width
         
         bool isSelected = (static_cast<int>(i) == selectedIndex);
         if(isSelected) attron(A_REVERSE | A_BOLD);
         
         // Format name consistently with field display
-        std::string factionNames[] = {"None", "Techno", "Cyber", "Exec", "Virtu-Machina"};
-        std::string roleNames[] = {"None", "Merc", "Nomad", "Corpo", "Mage"};
-        std::string fullName;
-        
-        if (card.type == Card::CHAMPION) {
-            fullName = factionNames[static_cast<int>(card.faction)] + 
-                      " - " + 
-                      roleNames[static_cast<int>(card.role)];
-        } else {
-            fullName = card.name;  // Keep original name for non-champions
-        }
+        char fullName[32];
+        formatFullName(fullName, sizeof(fullName), card);
         
         switch(card.type) {
             case Card::CHAMPION:
-                mvprintw(y, xPos, "%-20s", fullName.c_str());
+                mvprintw(y, xPos, "%-20s", fullName);
                 mvprintw(y + 1, xPos, "ATK: %-3d  HP: %-3d", card.attack, card.health);
                 mvprintw(y + 2, xPos, "Cost: %d", card.cost);
                 break;
             case Card::ARTIFACT:
-                mvprintw(y, xPos, "%s", card.name.c_str());
+                mvprintw(y, xPos, "%s", card.name());
                 mvprintw(y + 1, xPos, "Buff: +%d", card.effect);
                 mvprintw(y + 2, xPos, "Cost: %d", card.cost);  // Fixed: Add missing cost parameter
                 break;
             case Card::TENSOR:
-                mvprintw(y, xPos, "%s", card.name.c_str());
+                mvprintw(y, xPos, "%s", card.name());
                 mvprintw(y + 1, xPos, "Energy: +%d", card.effect);
                 mvprintw(y + 2, xPos, "Cost: FREE");
                 break;
@@ -331,6 +381,7 @@ void GameUI::initializeAllColors() {
 }
 
 void GameUI::drawTensorGauge(int y, int x, int current, int maximum) {
+    FrameStats::Timer timer(FrameStats::DRAW_TENSOR_GAUGE);
     mvprintw(y, x, "Tensor: [");
     
     // Draw filled portion with rainbow colors
@@ -1,6 +1,19 @@
 #include "game.h"
+#include "effects.h"
+#include "framestats.h"
 
 int main() {
+    // A designer's tensor_effects.txt replaces the built-in card effects
+    std::string effectsError;
+    if (!Effects::loadDefaultFile(effectsError)) {
+        std::cerr << effectsError << "\n";
+        return 1;
+    }
+
+    if (std::getenv("TENSOR_FRAME_HUD")) {
+        FrameStats::showHud(true);
+    }
+
     // Initialize curses
     initscr();
     start_color();
@@ -0,0 +1,265 @@
+#include "mcts.h"
+#include "rollout.h"
+#include "book.h"
+#include <cmath>
+
+namespace {
+    enum NodeState : uint8_t {
+        UNEXPANDED,
+        EXPANDING,
+        EXPANDED
+    };
+}
+
+struct Mcts::Node {
+    Rules::Action action;                 // the move that leads here from the parent
+    std::atomic<uint8_t> state{UNEXPANDED};
+    uint16_t childCount = 0;              // children and childCount are published by state = EXPANDED
+    Node* children = nullptr;
+    std::atomic<uint32_t> visits{0};
+    std::atomic<uint32_t> halfPoints{0};  // 2 per mover win, 1 per draw
+    std::atomic<uint32_t> virtualLoss{0};
+};
+
+// Bump allocator for one thread's nodes; nothing is freed until the search ends
+class Mcts::Arena {
+public:
+    Node* allocate(size_t count) {
+        if (count > BLOCK_NODES) {
+            blocks.emplace_back(new Node[count]);
+            total += count;
+            return blocks.back().get();
+        }
+        if (used + count > BLOCK_NODES) {
+            blocks.emplace_back(new Node[BLOCK_NODES]);
+            used = 0;
+        }
+        Node* nodes = blocks.back().get() + used;
+        used += count;
+        total += count;
+        return nodes;
+    }
+
+    size_t size() const { return total; }
+
+private:
+    static constexpr size_t BLOCK_NODES = 4096;
+    std::vector<std::unique_ptr<Node[]>> blocks;
+    size_t used = BLOCK_NODES;
+    size_t total = 0;
+};
+
+struct Mcts::Worker {
+    explicit Worker(uint64_t seed) : rng(seed), peakRng(static_cast<uint32_t>(seed >> 32)) {}
+
+    Arena arena;
+    Rollout::Rng rng;
+    std::mt19937 peakRng;
+    GameState world;
+    std::vector<Node*> path;
+    std::vector<Rules::Action> actions;
+};
+
+Mcts::Mcts() : Mcts(Options{}) {}
+
+Mcts::Mcts(const Options& options) : settings(options) {}
+
+Mcts::~Mcts() = default;
+
+bool Mcts::expand(Node& node, const GameState& world, Worker& worker) {
+    uint8_t expected = UNEXPANDED;
+    if (!node.state.compare_exchange_strong(expected, EXPANDING, std::memory_order_acquire)) {
+        return false;  // another thread has it
+    }
+    Rules::legalActions(world, worker.actions);
+    Node* children = worker.arena.allocate(worker.actions.size());
+    for (size_t i = 0; i < worker.actions.size(); i++) {
+        children[i].action = worker.actions[i];
+    }
+    node.children = children;
+    node.childCount = static_cast<uint16_t>(worker.actions.size());
+    node.state.store(EXPANDED, std::memory_order_release);
+    return true;
+}
+
+// UCT with virtual losses counted as visits that scored nothing
+Mcts::Node* Mcts::select(Node& node) const {
+    uint32_t parentVisits = node.visits.load(std::memory_order_relaxed) + node.virtualLoss.load(std::memory_order_relaxed);
+    float logVisits = std::log(static_cast<float>(std::max(parentVisits, 1u)));
+    Node* best = nullptr;
+    float bestScore = -1.0f;
+    for (uint16_t i = 0; i < node.childCount; i++) {
+        Node& child = node.children[i];
+        uint32_t visits = child.visits.load(std::memory_order_relaxed) + child.virtualLoss.load(std::memory_order_relaxed);
+        if (visits == 0) return &child;
+        float mean = 0.5f * child.halfPoints.load(std::memory_order_relaxed) / visits;
+        float score = mean + settings.exploration * std::sqrt(logVisits / visits);
+        if (score > bestScore) {
+            bestScore = score;
+            best = &child;
+        }
+    }
+    return best;
+}
+
+void Mcts::iterate(Node& root, const GameState& state, Rules::Side mover, Worker& worker) {
+    GameState& world = worker.world;
+    world = state;
+    Rules::determinize(world, mover, worker.rng.next());
+
+    worker.path.clear();
+    Node* node = &root;
+    node->virtualLoss.fetch_add(settings.virtualLoss, std::memory_order_relaxed);
+    worker.path.push_back(node);
+
+    // Descend while it is still the mover's turn; ending it leaves the tree
+    while (Rules::result(world) == Rules::ONGOING && Rules::toMove(world) == mover) {
+        if (node->state.load(std::memory_order_acquire) != EXPANDED && !expand(*node, world, worker)) {
+            break;  // being expanded by another thread: play out from here
+        }
+        Node* child = select(*node);
+        // A tensor peak resolved differently in this world can leave a move unaffordable
+        if (!child || !Rules::isLegal(world, child->action)) break;
+
+        child->virtualLoss.fetch_add(settings.virtualLoss, std::memory_order_relaxed);
+        worker.path.push_back(child);
+        if (Rules::applyUnchecked(world, child->action).tensorPeak) {
+            Rules::resolveTensorPeak(world, worker.peakRng);
+        }
+        bool fresh = child->visits.load(std::memory_order_relaxed) == 0;
+        node = child;
+        if (fresh) break;  // one new node per iteration
+    }
+
+    Rules::Result result = Rules::result(world);
+    if (result == Rules::ONGOING) {
+        int plies = 0;
+        result = Rollout::playout(world, worker.rng, worker.peakRng, plies);
+    }
+    uint32_t points = result == Rules::DRAW || result == Rules::ONGOING ? 1
+                    : (result == Rules::PLAYER_WIN) == (mover == Rules::PLAYER) ? 2 : 0;
+
+    for (Node* visited : worker.path) {
+        visited->visits.fetch_add(1, std::memory_order_relaxed);
+        visited->halfPoints.fetch_add(points, std::memory_order_relaxed);
+        visited->virtualLoss.fetch_sub(settings.virtualLoss, std::memory_order_relaxed);
+    }
+}
+
+Mcts::Result Mcts::search(const GameState& state) {
+    Result result;
+    std::vector<Rules::Action> rootActions;
+    Rules::legalActions(state, rootActions);
+    if (Rules::result(state) != Rules::ONGOING || rootActions.size() == 1) {
+        return result;  // ending the turn is the only move
+    }
+
+    Rules::Side mover = Rules::toMove(state);
+    int threads = std::clamp(settings.threads, 1, MAX_THREADS);
+    int trees = settings.mode == ROOT_PARALLEL ? threads : 1;
+    std::unique_ptr<Node[]> roots(new Node[trees]);
+
+    Rollout::Rng seeds(settings.seed ^ (++searches * 0x9E3779B97F4A7C15ull));
+    std::vector<Worker> workers;
+    workers.reserve(threads);
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back(seeds.next());
+    }
+
+    std::atomic<int> remaining{settings.iterations};
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(settings.milliseconds);
+    auto work = [&](int t) {
+        Node& root = roots[settings.mode == ROOT_PARALLEL ? t : 0];
+        for (int i = 0; remaining.fetch_sub(1, std::memory_order_relaxed) > 0; i++) {
+            if (cancel && cancel->load(std::memory_order_relaxed)) break;
+            // A playout takes microseconds, so looking at the clock every 16 is plenty
+            if (settings.milliseconds > 0 && i % 16 == 0 && std::chrono::steady_clock::now() >= deadline) break;
+            iterate(root, state, mover, workers[t]);
+        }
+    };
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; t++) {
+        pool.emplace_back(work, t);
+    }
+    work(0);
+    for (auto& thread : pool) {
+        thread.join();
+    }
+
+    // Every root was expanded from the same position, so child i is the same move in each tree
+    std::vector<uint64_t> visits(rootActions.size()), halfPoints(rootActions.size());
+    for (int r = 0; r < trees; r++) {
+        Node& root = roots[r];
+        result.iterations += root.visits.load();
+        if (root.state.load() != EXPANDED) continue;
+        for (uint16_t i = 0; i < root.childCount && i < rootActions.size(); i++) {
+            visits[i] += root.children[i].visits.load();
+            halfPoints[i] += root.children[i].halfPoints.load();
+        }
+    }
+    size_t best = std::max_element(visits.begin(), visits.end()) - visits.begin();
+    if (visits[best] > 0) {
+        result.action = rootActions[best];
+        result.score = 0.5f * halfPoints[best] / visits[best];
+
+        // The line runs down the tree that searched the chosen move hardest
+        const Node* node = nullptr;
+        for (int r = 0; r < trees; r++) {
+            const Node& root = roots[r];
+            if (root.state.load() != EXPANDED || best >= root.childCount) continue;
+            if (!node || root.children[best].visits.load() > node->visits.load()) node = &root.children[best];
+        }
+        result.line.push_back(result.action);
+        while (node->action.type != Rules::Action::END_TURN && node->state.load() == EXPANDED) {
+            const Node* most = nullptr;
+            for (uint16_t i = 0; i < node->childCount; i++) {
+                if (!most || node->children[i].visits.load() > most->visits.load()) most = &node->children[i];
+            }
+            if (!most || most->visits.load() < MIN_LINE_VISITS) break;
+            node = most;
+            result.line.push_back(node->action);
+        }
+    }
+    result.nodes = trees;
+    for (const Worker& worker : workers) {
+        result.nodes += worker.arena.size();
+    }
+    return result;
+}
+
+void MctsAgent::adoptLine(const GameState& state, std::vector<Rules::Action> searched) {
+    line = std::move(searched);
+    next = 0;
+    TurnSolver::turnKey(state, expected);
+}
+
+Rules::Action MctsAgent::choose(const GameState& state) {
+    Rules::Action action;
+    if (book && book->probe(state, action)) {
+        next = line.size();
+        return action;
+    }
+
+    bool followed = false;
+    if (next < line.size()) {
+        TurnSolver::turnKey(state, key);
+        followed = key == expected && Rules::isLegal(state, line[next]);
+    }
+    if (followed) {
+        action = line[next++];
+    } else {
+        Mcts::Result result = mcts.search(state);
+        action = result.action;
+        line = std::move(result.line);
+        next = 1;
+    }
+
+    // Where the line goes from here, unless the turn ends or a peak's minigame decides it
+    GameState predicted = state;
+    if (action.type == Rules::Action::END_TURN || Rules::apply(predicted, action).tensorPeak) {
+        next = line.size();
+    } else {
+        TurnSolver::turnKey(predicted, expected);
+    }
+    return action;
+}
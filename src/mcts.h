@@ -0,0 +1,106 @@
+#pragma once
+#include "turnflow.h"
+#include <atomic>
+
+namespace Book { class Table; }
+
+// Monte Carlo tree search for the side to move, on any number of threads.
+//
+// Every iteration samples a world the mover can't tell from the real one
+// (Rules::determinize: the opponent's hand and the deck order), walks the tree
+// by UCT, grows it by one node and plays the game out with the Rollout policy.
+// The tree covers the mover's current turn only. Those moves don't depend on
+// the hidden cards, so one tree serves every world, and ending the turn hands
+// over to the playout.
+//
+//   TREE_PARALLEL  all threads share one tree. Visit and score counters are
+//                  atomics, and a thread puts a virtual loss on every node of
+//                  its path so the others spread out instead of piling onto
+//                  the same line. Whichever thread wins a compare-and-swap on
+//                  a node's state expands it, with children from that thread's
+//                  own arena: no locks, no shared allocator. A thread that
+//                  loses the race plays out from the node instead of waiting.
+//   ROOT_PARALLEL  every thread grows a private tree from its own seed and the
+//                  root visit counts are summed at the end.
+class Mcts {
+public:
+    enum Mode {
+        TREE_PARALLEL,
+        ROOT_PARALLEL
+    };
+
+    static constexpr int DEFAULT_ITERATIONS = 2000;
+    static constexpr int MAX_THREADS = 256;
+    static constexpr uint32_t MIN_LINE_VISITS = 32;  // playouts a later move of the turn needs to join Result::line
+
+    struct Options {
+        int iterations = DEFAULT_ITERATIONS;  // playouts per search, shared by all threads
+        int milliseconds = 0;                 // wall-clock limit per search, 0 for none
+        int threads = 1;
+        Mode mode = TREE_PARALLEL;
+        float exploration = 1.0f;             // UCT constant
+        uint32_t virtualLoss = 1;             // losses a thread charges each node on its path
+        uint64_t seed = 1;
+    };
+
+    struct Result {
+        Rules::Action action;   // most visited move at the root
+        float score = 0.5f;     // its mean playout score for the mover, 0 (loss) .. 1 (win)
+        int iterations = 0;
+        size_t nodes = 0;
+        // The rest of the turn as the tree sees it: action, then the most visited child at each
+        // level while it has MIN_LINE_VISITS, up to END_TURN. Moves after a tensor peak assumed
+        // whichever minigame outcome the tree met first.
+        std::vector<Rules::Action> line;
+    };
+
+    Mcts();
+    explicit Mcts(const Options& options);
+    ~Mcts();
+
+    Result search(const GameState& state);
+
+    // Checked between iterations; once set, search() returns what it has
+    void setCancelFlag(const std::atomic<bool>* flag) { cancel = flag; }
+
+    const Options& options() const { return settings; }
+    void setOptions(const Options& options) { settings = options; }
+
+private:
+    struct Node;
+    class Arena;
+    struct Worker;
+
+    void iterate(Node& root, const GameState& state, Rules::Side mover, Worker& worker);
+    bool expand(Node& node, const GameState& world, Worker& worker);
+    Node* select(Node& node) const;
+
+    Options settings;
+    const std::atomic<bool>* cancel = nullptr;
+    uint64_t searches = 0;  // varies the seed from one search to the next
+};
+
+// Agent that searches once per turn and then follows the search's line: a later
+// decision reuses it while the position is exactly the one the line foresaw, and
+// searches afresh after a tensor peak, a stale line or a line that ran out.
+// A line searched elsewhere, e.g. while pondering, can be handed over with
+// adoptLine(). With a book, a position the book knows is answered from it instead.
+class MctsAgent : public TurnFlow::Agent {
+public:
+    explicit MctsAgent(const Mcts::Options& options = Mcts::Options{}) : mcts(options) {}
+
+    void setBook(const Book::Table* table) { book = table; }
+    void setOptions(const Mcts::Options& options) { mcts.setOptions(options); }
+    bool startingTurn() const { return next >= line.size(); }  // the next decision runs a search
+    // The decision at exactly this position plays line (a search's Result::line) instead of searching
+    void adoptLine(const GameState& state, std::vector<Rules::Action> searched);
+    Rules::Action choose(const GameState& state) override;
+
+private:
+    Mcts mcts;
+    const Book::Table* book = nullptr;
+    std::vector<Rules::Action> line;  // the last search's line; line[next] is still to be played
+    size_t next = 0;
+    TurnSolver::Key expected;         // position line[next] was planned for
+    TurnSolver::Key key;
+};
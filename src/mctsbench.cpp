@@ -0,0 +1,100 @@
+// Thread scaling benchmark for the parallel tree search.
+//
+//   mctsbench [iterations] [max threads] [seed]
+//
+// Searches the same seeded positions with Mcts at 1, 2, 4, ... up to max
+// threads (default 64), sharing one tree and then with one tree per thread.
+// For each run it prints playouts per second, the speedup over one thread of
+// the same mode, the nodes grown, and how often the chosen move matches the
+// one-thread choice. Speedup needs cores: on a machine with fewer cores than
+// threads the extra threads only take turns.
+
+#include "mcts.h"
+#include "rollout.h"
+
+namespace {
+    constexpr int ROOTS = 16;
+
+    // Positions a few turns into seeded matches, with a real choice to make
+    std::vector<GameState> makeRoots(uint32_t seed) {
+        std::mt19937 rng(seed);
+        Rollout::Rng policy(seed);
+        std::vector<GameState> roots;
+        std::vector<Rules::Action> actions;
+        while (roots.size() < ROOTS) {
+            GameState state;
+            Rules::setupGame(state, rng);
+            int plies = static_cast<int>(rng() % 30);
+            for (int i = 0; i < plies && Rules::result(state) == Rules::ONGOING; i++) {
+                Rules::step(state, Rollout::randomAction(state, policy), rng);
+            }
+            if (Rules::result(state) != Rules::ONGOING) continue;
+            Rules::legalActions(state, actions);
+            if (actions.size() > 2) roots.push_back(state);
+        }
+        return roots;
+    }
+
+    bool sameAction(const Rules::Action& a, const Rules::Action& b) {
+        return a.type == b.type && a.index == b.index && a.target == b.target;
+    }
+}
+
+int main(int argc, char** argv) {
+    int iterations = argc > 1 ? std::atoi(argv[1]) : 20000;
+    int maxThreads = argc > 2 ? std::atoi(argv[2]) : 64;
+    uint32_t seed = argc > 3 ? static_cast<uint32_t>(std::strtoul(argv[3], nullptr, 10)) : 1;
+    if (iterations <= 0 || maxThreads <= 0 || maxThreads > Mcts::MAX_THREADS) {
+        std::cerr << "Need positive iterations and 1.." << Mcts::MAX_THREADS << " threads\n";
+        return 1;
+    }
+
+    std::vector<GameState> roots = makeRoots(seed);
+    std::cout << "MCTS benchmark: " << iterations << " playouts per search, " << ROOTS << " positions, "
+              << std::thread::hardware_concurrency() << " hardware threads\n\n";
+    std::cout << std::left << std::setw(8) << "mode" << std::right << std::setw(8) << "threads"
+              << std::setw(12) << "playouts/s" << std::setw(9) << "speedup" << std::setw(10) << "nodes"
+              << std::setw(8) << "agree" << "\n";
+
+    for (Mcts::Mode mode : {Mcts::TREE_PARALLEL, Mcts::ROOT_PARALLEL}) {
+        double baseRate = 0;
+        std::vector<Rules::Action> baseMoves;
+        for (int threads = 1; threads <= maxThreads; threads *= 2) {
+            Mcts::Options options;
+            options.iterations = iterations;
+            options.threads = threads;
+            options.mode = mode;
+            options.seed = seed;
+
+            long long playouts = 0;
+            size_t nodes = 0;
+            int agree = 0;
+            std::vector<Rules::Action> moves;
+            auto start = std::chrono::steady_clock::now();
+            for (const GameState& root : roots) {
+                Mcts mcts(options);
+                Mcts::Result result = mcts.search(root);
+                playouts += result.iterations;
+                nodes += result.nodes;
+                moves.push_back(result.action);
+            }
+            double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            double rate = playouts / elapsed;
+            if (threads == 1) {
+                baseRate = rate;
+                baseMoves = moves;
+            }
+            for (int r = 0; r < ROOTS; r++) {
+                agree += sameAction(moves[r], baseMoves[r]);
+            }
+            std::cout << std::left << std::setw(8) << (mode == Mcts::TREE_PARALLEL ? "tree" : "root")
+                      << std::right << std::fixed << std::setw(8) << threads
+                      << std::setw(12) << std::setprecision(0) << rate
+                      << std::setw(9) << std::setprecision(2) << rate / baseRate
+                      << std::setw(10) << nodes / ROOTS
+                      << std::setw(5) << agree << "/" << ROOTS << "\n";
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,135 @@
+#include "minigame_engine.h"
+
+namespace {
+    using Minigames::Draw;
+    using Minigames::Verdict;
+
+    Verdict verdict(bool won) { return won ? Minigames::WIN : Minigames::LOSE; }
+
+    // values[0]: 0 heads, 1 tails
+    Draw sampleCoin(std::mt19937& rng) {
+        Draw draw;
+        draw.values[0] = rng() % 2;
+        return draw;
+    }
+
+    Verdict judgeCoin(int choice, const Draw& draw) {
+        return verdict(choice == draw.values[0]);  // choices are Heads, Tails
+    }
+
+    // values: first rank, first suit, second rank, second suit (rank 12 is the ace)
+    Draw sampleHighLow(std::mt19937& rng) {
+        Draw draw;
+        draw.values[0] = rng() % 13;
+        draw.values[1] = rng() % 4;
+        draw.values[2] = rng() % 13;
+        draw.values[3] = rng() % 4;
+        return draw;
+    }
+
+    Verdict judgeHighLow(int choice, const Draw& draw) {
+        int firstRank = draw.values[0], firstSuit = draw.values[1];
+        int secondRank = draw.values[2], secondSuit = draw.values[3];
+
+        // An ace on either side decides it, equal ranks fall back to suit order
+        bool isHigher;
+        if (firstRank != secondRank) {
+            if (firstRank == 12) {
+                isHigher = false;
+            } else if (secondRank == 12) {
+                isHigher = true;
+            } else {
+                isHigher = secondRank > firstRank;
+            }
+        } else {
+            isHigher = secondSuit < firstSuit;
+        }
+        return verdict((choice == 0) == isHigher);  // choices are Higher, Lower
+    }
+
+    // values[0]: the number the wheel stops on, 1-6
+    Draw sampleRoulette(std::mt19937& rng) {
+        Draw draw;
+        draw.values[0] = static_cast<int>(rng() % 6) + 1;
+        return draw;
+    }
+
+    Verdict judgeRoulette(int choice, const Draw& draw) {
+        return verdict(choice + 1 == draw.values[0]);
+    }
+
+    // values[0], values[1]: the two dice
+    Draw sampleDice(std::mt19937& rng) {
+        Draw draw;
+        draw.values[0] = static_cast<int>(rng() % 6) + 1;
+        draw.values[1] = static_cast<int>(rng() % 6) + 1;
+        return draw;
+    }
+
+    Verdict judgeDice(int choice, const Draw& draw) {
+        bool isHigh = draw.values[0] + draw.values[1] >= 8;
+        return verdict((choice == 0) == isHigh);  // choices are High, Low
+    }
+
+    // values[0]: the enemy's hand, indexed like the choices
+    Draw sampleRPS(std::mt19937& rng) {
+        Draw draw;
+        draw.values[0] = rng() % 3;
+        return draw;
+    }
+
+    Verdict judgeRPS(int choice, const Draw& draw) {
+        int enemyChoice = draw.values[0];
+        if (choice == enemyChoice) return Minigames::REPLAY;
+        return verdict((choice == 0 && enemyChoice == 2) ||   // Rock beats Scissors
+                       (choice == 1 && enemyChoice == 0) ||   // Paper beats Rock
+                       (choice == 2 && enemyChoice == 1));    // Scissors beats Paper
+    }
+
+    const std::array<Minigames::Definition, Minigames::COUNT> GAMES = {{
+        {"Coin Toss", "COIN TOSS", "Stakes: 2 Energy", "Call it in the air!",
+         {"Heads", "Tails"}, false, sampleCoin, judgeCoin,
+         {Minigames::Animation::SPIN, 6, 200, 0, 0, 1500}},
+        {"High-Low Cards", "HIGH OR LOW", nullptr, "Will the next card be Higher or Lower?",
+         {"Higher", "Lower"}, true, sampleHighLow, judgeHighLow,
+         {Minigames::Animation::NONE, 0, 0, 0, 5000, 1500}},
+        {"Roulette", "ROULETTE", "Stakes: 3 Energy", "Choose your number:",
+         {"1", "2", "3", "4", "5", "6"}, false, sampleRoulette, judgeRoulette,
+         {Minigames::Animation::SCROLL, 12, 100, 20, 0, 1500}},
+        {"Dice Roll", "DICE ROLL", "Stakes: 2 Health", nullptr,
+         {"High (8-12)", "Low (2-6)"}, false, sampleDice, judgeDice,
+         {Minigames::Animation::NONE, 0, 0, 0, 0, 1500}},
+        {"Rock Paper Scissors", "ROCK PAPER SCISSORS", "Stakes: 1 Energy", "Make your choice!",
+         {"Rock", "Paper", "Scissors"}, false, sampleRPS, judgeRPS,
+         {Minigames::Animation::NONE, 0, 0, 0, 0, 1500}}
+    }};
+}
+
+const Minigames::Definition& Minigames::get(Id id) {
+    return GAMES[id];
+}
+
+Minigames::Id Minigames::pick(std::mt19937& rng) {
+    return static_cast<Id>(rng() % COUNT);
+}
+
+Minigames::Result Minigames::resolve(Id id, int choice, std::mt19937& rng) {
+    Result result;
+    if (choice < 0) return result;
+
+    const Definition& game = GAMES[id];
+    for (result.rounds = 1; ; result.rounds++) {
+        result.draw = game.sample(rng);
+        Verdict outcome = game.judge(choice, result.draw);
+        if (outcome != REPLAY) {
+            result.won = outcome == WIN;
+            return result;
+        }
+    }
+}
+
+bool Minigames::playRandom(std::mt19937& rng) {
+    Id id = pick(rng);
+    int choice = static_cast<int>(rng() % GAMES[id].choices.size());
+    return resolve(id, choice, rng).won;
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include "game.h"
+
+// Tensor peak minigames as data.
+//
+// Each minigame is a Definition: the choices offered, a sampler that draws the
+// outcome, a judge that scores a choice against the draw and an animation
+// script for the renderer. resolve() plays one out headlessly (a few rng calls,
+// no curses and no delays) for the simulator, the AI and the match server;
+// Game::playMinigame() renders the same definition with curses. A new game is
+// one more table entry plus, if it wants its own art, a reveal case in the renderer.
+namespace Minigames {
+    enum Id : uint8_t {
+        COIN_TOSS,
+        HIGH_LOW,
+        ROULETTE,
+        DICE_ROLL,
+        ROCK_PAPER_SCISSORS,
+        COUNT
+    };
+
+    enum Verdict {
+        LOSE,
+        WIN,
+        REPLAY   // a tie: draw again with the same choice
+    };
+
+    // What the sampler drew; each game documents its own slots
+    struct Draw {
+        std::array<int, 4> values{};
+    };
+
+    // Played by the renderer between the choice and the reveal
+    struct Animation {
+        enum Kind {
+            NONE,
+            SPIN,     // redraw a spinning sprite every frame
+            SCROLL    // count through the faces, slowing down
+        } kind = NONE;
+        int frames = 0;
+        int delayMs = 0;       // pause after the first frame
+        int slowdownMs = 0;    // added to the pause after every frame
+        int previewMs = 0;     // how long a previewed draw stays up before the choice
+        int revealMs = 1500;   // how long the result stays up
+    };
+
+    struct Definition {
+        const char* name;       // practice menu label
+        const char* title;
+        const char* stakes;     // flavour line under the title, nullptr for none
+        const char* prompt;
+        std::vector<std::string> choices;
+        bool previewDraw;       // part of the draw is shown before the player chooses
+        Draw (*sample)(std::mt19937& rng);
+        Verdict (*judge)(int choice, const Draw& draw);
+        Animation animation;
+    };
+
+    const Definition& get(Id id);
+    Id pick(std::mt19937& rng);  // the peak picks its game uniformly
+
+    struct Result {
+        bool won = false;
+        Draw draw;        // the deciding draw
+        int rounds = 1;   // more than one when ties were replayed
+    };
+
+    // Headless play: choice -1 (walking away from the menu) always loses
+    Result resolve(Id id, int choice, std::mt19937& rng);
+
+    // Random game, random choice: what a tensor peak is worth to a player who can't see the screen
+    bool playRandom(std::mt19937& rng);
+}
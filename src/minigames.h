@@ -102,35 +102,3 @@ namespace MinigameUtils {
         getch();
     }
 }
-
-// Remove the duplicate playMinigameMenu() implementation and keep only:
-void Game::playMinigameMenu() {
-    std::vector<std::string> options = {
-        "Coin Toss",
-        "High-Low Cards",
-        "Roulette",
-        "Dice Roll",
-        "Rock Paper Scissors",
-        "Return to Menu"
-    };
-    
-    bool running = true;
-    while(running) {
-        int choice = showMenu(options, "Practice Games");
-        
-        if(choice >= 0 && choice < 5) {
-            bool result = false;
-            switch(choice) {
-                case 0: result = playCoinToss(); break;
-                case 1: result = playHighLow(); break;
-                case 2: result = playRoulette(); break;
-                case 3: result = playDiceRoll(); break;
-                case 4: result = playRPS(); break;
-            }
-            MinigameUtils::drawMinigameResult(result);
-        }
-        else if(choice == 5 || choice == -1) {
-            running = false;
-        }
-    }
-}
\ No newline at end of file
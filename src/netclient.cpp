@@ -0,0 +1,127 @@
+#ifdef _WIN32
+#define NOMINMAX
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+#include "netclient.h"
+
+namespace {
+#ifdef _WIN32
+    using SocketHandle = SOCKET;
+    void closeSocket(SocketHandle s) { closesocket(s); }
+
+    bool startNetworking() {
+        static bool started = [] {
+            WSADATA data;
+            return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+        }();
+        return started;
+    }
+#else
+    using SocketHandle = int;
+    void closeSocket(SocketHandle s) { close(s); }
+    bool startNetworking() { return true; }
+#endif
+}
+
+NetClient::~NetClient() {
+    disconnect();
+}
+
+bool NetClient::connect(const std::string& host, uint16_t port) {
+    disconnect();
+    if (!startNetworking()) return false;
+
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* found = nullptr;
+    if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &found) != 0) return false;
+
+    for (addrinfo* at = found; at; at = at->ai_next) {
+        SocketHandle s = socket(at->ai_family, at->ai_socktype, at->ai_protocol);
+        if (s == SocketHandle(INVALID)) continue;
+        if (::connect(s, at->ai_addr, static_cast<int>(at->ai_addrlen)) == 0) {
+            int on = 1;
+            setsockopt(s, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&on), sizeof(on));
+            sock = static_cast<uintptr_t>(s);
+            break;
+        }
+        closeSocket(s);
+    }
+    freeaddrinfo(found);
+    return connected();
+}
+
+void NetClient::disconnect() {
+    if (connected()) {
+        closeSocket(static_cast<SocketHandle>(sock));
+        sock = INVALID;
+    }
+    buffer.clear();
+    consumed = 0;
+}
+
+bool NetClient::send(Protocol::MessageType type, const void* payload, size_t size) {
+    if (!connected()) return false;
+    outgoing.clear();
+    Protocol::appendFrame(outgoing, type, payload, size);
+
+    size_t sent = 0;
+    while (sent < outgoing.size()) {
+        auto wrote = ::send(static_cast<SocketHandle>(sock), reinterpret_cast<const char*>(outgoing.data() + sent),
+                            static_cast<int>(outgoing.size() - sent), 0);
+        if (wrote <= 0) {
+            disconnect();
+            return false;
+        }
+        sent += wrote;
+    }
+    return true;
+}
+
+bool NetClient::receive(Protocol::Frame& frame, int timeoutMs) {
+    buffer.erase(buffer.begin(), buffer.begin() + consumed);
+    consumed = 0;
+
+    while (connected()) {
+        bool malformed;
+        size_t used = Protocol::parseFrame(buffer.data(), buffer.size(), frame, malformed);
+        if (malformed) {
+            disconnect();
+            return false;
+        }
+        if (used) {
+            consumed = used;
+            return true;
+        }
+
+        SocketHandle s = static_cast<SocketHandle>(sock);
+        fd_set readable;
+        FD_ZERO(&readable);
+        FD_SET(s, &readable);
+        timeval timeout{timeoutMs / 1000, (timeoutMs % 1000) * 1000};
+        int ready = select(static_cast<int>(s) + 1, &readable, nullptr, nullptr, timeoutMs < 0 ? nullptr : &timeout);
+        if (ready == 0) return false;
+        if (ready < 0) {
+            disconnect();
+            return false;
+        }
+
+        char chunk[4096];
+        auto got = recv(s, chunk, sizeof(chunk), 0);
+        if (got <= 0) {
+            disconnect();
+            return false;
+        }
+        buffer.insert(buffer.end(), chunk, chunk + got);
+    }
+    return false;
+}
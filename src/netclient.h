@@ -0,0 +1,32 @@
+#pragma once
+#include "protocol.h"
+
+// Blocking TCP client for the match server, used by the curses front end and the
+// bot harness. Winsock on Windows, BSD sockets everywhere else.
+class NetClient {
+public:
+    NetClient() = default;
+    ~NetClient();
+    NetClient(const NetClient&) = delete;
+    NetClient& operator=(const NetClient&) = delete;
+
+    bool connect(const std::string& host, uint16_t port);
+    void disconnect();
+    bool connected() const { return sock != INVALID; }
+
+    bool send(Protocol::MessageType type, const void* payload = nullptr, size_t size = 0);
+    template <typename T>
+    bool send(Protocol::MessageType type, const T& payload) { return send(type, &payload, sizeof(payload)); }
+
+    // Next frame, waiting up to timeoutMs (-1 = forever). The payload stays valid
+    // until the next receive(). False on timeout or when the connection is lost.
+    bool receive(Protocol::Frame& frame, int timeoutMs = -1);
+
+private:
+    static constexpr uintptr_t INVALID = ~uintptr_t(0);
+
+    uintptr_t sock = INVALID;  // SOCKET on Windows, fd elsewhere
+    std::vector<uint8_t> buffer;
+    std::vector<uint8_t> outgoing;
+    size_t consumed = 0;
+};
@@ -0,0 +1,151 @@
+#include "game.h"
+#include "netclient.h"
+
+namespace {
+    // Line input at the bottom of a boxed screen; empty input keeps the fallback
+    std::string promptLine(const char* label, const std::string& fallback) {
+        clear();
+        box(stdscr, 0, 0);
+        mvprintw(LINES/2 - 1, (COLS-40)/2, "%s", label);
+        mvprintw(LINES/2 + 1, (COLS-40)/2, "> ");
+        refresh();
+
+        char input[64] = {};
+        echo();
+        curs_set(1);
+        getnstr(input, sizeof(input) - 1);
+        noecho();
+        curs_set(0);
+        return input[0] ? input : fallback;
+    }
+
+    void showMessage(const std::string& message, int delayMs = 1500) {
+        clear();
+        box(stdscr, 0, 0);
+        mvprintw(LINES/2, (COLS - static_cast<int>(message.size()))/2, "%s", message.c_str());
+        refresh();
+        napms(delayMs);
+    }
+
+    const char* outcomeText(uint8_t outcome) {
+        switch (outcome) {
+            case Protocol::WIN:           return "You win!";
+            case Protocol::LOSS:          return "You lose.";
+            case Protocol::DRAW:          return "Draw.";
+            case Protocol::OPPONENT_LEFT: return "Opponent left - you win!";
+        }
+        return "Match over";
+    }
+}
+
+// Online match against another player on a match server. The server owns the
+// game; this side only renders the views it receives and sends the chosen action.
+void Game::playOnlineMatch() {
+    std::string address = promptLine("Server (host[:port], blank = localhost):", "127.0.0.1");
+    std::string host = address;
+    uint16_t port = Protocol::DEFAULT_PORT;
+    size_t colon = address.rfind(':');
+    if (colon != std::string::npos) {
+        host = address.substr(0, colon);
+        port = static_cast<uint16_t>(std::atoi(address.c_str() + colon + 1));
+    }
+
+    showMessage("Connecting to " + host + "...", 0);
+    NetClient client;
+    if (!client.connect(host, port) ||
+        !client.send(Protocol::HELLO, Protocol::Hello{Protocol::MAGIC, Protocol::VERSION})) {
+        showMessage("Could not reach a server at " + address);
+        return;
+    }
+
+    GameState view;
+    bool haveView = false;
+    std::vector<Rules::Action> actions;  // empty unless we are to move
+    int selected = 0;
+    const char* result = nullptr;
+    bool redraw = true;
+
+    nodelay(stdscr, TRUE);
+    while (client.connected() && !result) {
+        Protocol::Frame frame;
+        if (client.receive(frame, 50)) {
+            switch (frame.type) {
+                case Protocol::STATE:
+                    haveView = Protocol::readState(frame, view);
+                    actions.clear();
+                    if (haveView && view.isPlayerTurn) {
+                        Rules::legalActions(view, actions);
+                    }
+                    selected = 0;
+                    break;
+                case Protocol::REJECTED:
+                    // Views arrive after every change, so this only happens on a race; ending the turn is always legal
+                    client.send(Protocol::ACTION, Protocol::packAction(Rules::Action::endTurn()));
+                    break;
+                case Protocol::GAME_OVER: {
+                    Protocol::GameOver over{};
+                    Protocol::payloadAs(frame, over);
+                    result = outcomeText(over.outcome);
+                    break;
+                }
+                default:
+                    break;
+            }
+            redraw = true;
+        }
+
+        if (redraw) {
+            if (haveView) {
+                view.printGameState();
+                if (!actions.empty()) {
+                    GameUI::drawStatusBar("Action " + std::to_string(selected + 1) + "/" + std::to_string(actions.size()) +
+                                          ": " + GameUI::describeAction(view, actions[selected]));
+                    GameUI::drawNavigationHints();
+                } else {
+                    GameUI::drawStatusBar("Opponent's turn...");
+                }
+            } else {
+                clear();
+                box(stdscr, 0, 0);
+                mvprintw(LINES/2, (COLS-40)/2, "Waiting for an opponent on %s...", host.c_str());
+                mvprintw(LINES-2, (COLS-20)/2, "ESC to leave");
+            }
+            refresh();
+            redraw = false;
+        }
+
+        int ch = getch();
+        if (ch == ERR) continue;
+        redraw = true;
+        if (ch == 27) {
+            nodelay(stdscr, FALSE);
+            bool leave = promptYesNo(haveView ? "Resign this match?" : "Stop waiting?");
+            nodelay(stdscr, TRUE);
+            if (leave) {
+                client.send(Protocol::RESIGN);
+                break;
+            }
+        } else if (!actions.empty()) {
+            int count = static_cast<int>(actions.size());
+            if (ch == KEY_LEFT) {
+                selected = (selected + count - 1) % count;
+            } else if (ch == KEY_RIGHT) {
+                selected = (selected + 1) % count;
+            } else if (ch == '\n') {
+                client.send(Protocol::ACTION, Protocol::packAction(actions[selected]));
+                actions.clear();  // wait for the server's view before offering anything else
+            }
+        }
+    }
+    nodelay(stdscr, FALSE);
+
+    if (!result && !client.connected()) {
+        result = "Connection to the server was lost";
+    }
+    if (result) {
+        showMessage(result, 0);
+        mvprintw(LINES-2, (COLS-30)/2, "Press any key to continue...");
+        refresh();
+        getch();
+    }
+}
@@ -0,0 +1,269 @@
+#include "ponder.h"
+#include "snapshot.h"
+
+namespace {
+    Ponderer::Key keyOf(const GameState& state) {
+        std::vector<uint8_t> bytes;
+        Snapshot::write(state, nullptr, bytes);
+        return bytes;
+    }
+
+    // Where the enemy turn starts if the player ends theirs from here, or false
+    // when a tensor peak minigame would make that unpredictable
+    bool predictEnemyStart(GameState& state) {
+        if (Rules::toMove(state) != Rules::PLAYER || Rules::result(state) != Rules::ONGOING) return false;
+        Rules::Outcome outcome = Rules::apply(state, Rules::Action::endTurn());
+        return !outcome.tensorPeak && Rules::result(state) == Rules::ONGOING;
+    }
+}
+
+size_t Ponderer::KeyHash::operator()(const Key& key) const {
+    return Snapshot::crc32(key.data(), key.size());
+}
+
+Ponderer::Ponderer(const Evaluator* evaluator)
+    : evaluator(evaluator), worker(&Ponderer::run, this) {}
+
+Ponderer::~Ponderer() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        quitting = true;
+        generation++;
+        cancelFlag = true;
+    }
+    wake.notify_one();
+    published.notify_all();
+    worker.join();
+}
+
+void Ponderer::ponder(const GameState& state) {
+    Key key = keyOf(state);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (key == pendingKey) return;
+        pending = state;
+        pendingKey = std::move(key);
+        hasPending = true;
+        generation++;
+        latest = Hint{};
+        cancelFlag = true;  // the worker clears it when it picks the new position up
+    }
+    wake.notify_one();
+    published.notify_all();
+}
+
+void Ponderer::cancel() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        hasPending = false;
+        pendingKey.clear();
+        generation++;
+        latest = Hint{};
+        cancelFlag = true;
+    }
+    published.notify_all();
+}
+
+bool Ponderer::waitHint(const GameState& state, uint64_t afterRevision, std::chrono::milliseconds timeout, Hint& hint) {
+    Key key = keyOf(state);
+    std::unique_lock<std::mutex> lock(mutex);
+    if (key != pendingKey) return false;
+
+    uint64_t job = generation;
+    auto ready = [&] { return latestGeneration == job && latest.revision > afterRevision; };
+    published.wait_for(lock, timeout, [&] { return generation != job || ready(); });
+    if (generation != job || !ready()) return false;
+    hint = latest;
+    return true;
+}
+
+void Ponderer::setReplyOptions(const Mcts::Options& options) {
+    std::lock_guard<std::mutex> lock(mutex);
+    replyOptions = options;
+    replies = true;
+    // Searches made under the old budget would play differently from the enemy's own
+    cache.clear();
+    insertionOrder.clear();
+    turn++;
+}
+
+bool Ponderer::lookup(const GameState& enemyTurnStart, Mcts::Result& result) {
+    Key key = keyOf(enemyTurnStart);
+    cancel();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto found = cache.find(key);
+    bool hit = found != cache.end();
+    if (hit) {
+        result = std::move(found->second);
+        counters.hits++;
+    } else {
+        counters.misses++;
+    }
+    cache.clear();
+    insertionOrder.clear();
+    turn++;
+    return hit;
+}
+
+Ponderer::Stats Ponderer::stats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return counters;
+}
+
+void Ponderer::run() {
+    while (true) {
+        GameState root;
+        uint64_t job, replyTurn;
+        bool searchesReplies;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this] { return hasPending || quitting; });
+            if (quitting) return;
+            root = pending;
+            job = generation;
+            replyTurn = turn;
+            searchesReplies = replies;
+            hasPending = false;
+            cancelFlag = false;
+            counters.analysed++;
+        }
+        // Hints first: the player may ask for one at any moment
+        std::vector<Rules::Action> plan;
+        analyse(root, job, plan);
+        if (searchesReplies && !cancelFlag) {
+            searchReplies(root, plan, job, replyTurn);
+        }
+    }
+}
+
+void Ponderer::analyse(const GameState& root, uint64_t job, std::vector<Rules::Action>& plan) {
+    TurnSolver solver(evaluator);
+    solver.setCancelFlag(&cancelFlag);
+
+    // The turn solver's plan first: it is all a hint needs, and it is ready at once
+    Hint hint;
+    TurnSolver::Plan solved = solver.solve(root);
+    if (!solved.complete) {
+        std::lock_guard<std::mutex> lock(mutex);
+        counters.cancelled++;
+        return;
+    }
+    hint.actions = solved.actions;
+    plan = hint.actions;
+    std::vector<Rules::Action> actions;
+    Rules::legalActions(root, actions);
+    hint.final = actions.size() == 1;
+    if (!publish(hint, job) || hint.final) return;
+
+    // Then ever larger playout searches for the first action, with the turn re-planned after it
+    Mcts::Options options;
+    options.threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency() / 2));
+    options.seed = job;
+    for (int playouts = FIRST_PLAYOUTS; playouts <= MAX_PLAYOUTS; playouts *= 4) {
+        options.iterations = playouts;
+        Mcts mcts(options);
+        mcts.setCancelFlag(&cancelFlag);
+        Mcts::Result result = mcts.search(root);
+        if (cancelFlag) {
+            std::lock_guard<std::mutex> lock(mutex);
+            counters.cancelled++;
+            return;
+        }
+
+        Hint refined;
+        refined.actions = {result.action};
+        refined.playouts = result.iterations;
+        refined.score = result.score;
+        refined.final = playouts * 4 > MAX_PLAYOUTS;
+        GameState next = root;
+        // After a tensor peak the minigame decides what is left, so the plan stops there
+        if (result.action.type != Rules::Action::END_TURN && !Rules::apply(next, result.action).tensorPeak &&
+            Rules::result(next) == Rules::ONGOING) {
+            TurnSolver::Plan rest = solver.solve(next);
+            if (!rest.complete) continue;  // cancelled; the check above ends the loop
+            refined.actions.insert(refined.actions.end(), rest.actions.begin(), rest.actions.end());
+        }
+        if (!publish(refined, job)) return;
+        plan = refined.actions;
+    }
+}
+
+void Ponderer::searchReplies(const GameState& root, const std::vector<Rules::Action>& plan, uint64_t job, uint64_t replyTurn) {
+    // Most likely first: ending the turn now, then the hint's plan, then every single action
+    std::vector<GameState> starts;
+    GameState start = root;
+    if (predictEnemyStart(start)) {
+        starts.push_back(start);
+    }
+
+    start = root;
+    bool peaked = false;
+    for (const auto& action : plan) {
+        if (action.type == Rules::Action::END_TURN) break;
+        peaked = Rules::apply(start, action).tensorPeak;
+        if (peaked) break;
+    }
+    if (!peaked && predictEnemyStart(start)) {
+        starts.push_back(start);
+    }
+
+    std::vector<Rules::Action> actions;
+    Rules::legalActions(root, actions);
+    for (const auto& action : actions) {
+        if (action.type == Rules::Action::END_TURN) continue;
+        start = root;
+        if (!Rules::apply(start, action).tensorPeak && predictEnemyStart(start)) {
+            starts.push_back(start);
+        }
+    }
+
+    Mcts::Options options;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        options = replyOptions;
+    }
+    Mcts mcts(options);
+    mcts.setCancelFlag(&cancelFlag);
+    for (const auto& enemyStart : starts) {
+        Key key = keyOf(enemyStart);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (generation != job) return;
+            if (cache.count(key)) continue;
+        }
+        Mcts::Result result = mcts.search(enemyStart);
+        if (cancelFlag) {
+            std::lock_guard<std::mutex> lock(mutex);
+            counters.cancelled++;
+            return;
+        }
+        store(std::move(key), std::move(result), replyTurn);
+    }
+}
+
+bool Ponderer::publish(const Hint& hint, uint64_t job) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (generation != job) return false;
+        latest = hint;
+        latest.revision = ++revisions;
+        latestGeneration = job;
+        counters.refinements++;
+    }
+    published.notify_all();
+    return true;
+}
+
+void Ponderer::store(Key key, Mcts::Result result, uint64_t replyTurn) {
+    std::lock_guard<std::mutex> lock(mutex);
+    // A newer position doesn't invalidate the search (it is keyed by its exact start), but a finished turn does
+    if (turn != replyTurn) return;
+    if (cache.size() >= MAX_CACHED) {
+        cache.erase(insertionOrder.front());
+        insertionOrder.pop_front();
+    }
+    insertionOrder.push_back(key);
+    cache.emplace(std::move(key), std::move(result));
+    counters.replies++;
+}
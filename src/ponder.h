@@ -0,0 +1,109 @@
+#pragma once
+#include "mcts.h"
+#include <condition_variable>
+#include <mutex>
+
+// Works on the player's own time: hints for the player, then the enemy's replies.
+//
+// Every time the player is about to choose an action, ponder() hands the
+// position to a worker thread, which does two jobs in turn:
+//
+//   hints    first the whole turn solved with TurnSolver, which takes well under
+//            a millisecond, so a hint is ready almost at once. Then the first
+//            move refined with Mcts at growing playout counts (FIRST_PLAYOUTS,
+//            then four times that, up to MAX_PLAYOUTS), re-planning the rest of
+//            the turn after whichever move the deeper search prefers. Each
+//            result is published as soon as it lands.
+//   replies  the states the enemy turn is likely to start from (ending the turn
+//            now, the hint's plan, each single action followed by ending the
+//            turn), each searched with the enemy's own Mcts options. Results are
+//            cached by the exact bytes of the enemy's starting position, so the
+//            enemy can play a finished search instead of starting one.
+//
+// A newer position or cancel() abandons the search in progress; a cached reply
+// stays valid until lookup() ends the turn it was built for.
+class Ponderer {
+public:
+    static constexpr int FIRST_PLAYOUTS = 250;
+    static constexpr int MAX_PLAYOUTS = 64000;
+    static constexpr size_t MAX_CACHED = 64;
+
+    using Key = std::vector<uint8_t>;  // Snapshot bytes of a position
+
+    struct Hint {
+        uint64_t revision = 0;   // bumped by every publication; 0 while nothing is known
+        std::vector<Rules::Action> actions;  // recommended action, then the turn as far as it can be foreseen
+        int playouts = 0;        // behind the first action; 0 for the turn solver's answer alone
+        float score = 0.5f;      // the first action's playout score for the player, 0 (loss) .. 1 (win)
+        bool final = false;      // no further refinement is coming for this position
+    };
+
+    struct Stats {
+        int analysed = 0;    // positions taken up by the worker
+        int refinements = 0; // hints published
+        int cancelled = 0;   // searches abandoned part way
+        int replies = 0;     // enemy searches finished in the background
+        int hits = 0;        // lookups answered from them
+        int misses = 0;
+    };
+
+    explicit Ponderer(const Evaluator* evaluator);
+    ~Ponderer();
+
+    // Start (or restart) analysing the player's current position.
+    // The state is copied here on the caller's thread; repeats of the same position are ignored.
+    void ponder(const GameState& state);
+
+    // Stop the search in progress and forget the position, e.g. when the enemy starts thinking.
+    // Replies already cached are kept.
+    void cancel();
+
+    // Latest hint for exactly this position. Waits up to timeout for one newer than
+    // afterRevision; false if there is none by then.
+    bool waitHint(const GameState& state, uint64_t afterRevision, std::chrono::milliseconds timeout, Hint& hint);
+
+    // How the enemy searches; replies are only pondered once this has a budget
+    void setReplyOptions(const Mcts::Options& options);
+
+    // Search for an enemy turn starting from exactly this position.
+    // Cancels pondering and drops the cache either way: the turn it was built for is over.
+    bool lookup(const GameState& enemyTurnStart, Mcts::Result& result);
+
+    Stats stats() const;
+
+private:
+    struct KeyHash {
+        size_t operator()(const Key& key) const;
+    };
+
+    void run();
+    void analyse(const GameState& root, uint64_t job, std::vector<Rules::Action>& plan);
+    void searchReplies(const GameState& root, const std::vector<Rules::Action>& plan, uint64_t job, uint64_t replyTurn);
+    bool publish(const Hint& hint, uint64_t job);  // false once the job is stale
+    void store(Key key, Mcts::Result result, uint64_t replyTurn);
+
+    const Evaluator* evaluator;
+
+    mutable std::mutex mutex;
+    std::condition_variable wake;       // the worker waits here for a position
+    std::condition_variable published;  // hint readers wait here for a refinement
+    GameState pending;
+    Key pendingKey;           // snapshot bytes of the last position handed to ponder()
+    bool hasPending = false;
+    bool quitting = false;
+    uint64_t generation = 0;  // bumped whenever the position being analysed is superseded
+    std::atomic<bool> cancelFlag{false};
+
+    Hint latest;              // for the position in pendingKey, generation latestGeneration
+    uint64_t latestGeneration = 0;
+    uint64_t revisions = 0;
+
+    Mcts::Options replyOptions;
+    bool replies = false;     // replyOptions has been set
+    uint64_t turn = 0;        // bumped by lookup(), invalidating everything cached before it
+    std::unordered_map<Key, Mcts::Result, KeyHash> cache;
+    std::deque<Key> insertionOrder;
+    Stats counters;
+
+    std::thread worker;  // last, so everything run() touches is constructed before it starts
+};
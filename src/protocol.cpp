@@ -0,0 +1,96 @@
+#include "protocol.h"
+
+namespace {
+    // Stand-in for cards the receiver is not allowed to see
+    Card hiddenCard() {
+        return Card(Card::TENSOR, uint16_t(0), 0, 0, 0, 0);
+    }
+}
+
+void Protocol::appendFrame(std::vector<uint8_t>& out, MessageType type, const void* payload, size_t size) {
+    FrameHeader header;
+    header.length = static_cast<uint16_t>(size);
+    header.type = type;
+    size_t at = out.size();
+    out.resize(at + sizeof(header) + size);
+    std::memcpy(out.data() + at, &header, sizeof(header));
+    if (size) {
+        std::memcpy(out.data() + at + sizeof(header), payload, size);
+    }
+}
+
+size_t Protocol::parseFrame(const uint8_t* data, size_t size, Frame& frame, bool& malformed) {
+    malformed = false;
+    FrameHeader header;
+    if (size < sizeof(header)) return 0;
+    std::memcpy(&header, data, sizeof(header));
+    if (header.length > MAX_PAYLOAD) {
+        malformed = true;
+        return 0;
+    }
+    if (size < sizeof(header) + header.length) return 0;
+
+    frame.type = static_cast<MessageType>(header.type);
+    frame.payload = data + sizeof(header);
+    frame.size = header.length;
+    return sizeof(header) + header.length;
+}
+
+Protocol::ActionMessage Protocol::packAction(const Rules::Action& action) {
+    return {action.type, action.index, action.target};
+}
+
+Rules::Action Protocol::unpackAction(const ActionMessage& message) {
+    Rules::Action action;
+    action.type = static_cast<Rules::Action::Type>(message.type);
+    action.index = message.index;
+    action.target = message.target;
+    return action;
+}
+
+void Protocol::buildView(const GameState& state, Rules::Side viewer, GameState& view) {
+    Rules::Side other = Rules::opponent(viewer);
+    view.playerHealth = Rules::health(state, viewer);
+    view.enemyHealth = Rules::health(state, other);
+    view.playerEnergy = Rules::energy(state, viewer);
+    view.enemyEnergy = Rules::energy(state, other);
+    view.isPlayerTurn = Rules::toMove(state) == viewer;
+    view.tensor = state.tensor;
+
+    // The view's pool holds only what the viewer may see; hidden cards all share one stand-in
+    view.cards.clear();
+    auto copy = [&](CardHandle card) { return view.cards.add(state.cards.get(card)); };
+    auto copyField = [&](const Field& from, Field& to) {
+        to.clear();
+        for (unsigned live = from.liveMask(); live; live &= live - 1) {
+            int slot = std::countr_zero(live);
+            to.place(slot, copy(from[slot]));
+        }
+    };
+    view.playerHand.clear();
+    for (CardHandle card : Rules::hand(state, viewer)) {
+        view.playerHand.push_back(copy(card));
+    }
+    copyField(Rules::field(state, viewer), view.playerField);
+    copyField(Rules::field(state, other), view.enemyField);
+    CardHandle hidden = view.cards.add(hiddenCard());
+    view.enemyHand.assign(Rules::hand(state, other).size(), hidden);
+    view.deck.assign(state.deck.size(), hidden);
+}
+
+void Protocol::appendState(std::vector<uint8_t>& out, const GameState& state, Rules::Side viewer) {
+    // Scratch buffers are per thread so server workers never share them
+    thread_local GameState view;
+    thread_local std::vector<uint8_t> snapshot;
+    buildView(state, viewer, view);
+    Snapshot::write(view, nullptr, snapshot);
+    appendFrame(out, STATE, snapshot.data(), snapshot.size());
+}
+
+bool Protocol::readState(const Frame& frame, GameState& view) {
+    return frame.type == STATE && Snapshot::read(frame.payload, frame.size, view, nullptr);
+}
+
+void Protocol::seedCardNames() {
+    CardNames::seedCatalogue();
+}
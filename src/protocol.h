@@ -0,0 +1,113 @@
+#pragma once
+#include "rules.h"
+#include "snapshot.h"
+
+// Wire protocol between the match server and its clients (curses front end, bots).
+//
+// Every message is a frame: FrameHeader followed by `length` payload bytes.
+// Positions travel as Snapshot bytes of the receiver's view: the state is
+// mirrored so the receiver is always the "player" side, and the opponent's hand
+// and the deck order are replaced with blank cards. Actions are sent in that
+// same frame, so a client never needs to know which seat it holds.
+//
+//   client                         server
+//   HELLO            ------------>
+//                    <------------ WAITING           (queued for an opponent)
+//                    <------------ MATCH_START
+//                    <------------ STATE             (after every change)
+//   ACTION / RESIGN  ------------>
+//                    <------------ REJECTED          (illegal or out of turn)
+//                    <------------ GAME_OVER
+//   HELLO            ------------> (queue for the next match on the same connection)
+namespace Protocol {
+    constexpr uint32_t MAGIC = 0x4E504354;  // "TCPN"
+    constexpr uint16_t VERSION = 2;  // 2: snapshots with fixed field slots
+    constexpr uint16_t DEFAULT_PORT = 7777;
+    constexpr size_t MAX_PAYLOAD = 2048;
+
+    enum MessageType : uint8_t {
+        // client -> server
+        HELLO = 1,
+        ACTION,
+        RESIGN,
+        // server -> client
+        WAITING = 16,
+        MATCH_START,
+        STATE,
+        REJECTED,
+        GAME_OVER
+    };
+
+    enum Outcome : uint8_t {
+        WIN,
+        LOSS,
+        DRAW,
+        OPPONENT_LEFT  // counts as a win
+    };
+
+    #pragma pack(push, 1)
+    struct FrameHeader {
+        uint16_t length;  // payload bytes
+        uint8_t type;
+    };
+
+    struct Hello {
+        uint32_t magic;
+        uint16_t version;
+    };
+
+    struct ActionMessage {
+        uint8_t type;
+        int8_t index;
+        int8_t target;
+    };
+
+    struct MatchStart {
+        uint32_t matchId;
+        uint8_t movesFirst;  // 1 if the receiver takes the first turn
+    };
+
+    struct GameOver {
+        uint8_t outcome;
+    };
+    #pragma pack(pop)
+
+    constexpr size_t MAX_FRAME = sizeof(FrameHeader) + MAX_PAYLOAD;  // the largest frame parseFrame accepts
+
+    // Appends one framed message to out
+    void appendFrame(std::vector<uint8_t>& out, MessageType type, const void* payload = nullptr, size_t size = 0);
+
+    template <typename T>
+    void appendFrame(std::vector<uint8_t>& out, MessageType type, const T& payload) {
+        appendFrame(out, type, &payload, sizeof(payload));
+    }
+
+    struct Frame {
+        MessageType type;
+        const uint8_t* payload;
+        size_t size;
+    };
+
+    // Bytes consumed by the first complete frame in data, 0 if it is still incomplete.
+    // Sets malformed when the header announces an oversized payload.
+    size_t parseFrame(const uint8_t* data, size_t size, Frame& frame, bool& malformed);
+
+    template <typename T>
+    bool payloadAs(const Frame& frame, T& out) {
+        if (frame.size != sizeof(T)) return false;
+        std::memcpy(&out, frame.payload, sizeof(T));
+        return true;
+    }
+
+    ActionMessage packAction(const Rules::Action& action);
+    Rules::Action unpackAction(const ActionMessage& message);
+
+    // Receiver-relative copy of state (see the header comment)
+    void buildView(const GameState& state, Rules::Side viewer, GameState& view);
+    void appendState(std::vector<uint8_t>& out, const GameState& state, Rules::Side viewer);
+    bool readState(const Frame& frame, GameState& view);
+
+    // Card names are sent as ids, so both ends must intern the deck's names first and in
+    // the same order (CardNames::seedCatalogue). Call once before any threads start.
+    void seedCardNames();
+}
@@ -0,0 +1,169 @@
+#include "rollout.h"
+
+namespace {
+    constexpr uint32_t END_TURN_PERCENT = 15;
+
+    // Index of the n-th set bit of mask (n counts from 0)
+    int nthBit(unsigned mask, int n) {
+        for (; n > 0; n--) mask &= mask - 1;
+        return std::countr_zero(mask);
+    }
+
+    // Number of moves each hand card type offers (champion, artifact, tensor) given the field size
+    std::array<int, 3> playWeights(int fieldCount, int fieldSize) {
+        return {fieldCount < fieldSize, fieldCount, 1};
+    }
+
+    // Champions that can attack; fieldMasks() without the faction bookkeeping
+    unsigned readyMask(const CardPool& cards, const Field& field) {
+        unsigned ready = 0;
+        for (unsigned live = field.liveMask(); live; live &= live - 1) {
+            int slot = std::countr_zero(live);
+            CardHandle card = field[slot];
+            bool canAttack = cards.type[card] == Card::CHAMPION && cards.turnsInPlay[card] > 0 && !cards.attacked[card];
+            ready |= unsigned(canAttack) << slot;
+        }
+        return ready;
+    }
+
+    void restart(GameState& lane, const GameState& root, Rollout::Rng& rng) {
+        lane = root;
+        lane.lazyDeck = true;
+        lane.drawState = rng.next();
+    }
+
+    void score(Rollout::Tally& tally, Rules::Result result, Rules::Side side) {
+        if (result == Rules::DRAW || result == Rules::ONGOING) {
+            tally.draws++;
+        } else if ((result == Rules::PLAYER_WIN) == (side == Rules::PLAYER)) {
+            tally.wins++;
+        } else {
+            tally.losses++;
+        }
+    }
+
+    template <class Policy>
+    Rules::Result playoutWith(GameState& state, Rollout::Rng& rng, std::mt19937& peakRng, int& plies) {
+        Rules::Result result;
+        for (plies = 0; (result = Rules::result(state)) == Rules::ONGOING && plies < Rollout::MAX_PLIES; plies++) {
+            if (Rules::applyUnchecked<Policy>(state, Rollout::randomAction<Policy>(state, rng)).tensorPeak) {
+                Rules::resolveTensorPeak<Policy>(state, peakRng);
+            }
+        }
+        return result;
+    }
+
+    // run() for one rules policy; every lane shares the root's rules
+    template <class Policy>
+    Rollout::Tally runWith(const GameState& root, Rules::Side side, int count, Rollout::Rng& rng, int lanes) {
+        Rollout::Tally tally;
+        std::mt19937 peakRng(static_cast<uint32_t>(rng.next()));
+
+        std::array<GameState, Rollout::MAX_LANES> states;
+        std::array<int, Rollout::MAX_LANES> plies{};
+        int active = std::min(lanes, count);
+        int started = active;
+        for (int l = 0; l < active; l++) {
+            restart(states[l], root, rng);
+        }
+
+        while (active > 0) {
+            for (int l = 0; l < active; ) {
+                GameState& state = states[l];
+                Rules::Result result = Rules::result(state);
+                if (result == Rules::ONGOING && plies[l] < Rollout::MAX_PLIES) {
+                    if (Rules::applyUnchecked<Policy>(state, Rollout::randomAction<Policy>(state, rng)).tensorPeak) {
+                        Rules::resolveTensorPeak<Policy>(state, peakRng);
+                    }
+                    plies[l]++;
+                    l++;
+                    continue;
+                }
+
+                score(tally, result, side);
+                tally.plies += plies[l];
+                plies[l] = 0;
+                if (started < count) {
+                    restart(state, root, rng);
+                    started++;
+                    l++;
+                } else {
+                    // Retire the lane: the last active one takes its place
+                    active--;
+                    std::swap(states[l], states[active]);
+                    std::swap(plies[l], plies[active]);
+                }
+            }
+        }
+        return tally;
+    }
+}
+
+uint64_t Rollout::Rng::next() {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+template <class Policy>
+Rules::Action Rollout::randomAction(const GameState& state, Rng& rng) {
+    // Ending the turn doesn't depend on what else is legal, so decide it before counting anything
+    if (rng.below(100) < END_TURN_PERCENT) return Rules::Action::endTurn();
+
+    Rules::Side side = Rules::toMove(state);
+    const CardPool& cards = state.cards;
+    const auto& ownHand = Rules::hand(state, side);
+    const Field& ownField = Rules::field(state, side);
+    unsigned defenders = Rules::field(state, Rules::opponent(side)).liveMask();
+    int energy = Rules::energy(state, side);
+    const std::array<int, 3> weights = playWeights(ownField.count(), Policy::of(state).fieldSize);
+
+    // Weights without branches: a card too expensive to play weighs nothing
+    int plays = 0;
+    for (CardHandle card : ownHand) {
+        plays += weights[cards.type[card]] & -int(cards.cost[card] <= energy);
+    }
+    unsigned ready = readyMask(cards, ownField);
+    int targets = 1 + std::popcount(defenders);
+    int moves = plays + std::popcount(ready) * targets;
+    if (moves == 0) return Rules::Action::endTurn();
+
+    int pick = static_cast<int>(rng.below(moves));
+    if (pick >= plays) {
+        pick -= plays;
+        int attacker = nthBit(ready, pick / targets);
+        int target = pick % targets;
+        return Rules::Action::attack(attacker, target == 0 ? -1 : nthBit(defenders, target - 1));
+    }
+    for (size_t i = 0; ; i++) {
+        CardHandle card = ownHand[i];
+        int weight = weights[cards.type[card]] & -int(cards.cost[card] <= energy);
+        if (pick < weight) {
+            if (cards.type[card] == Card::ARTIFACT) {
+                return Rules::Action::play(i, nthBit(ownField.liveMask(), pick));
+            }
+            return Rules::Action::play(i);
+        }
+        pick -= weight;
+    }
+}
+
+template Rules::Action Rollout::randomAction<Rules::Standard>(const GameState&, Rng&);
+template Rules::Action Rollout::randomAction<Rules::Configured>(const GameState&, Rng&);
+
+Rules::Action Rollout::randomAction(const GameState& state, Rng& rng) {
+    return Rules::isStandard(state) ? randomAction<Rules::Standard>(state, rng) : randomAction<Rules::Configured>(state, rng);
+}
+
+Rules::Result Rollout::playout(GameState& state, Rng& rng, std::mt19937& peakRng, int& plies) {
+    return Rules::isStandard(state) ? playoutWith<Rules::Standard>(state, rng, peakRng, plies)
+                                    : playoutWith<Rules::Configured>(state, rng, peakRng, plies);
+}
+
+Rollout::Tally Rollout::run(const GameState& root, Rules::Side side, int count, uint64_t seed, int lanes) {
+    lanes = std::clamp(lanes, 1, MAX_LANES);
+    Rng rng(seed);
+    return Rules::isStandard(root) ? runWith<Rules::Standard>(root, side, count, rng, lanes)
+                                   : runWith<Rules::Configured>(root, side, count, rng, lanes);
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include "rules.h"
+
+// Fast random playouts for search.
+//
+// The policy is the simulator's usual random player: it ends the turn 15% of
+// the time when anything else is legal, and otherwise picks uniformly among
+// the other legal moves, in the same order Rules::legalActions() lists them.
+// It never builds that list. The moves are counted from the hand and the
+// field masks, and the chosen one is decoded straight from its index. It is
+// then applied without re-checking legality, and peaks are resolved headless.
+//
+// run() can step several lanes (independent playouts from the same root) in
+// lockstep, one move per lane per round, refilling a finished lane from the
+// root. That keeps unrelated states in flight so one lane's cache misses and
+// mispredicted branches can overlap with the others' work. Whether it pays
+// depends on the machine: rolloutbench measures it, and on a single-core box
+// one lane was as fast as any, hence the default. Every playout redraws the
+// unseen deck in a fresh random order, so the root's deck order (or lazy draw
+// state) is never trusted.
+namespace Rollout {
+    constexpr int DEFAULT_LANES = 1;
+    constexpr int MAX_LANES = 16;
+    constexpr int MAX_PLIES = 400;  // a playout still going after this many moves counts as a draw
+
+    // splitmix64: one add and three multiply-xorshifts per number, state is one word
+    class Rng {
+    public:
+        explicit Rng(uint64_t seed) : state(seed) {}
+        uint64_t next();
+        uint32_t below(uint32_t n) { return static_cast<uint32_t>(((next() >> 32) * n) >> 32); }
+
+    private:
+        uint64_t state;
+    };
+
+    struct Tally {
+        int wins = 0;       // for the side run() was asked about
+        int draws = 0;      // including playouts cut off at MAX_PLIES
+        int losses = 0;
+        long long plies = 0;
+
+        int playouts() const { return wins + draws + losses; }
+        float score() const { return playouts() ? (wins + 0.5f * draws) / playouts() : 0.5f; }
+    };
+
+    // The policy's move; the state must be ONGOING. The template is compiled for
+    // Rules::Standard and Rules::Configured; the plain overload picks by state.rules.
+    template <class Policy> Rules::Action randomAction(const GameState& state, Rng& rng);
+    Rules::Action randomAction(const GameState& state, Rng& rng);
+
+    // Plays state out in place; returns the result (DRAW also for a MAX_PLIES cut-off)
+    Rules::Result playout(GameState& state, Rng& rng, std::mt19937& peakRng, int& plies);
+
+    // count playouts from root, scored for side, lanes of them at a time (1..MAX_LANES)
+    Tally run(const GameState& root, Rules::Side side, int count, uint64_t seed, int lanes = DEFAULT_LANES);
+}
@@ -0,0 +1,120 @@
+// Playout throughput benchmark for the search rollouts.
+//
+//   rolloutbench [playouts] [seed]
+//
+// Plays the same number of random playouts from a set of seeded positions,
+// once with the plain simulator loop (Rules::legalActions, Rules::step and
+// std::mt19937, as the trainer and uibench do) and then through Rollout::run()
+// at several lane counts. The last row repeats one lane under a copy of the
+// standard rules, which takes the engine's Rules::Configured instantiation
+// (constants read from the RuleSet at run time) instead of Rules::Standard
+// (constants folded in): same games, so only the speed may differ. Everything
+// runs on the calling thread, so the numbers are per core.
+
+#include "rollout.h"
+
+namespace {
+    constexpr int ROOTS = 32;
+
+    // Positions a few turns into seeded matches, where search would start from
+    std::vector<GameState> makeRoots(uint32_t seed) {
+        std::mt19937 rng(seed);
+        Rollout::Rng policy(seed);
+        std::vector<GameState> roots;
+        while (roots.size() < ROOTS) {
+            GameState state;
+            Rules::setupGame(state, rng);
+            int plies = static_cast<int>(rng() % 30);
+            for (int i = 0; i < plies && Rules::result(state) == Rules::ONGOING; i++) {
+                Rules::step(state, Rollout::randomAction(state, policy), rng);
+            }
+            if (Rules::result(state) == Rules::ONGOING) roots.push_back(state);
+        }
+        return roots;
+    }
+
+    double seconds(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void report(const char* name, int playouts, long long plies, double wins, double elapsed) {
+        std::cout << std::left << std::setw(22) << name << std::right << std::fixed
+                  << std::setw(12) << std::setprecision(0) << playouts / elapsed
+                  << std::setw(10) << std::setprecision(1) << elapsed * 1e9 / plies
+                  << std::setw(10) << std::setprecision(1) << static_cast<double>(plies) / playouts
+                  << std::setw(10) << std::setprecision(3) << wins / playouts << "\n";
+    }
+}
+
+int main(int argc, char** argv) {
+    int playouts = argc > 1 ? std::atoi(argv[1]) : 200000;
+    uint32_t seed = argc > 2 ? static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10)) : 1;
+    if (playouts < ROOTS) {
+        std::cerr << "Need at least " << ROOTS << " playouts\n";
+        return 1;
+    }
+
+    std::vector<GameState> roots = makeRoots(seed);
+    int perRoot = playouts / ROOTS;
+    playouts = perRoot * ROOTS;
+    std::cout << "Rollout benchmark: " << playouts << " playouts from " << ROOTS << " positions, one thread\n\n";
+    std::cout << std::left << std::setw(22) << "loop" << std::right << std::setw(12) << "playouts/s"
+              << std::setw(10) << "ns/ply" << std::setw(10) << "plies" << std::setw(10) << "mover" << "\n";
+
+    // The simulator loop, for comparison: the same policy over the materialized move list
+    {
+        std::mt19937 rng(seed);
+        std::vector<Rules::Action> actions;
+        long long plies = 0;
+        double wins = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (const GameState& root : roots) {
+            Rules::Side mover = Rules::toMove(root);
+            for (int p = 0; p < perRoot; p++) {
+                GameState state = root;
+                state.lazyDeck = true;
+                state.drawState = (uint64_t(rng()) << 32) | rng();
+                int ply = 0;
+                for (; Rules::result(state) == Rules::ONGOING && ply < Rollout::MAX_PLIES; ply++) {
+                    Rules::legalActions(state, actions);
+                    bool endTurn = actions.size() == 1 || rng() % 100 < 15;
+                    Rules::step(state, endTurn ? actions.back() : actions[rng() % (actions.size() - 1)], rng);
+                }
+                Rules::Result result = Rules::result(state);
+                wins += result == Rules::DRAW || result == Rules::ONGOING ? 0.5
+                      : (result == Rules::PLAYER_WIN) == (mover == Rules::PLAYER);
+                plies += ply;
+            }
+        }
+        report("legalActions + step", playouts, plies, wins, seconds(start));
+    }
+
+    for (int lanes : {1, 4, 8, 16}) {
+        long long plies = 0;
+        double wins = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t r = 0; r < roots.size(); r++) {
+            Rollout::Tally tally = Rollout::run(roots[r], Rules::toMove(roots[r]), perRoot, seed + r, lanes);
+            plies += tally.plies;
+            wins += tally.wins + 0.5 * tally.draws;
+        }
+        std::string name = "Rollout::run x" + std::to_string(lanes);
+        report(name.c_str(), playouts, plies, wins, seconds(start));
+    }
+
+    {
+        static const RuleSet copy = RuleSet::STANDARD;
+        long long plies = 0;
+        double wins = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t r = 0; r < roots.size(); r++) {
+            GameState root = roots[r];
+            root.rules = &copy;
+            Rollout::Tally tally = Rollout::run(root, Rules::toMove(root), perRoot, seed + r, 1);
+            plies += tally.plies;
+            wins += tally.wins + 0.5 * tally.draws;
+        }
+        report("x1 configured rules", playouts, plies, wins, seconds(start));
+    }
+    return 0;
+}
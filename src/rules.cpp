@@ -0,0 +1,512 @@
+#include "rules.h"
+#include "minigames.h"
+#include "minigame_engine.h"
+#include "effects.h"
+
+namespace {
+    template <class Policy>
+    bool canPlay(const GameState& state, Rules::Side side, CardHandle card) {
+        if (state.cards.cost[card] > Rules::energy(state, side)) return false;
+        switch (state.cards.type[card]) {
+            case Card::CHAMPION: return Rules::field(state, side).count() < Policy::of(state).fieldSize;
+            case Card::ARTIFACT: return !Rules::field(state, side).empty();
+            case Card::TENSOR:   return true;
+        }
+        return false;
+    }
+
+    bool canAttack(const CardPool& cards, CardHandle card) {
+        return cards.type[card] == Card::CHAMPION && cards.turnsInPlay[card] > 0 && !cards.attacked[card];
+    }
+
+    // Scripts may write any value (see effects.h). Afterwards, put back what the rest of the
+    // engine relies on: no negative energy or hand costs, the gauge within 0..maximum, no
+    // destroyed champion on the field, and champion stats no lower than the buffs allow.
+    template <class Policy>
+    void settleEffects(GameState& state) {
+        if (Effects::stock()) return;  // the stock script never leaves those ranges, and rollouts feel every pass
+        auto& cards = state.cards;
+        for (Rules::Side side : {Rules::PLAYER, Rules::ENEMY}) {
+            int& energy = Rules::energy(state, side);
+            energy = std::max(energy, 0);
+            for (CardHandle card : Rules::hand(state, side)) {
+                cards.cost[card] = std::max<int8_t>(cards.cost[card], 0);
+            }
+
+            Field& field = Rules::field(state, side);
+            for (unsigned live = field.liveMask(); live; live &= live - 1) {
+                int slot = std::countr_zero(live);
+                if (cards.health[field[slot]] <= 0) field.remove(slot);
+            }
+            int concordia = Rules::fieldMasks(state, side).concordia() ? Policy::of(state).concordiaAttack : 0;
+            for (CardHandle card : field) {
+                int floor = std::min(cards.originalAttack[card] + concordia, 127);
+                cards.attack[card] = static_cast<int8_t>(std::max<int>(cards.attack[card], floor));
+                cards.turnsInPlay[card] = std::clamp<int8_t>(cards.turnsInPlay[card], 0, 1);
+            }
+        }
+        state.tensor.current = std::clamp(state.tensor.current, 0, state.tensor.maximum);
+    }
+
+    uint64_t splitMix64(uint64_t& state) {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    // One partial Fisher-Yates step: a uniform pick among the cards left becomes the top
+    void sampleTop(GameState& state) {
+        uint64_t bits = splitMix64(state.drawState) >> 32;
+        size_t pick = static_cast<size_t>((bits * state.deck.size()) >> 32);
+        std::swap(state.deck[pick], state.deck.back());
+    }
+}
+
+namespace {
+    constexpr bool standardStakesMatch() {
+        const RuleSet& rules = RuleSet::STANDARD;
+        if (rules.stakeCount != static_cast<int>(MinigameUtils::CONSEQUENCES.size())) return false;
+        for (int i = 0; i < rules.stakeCount; i++) {
+            const auto& consequence = MinigameUtils::CONSEQUENCES[i];
+            if (rules.stakes[i].health != (consequence.type == MinigameUtils::Consequence::HEALTH)) return false;
+            if (rules.stakes[i].value != consequence.value) return false;
+        }
+        return true;
+    }
+    static_assert(standardStakesMatch(), "RuleSet's default stakes must be the minigame consequence table");
+    static_assert(RuleSet::STANDARD.fieldSize == static_cast<int>(MAX_FIELD_SIZE) &&
+                  RuleSet::STANDARD.tensorStart == GameState::TensorState{}.maximum &&
+                  RuleSet::STANDARD.tensorCap == GameState::TensorState::ABSOLUTE_MAX,
+                  "the standard rules must match the constants the UI draws with");
+}
+
+const char* RuleSet::validate() const {
+    if (startingHealth < 1 || startingHealth > 127) return "starting health must be 1..127";
+    if (startingEnergy < 0 || startingEnergy > 127) return "starting energy must be 0..127";
+    if (tensorStart < 1 || tensorStart > tensorCap || tensorCap > MAX_TENSOR) return "tensor maximums must satisfy 1 <= start <= cap <= 15";
+    if (concordiaAttack < 0 || concordiaHealth < 0) return "Tensor Concordia can't take stats away";
+    if (synergyCards < 1 || synergyCards > static_cast<int>(MAX_FIELD_SIZE)) return "synergy needs 1..4 cards";
+    if (synergyMaxLevel < 1) return "synergy level cap must be at least 1";
+    if (fieldSize < 1 || fieldSize > static_cast<int>(MAX_FIELD_SIZE)) return "field size must be 1..4";
+    if (champions < 0 || artifacts < 0 || tensors < 0 || deckSize() > static_cast<int>(CardPool::CAPACITY)) {
+        return "the deck holds at most 64 cards";
+    }
+    if (startingHand < 0 || startingHand > Rules::MAX_HAND_SLOTS) return "the starting hand must be 0..10 cards";
+    if (deckSize() < 2 * startingHand) return "the deck must cover both starting hands";
+    if (stakeCount < 1 || stakeCount > static_cast<int>(MAX_STAKES)) return "there must be 1..8 stakes";
+    for (int i = 0; i < stakeCount; i++) {
+        if (stakes[i].value < 0) return "stakes can't be negative";
+    }
+    return nullptr;
+}
+
+int Rules::actionSlot(const Action& action) {
+    switch (action.type) {
+        case Action::PLAY_CARD:
+            return action.index < MAX_HAND_SLOTS ? action.index : -1;
+        case Action::ATTACK:
+            return MAX_HAND_SLOTS + action.index * TARGET_SLOTS + (action.target + 1);
+        case Action::END_TURN:
+            return NUM_ACTION_SLOTS - 1;
+    }
+    return -1;
+}
+
+void Rules::setupGame(GameState& state, std::mt19937& rng, DeckOrder order, const RuleSet& rules) {
+    state = GameState{};
+    state.rules = &rules;
+    state.playerHealth = state.enemyHealth = rules.startingHealth;
+    state.playerEnergy = state.enemyEnergy = rules.startingEnergy;
+    state.initializeDeck(rng, order == LAZY_DECK);
+    for (int i = 0; i < rules.startingHand; i++) {
+        drawCard(state, PLAYER);
+        drawCard(state, ENEMY);
+    }
+}
+
+Rules::Result Rules::result(const GameState& state) {
+    if (state.playerHealth <= 0 && state.enemyHealth <= 0) return DRAW;
+    if (state.playerHealth <= 0) return ENEMY_WIN;
+    if (state.enemyHealth <= 0) return PLAYER_WIN;
+    return ONGOING;
+}
+
+int Rules::synergyLevel(const GameState& state, Side side, Card::Faction faction) {
+    return fieldMasks(state, side).synergyLevel(faction, *state.rules);
+}
+
+void Rules::applySynergyEffects(GameState& state, Side side, Card::Faction faction, int level) {
+    auto& cards = state.cards;
+    bool tensorConcordiaActive = fieldMasks(state, side).concordia();
+    uint32_t fieldEffect = Effects::entry(Effects::FIELD, faction);
+    uint32_t handEffect = Effects::entry(Effects::HAND, faction);
+    uint32_t concordiaEffect = tensorConcordiaActive ? Effects::entry(Effects::CONCORDIA, 0) : 0;
+    Effects::Context context(state, side, level);
+
+    // Reset stats and apply new buffs
+    for (CardHandle card : field(state, side)) {
+        if (cards.type[card] == Card::CHAMPION) {
+            cards.attack[card] = cards.originalAttack[card];
+            cards.health[card] = cards.originalHealth[card];
+            context.self = context.target = card;
+
+            if (fieldEffect && cards.faction[card] == faction) {
+                Effects::run(fieldEffect, context);
+            }
+            if (concordiaEffect) {
+                Effects::run(concordiaEffect, context);
+            }
+        }
+    }
+
+    // EXEC's stock synergy works on the hand (cost reduction)
+    if (handEffect) {
+        for (CardHandle card : hand(state, side)) {
+            if (cards.faction[card] == faction) {
+                context.self = context.target = card;
+                Effects::run(handEffect, context);
+            }
+        }
+    }
+}
+
+template <class Policy>
+bool Rules::applySynergies(GameState& state, Side side) {
+    FieldMasks masks = fieldMasks(state, side);
+    const RuleSet& rules = Policy::of(state);
+
+    for (int f = Card::TECHNO; f <= Card::VIRTU_MACHINA; f++) {
+        auto faction = static_cast<Card::Faction>(f);
+        if (masks.synergy(faction, rules)) {
+            applySynergyEffects(state, side, faction, masks.synergyLevel(faction, rules));
+        }
+    }
+
+    bool tensorConcordiaActive = masks.concordia();
+    uint32_t concordiaEffect = Effects::entry(Effects::CONCORDIA, 0);
+    if (tensorConcordiaActive && concordiaEffect) {
+        Effects::Context context(state, side);
+        for (CardHandle card : field(state, side)) {
+            if (state.cards.type[card] == Card::CHAMPION) {
+                context.self = context.target = card;
+                Effects::run(concordiaEffect, context);
+            }
+        }
+    }
+    return tensorConcordiaActive;
+}
+
+template <class Policy>
+bool Rules::isLegal(const GameState& state, const Action& action) {
+    if (result(state) != ONGOING) return false;
+
+    Side side = toMove(state);
+    const auto& ownHand = hand(state, side);
+    const auto& ownField = field(state, side);
+
+    switch (action.type) {
+        case Action::PLAY_CARD: {
+            if (action.index < 0 || action.index >= static_cast<int>(ownHand.size())) return false;
+            CardHandle card = ownHand[action.index];
+            if (!canPlay<Policy>(state, side, card)) return false;
+            if (state.cards.type[card] == Card::ARTIFACT) {
+                return ownField.occupied(action.target);
+            }
+            return true;
+        }
+        case Action::ATTACK: {
+            if (!ownField.occupied(action.index)) return false;
+            if (!canAttack(state.cards, ownField[action.index])) return false;
+            return action.target == -1 || field(state, opponent(side)).occupied(action.target);
+        }
+        case Action::END_TURN:
+            return true;
+    }
+    return false;
+}
+
+template <class Policy>
+void Rules::legalActions(const GameState& state, std::vector<Action>& out) {
+    out.clear();
+    if (result(state) != ONGOING) return;
+
+    Side side = toMove(state);
+    const auto& ownHand = hand(state, side);
+    const auto& ownField = field(state, side);
+    unsigned defenders = field(state, opponent(side)).liveMask();
+
+    for (size_t i = 0; i < ownHand.size(); i++) {
+        CardHandle card = ownHand[i];
+        if (!canPlay<Policy>(state, side, card)) continue;
+        if (state.cards.type[card] == Card::ARTIFACT) {
+            for (unsigned live = ownField.liveMask(); live; live &= live - 1) {
+                out.push_back(Action::play(i, std::countr_zero(live)));
+            }
+        } else {
+            out.push_back(Action::play(i));
+        }
+    }
+
+    for (unsigned ready = fieldMasks(state, side).ready; ready; ready &= ready - 1) {
+        int i = std::countr_zero(ready);
+        out.push_back(Action::attack(i, -1));
+        for (unsigned live = defenders; live; live &= live - 1) {
+            out.push_back(Action::attack(i, std::countr_zero(live)));
+        }
+    }
+
+    out.push_back(Action::endTurn());
+}
+
+bool Rules::drawCard(GameState& state, Side side) {
+    if (state.deck.empty()) {
+        // Running out of cards decides the match on remaining health
+        if (state.playerHealth > state.enemyHealth) {
+            state.enemyHealth = 0;
+        } else if (state.enemyHealth > state.playerHealth) {
+            state.playerHealth = 0;
+        } else {
+            state.playerHealth = state.enemyHealth = 0;
+        }
+        return false;
+    }
+    if (state.lazyDeck) sampleTop(state);
+    hand(state, side).push_back(state.deck.back());
+    state.deck.pop_back();
+    return true;
+}
+
+void Rules::determinize(GameState& state, Side observer, uint64_t seed) {
+    auto& hidden = hand(state, opponent(observer));
+    size_t count = hidden.size();
+    state.deck.insert(state.deck.end(), hidden.begin(), hidden.end());
+    hidden.clear();
+
+    state.lazyDeck = true;
+    state.drawState = seed;
+    for (size_t i = 0; i < count; i++) {
+        sampleTop(state);
+        hidden.push_back(state.deck.back());
+        state.deck.pop_back();
+    }
+}
+
+template <class Policy>
+Rules::Outcome Rules::apply(GameState& state, const Action& action) {
+    if (!isLegal<Policy>(state, action)) return Outcome{};
+    return applyUnchecked<Policy>(state, action);
+}
+
+template <class Policy>
+Rules::Outcome Rules::applyUnchecked(GameState& state, const Action& action) {
+    Outcome outcome;
+    outcome.legal = true;
+
+    Side side = toMove(state);
+    auto& ownHand = hand(state, side);
+    auto& ownField = field(state, side);
+    auto& cards = state.cards;
+
+    switch (action.type) {
+        case Action::PLAY_CARD: {
+            CardHandle card = ownHand[action.index];
+            ownHand.erase(ownHand.begin() + action.index);
+            energy(state, side) -= cards.cost[card];
+
+            // What the card does is its play effect (see effects.h); champions then join the synergies
+            if (cards.type[card] == Card::CHAMPION) {
+                cards.turnsInPlay[card] = 0;  // newly placed champion
+                ownField.place(card);
+            }
+            if (uint32_t effect = Effects::playEntry(cards, card)) {
+                Effects::Context context(state, side);
+                context.self = card;
+                context.target = cards.type[card] == Card::ARTIFACT ? ownField[action.target] : card;
+                Effects::run(effect, context);
+            }
+            if (cards.type[card] == Card::CHAMPION) {
+                outcome.concordia = applySynergies<Policy>(state, side);
+            }
+            settleEffects<Policy>(state);
+            break;
+        }
+
+        case Action::ATTACK: {
+            CardHandle attacker = ownField[action.index];
+            int damage = cards.attack[attacker];
+            cards.attacked[attacker] = true;
+            outcome.damage = damage;
+
+            if (action.target < 0) {
+                health(state, opponent(side)) -= damage;
+            } else {
+                auto& defenders = field(state, opponent(side));
+                CardHandle defender = defenders[action.target];
+                cards.health[defender] = static_cast<int8_t>(std::max(cards.health[defender] - damage, -128));
+                if (cards.health[defender] <= 0) {
+                    defenders.remove(action.target);
+                    outcome.destroyed = true;
+                }
+            }
+            break;
+        }
+
+        case Action::END_TURN: {
+            for (CardHandle champ : ownField) {
+                if (cards.type[champ] == Card::CHAMPION) {
+                    if (cards.turnsInPlay[champ] == 0) {
+                        cards.turnsInPlay[champ] = 1;
+                    }
+                    cards.attacked[champ] = false;
+                }
+            }
+
+            // Turn-end synergies (Virtu-Machina pays out energy and feeds the tensor)
+            FieldMasks masks = fieldMasks(state, side);
+            const RuleSet& rules = Policy::of(state);
+            for (int f = Card::TECHNO; f <= Card::VIRTU_MACHINA; f++) {
+                auto faction = static_cast<Card::Faction>(f);
+                uint32_t effect = Effects::entry(Effects::END_TURN, f);
+                if (effect && masks.synergy(faction, rules)) {
+                    Effects::Context context(state, side, masks.synergyLevel(faction, rules));
+                    Effects::run(effect, context);
+                }
+            }
+
+            state.isPlayerTurn = !state.isPlayerTurn;
+            energy(state, side) += 1;
+            drawCard(state, side);
+            outcome.concordia = applySynergies<Policy>(state, side);
+            settleEffects<Policy>(state);
+            break;
+        }
+    }
+
+    outcome.tensorPeak = state.tensor.current >= state.tensor.maximum;
+    return outcome;
+}
+
+template <class Policy>
+void Rules::resolveTensorPeak(GameState& state, bool playerWon, int consequenceIndex) {
+    const RuleSet& rules = Policy::of(state);
+    // The curses UI draws from the standard table; past this variant's stakes it gets the last one
+    const RuleSet::Stake& stake = rules.stakes[std::clamp(consequenceIndex, 0, rules.stakeCount - 1)];
+    if (playerWon) {
+        if (!stake.health) {
+            state.playerEnergy += stake.value;
+        } else {
+            state.playerHealth = std::min(state.playerHealth + stake.value, rules.startingHealth);
+        }
+    } else {
+        if (!stake.health) {
+            state.playerEnergy = std::max(0, state.playerEnergy - stake.value);
+        } else {
+            state.playerHealth -= stake.value;
+        }
+    }
+
+    state.tensor.current = 0;
+    if (state.tensor.maximum < rules.tensorCap) {
+        state.tensor.maximum++;
+    }
+}
+
+template <class Policy>
+void Rules::resolveTensorPeak(GameState& state, std::mt19937& rng) {
+    bool won = Minigames::playRandom(rng);
+    int consequence = static_cast<int>(rng() % Policy::of(state).stakeCount);
+    resolveTensorPeak<Policy>(state, won, consequence);
+}
+
+template <class Policy>
+Rules::Outcome Rules::step(GameState& state, const Action& action, std::mt19937& rng) {
+    Outcome outcome = apply<Policy>(state, action);
+    if (outcome.tensorPeak) {
+        resolveTensorPeak<Policy>(state, rng);
+    }
+    return outcome;
+}
+
+// Both instantiations live here, so callers that pick one themselves link against it
+namespace Rules {
+    template bool applySynergies<Standard>(GameState&, Side);
+    template bool applySynergies<Configured>(GameState&, Side);
+    template bool isLegal<Standard>(const GameState&, const Action&);
+    template bool isLegal<Configured>(const GameState&, const Action&);
+    template void legalActions<Standard>(const GameState&, std::vector<Action>&);
+    template void legalActions<Configured>(const GameState&, std::vector<Action>&);
+    template Outcome apply<Standard>(GameState&, const Action&);
+    template Outcome apply<Configured>(GameState&, const Action&);
+    template Outcome applyUnchecked<Standard>(GameState&, const Action&);
+    template Outcome applyUnchecked<Configured>(GameState&, const Action&);
+    template void resolveTensorPeak<Standard>(GameState&, bool, int);
+    template void resolveTensorPeak<Configured>(GameState&, bool, int);
+    template void resolveTensorPeak<Standard>(GameState&, std::mt19937&);
+    template void resolveTensorPeak<Configured>(GameState&, std::mt19937&);
+    template Outcome step<Standard>(GameState&, const Action&, std::mt19937&);
+    template Outcome step<Configured>(GameState&, const Action&, std::mt19937&);
+}
+
+bool Rules::applySynergies(GameState& state, Side side) {
+    return isStandard(state) ? applySynergies<Standard>(state, side) : applySynergies<Configured>(state, side);
+}
+
+bool Rules::isLegal(const GameState& state, const Action& action) {
+    return isStandard(state) ? isLegal<Standard>(state, action) : isLegal<Configured>(state, action);
+}
+
+void Rules::legalActions(const GameState& state, std::vector<Action>& out) {
+    isStandard(state) ? legalActions<Standard>(state, out) : legalActions<Configured>(state, out);
+}
+
+Rules::Outcome Rules::apply(GameState& state, const Action& action) {
+    return isStandard(state) ? apply<Standard>(state, action) : apply<Configured>(state, action);
+}
+
+Rules::Outcome Rules::applyUnchecked(GameState& state, const Action& action) {
+    return isStandard(state) ? applyUnchecked<Standard>(state, action) : applyUnchecked<Configured>(state, action);
+}
+
+void Rules::resolveTensorPeak(GameState& state, bool playerWon, int consequenceIndex) {
+    isStandard(state) ? resolveTensorPeak<Standard>(state, playerWon, consequenceIndex)
+                      : resolveTensorPeak<Configured>(state, playerWon, consequenceIndex);
+}
+
+void Rules::resolveTensorPeak(GameState& state, std::mt19937& rng) {
+    isStandard(state) ? resolveTensorPeak<Standard>(state, rng) : resolveTensorPeak<Configured>(state, rng);
+}
+
+Rules::Outcome Rules::step(GameState& state, const Action& action, std::mt19937& rng) {
+    return isStandard(state) ? step<Standard>(state, action, rng) : step<Configured>(state, action, rng);
+}
+
+const char* Rules::checkInvariants(const GameState& state, bool peakPending) {
+    for (Side side : {PLAYER, ENEMY}) {
+        const auto& cards = state.cards;
+        if (energy(state, side) < 0) return "negative energy";
+
+        bool concordia = fieldMasks(state, side).concordia();
+        for (CardHandle card : field(state, side)) {
+            if (card >= cards.size) return "field card outside the pool";
+            if (cards.type[card] != Card::CHAMPION) return "non-champion on the field";
+            if (cards.health[card] <= 0) return "destroyed champion left on the field";
+            if (cards.turnsInPlay[card] < 0 || cards.turnsInPlay[card] > 1) return "champion turn counter out of range";
+            // Buffs only ever add to the printed attack, and Concordia adds at least its bonus on top
+            if (cards.attack[card] < cards.originalAttack[card]) return "champion attack below its printed value";
+            if (concordia && cards.attack[card] < cards.originalAttack[card] + state.rules->concordiaAttack) {
+                return "Tensor Concordia active without its buff";
+            }
+        }
+        for (CardHandle card : hand(state, side)) {
+            if (card >= cards.size) return "hand card outside the pool";
+            if (cards.cost[card] < 0) return "negative card cost in hand";
+        }
+    }
+
+    if (state.tensor.current < 0) return "negative tensor gauge";
+    if (state.tensor.maximum < state.rules->tensorStart ||
+        state.tensor.maximum > state.rules->tensorCap) return "tensor maximum out of range";
+    if (!peakPending && state.tensor.current >= state.tensor.maximum) return "tensor gauge full after the peak was resolved";
+    return nullptr;
+}
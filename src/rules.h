@@ -0,0 +1,174 @@
+#pragma once
+#include "game.h"
+#include <bit>
+
+// Headless rules engine: the same mechanics Game drives through the UI, but with
+// no curses calls, no delays and no global rand(), so the simulator, the AI and
+// offline tools can step thousands of games per second.
+namespace Rules {
+    enum Side {
+        PLAYER = 0,
+        ENEMY = 1
+    };
+
+    enum Result {
+        ONGOING,
+        PLAYER_WIN,
+        ENEMY_WIN,
+        DRAW
+    };
+
+    struct Action {
+        enum Type : uint8_t {
+            PLAY_CARD,
+            ATTACK,
+            END_TURN
+        } type = END_TURN;
+        int8_t index = -1;   // hand index for PLAY_CARD, attacker field index for ATTACK
+        int8_t target = -1;  // artifact target / defender field index, -1 attacks the opponent directly
+
+        static Action play(int handIndex, int targetIndex = -1) {
+            return {PLAY_CARD, static_cast<int8_t>(handIndex), static_cast<int8_t>(targetIndex)};
+        }
+        static Action attack(int attackerIndex, int targetIndex) {
+            return {ATTACK, static_cast<int8_t>(attackerIndex), static_cast<int8_t>(targetIndex)};
+        }
+        static Action endTurn() { return {}; }
+    };
+
+    // What an applied action did, so front ends can narrate it
+    struct Outcome {
+        bool legal = false;
+        int damage = 0;
+        bool destroyed = false;     // defender removed from the field
+        bool concordia = false;     // Tensor Concordia applied by this action
+        bool tensorPeak = false;    // gauge reached its maximum, resolveTensorPeak() is due
+    };
+
+    // Policy head layout: one slot per hand card, one per (attacker, target) pair, one for end turn
+    constexpr int MAX_HAND_SLOTS = 10;
+    constexpr int TARGET_SLOTS = MAX_FIELD_SIZE + 1;  // direct attack + each defender
+    constexpr int NUM_ACTION_SLOTS = MAX_HAND_SLOTS + MAX_FIELD_SIZE * TARGET_SLOTS + 1;
+
+    int actionSlot(const Action& action);  // -1 if the action has no policy slot
+
+    inline Side opponent(Side side) { return side == PLAYER ? ENEMY : PLAYER; }
+    inline Side toMove(const GameState& state) { return state.isPlayerTurn ? PLAYER : ENEMY; }
+
+    inline std::vector<CardHandle>& hand(GameState& s, Side side) { return side == PLAYER ? s.playerHand : s.enemyHand; }
+    inline Field& field(GameState& s, Side side) { return side == PLAYER ? s.playerField : s.enemyField; }
+    inline int& health(GameState& s, Side side) { return side == PLAYER ? s.playerHealth : s.enemyHealth; }
+    inline int& energy(GameState& s, Side side) { return side == PLAYER ? s.playerEnergy : s.enemyEnergy; }
+    inline const std::vector<CardHandle>& hand(const GameState& s, Side side) { return side == PLAYER ? s.playerHand : s.enemyHand; }
+    inline const Field& field(const GameState& s, Side side) { return side == PLAYER ? s.playerField : s.enemyField; }
+    inline int health(const GameState& s, Side side) { return side == PLAYER ? s.playerHealth : s.enemyHealth; }
+    inline int energy(const GameState& s, Side side) { return side == PLAYER ? s.playerEnergy : s.enemyEnergy; }
+
+    enum DeckOrder {
+        LAZY_DECK,      // each draw samples from what is left (same distribution, no up-front shuffle)
+        SHUFFLED_DECK   // the whole deck is shuffled first, e.g. to inspect the order
+    };
+
+    // Fresh match under rules (which must outlive it): shuffled deck, five cards each,
+    // one energy each, player to move, with the standard numbers
+    void setupGame(GameState& state, std::mt19937& rng, DeckOrder order = LAZY_DECK,
+                   const RuleSet& rules = RuleSet::STANDARD);
+    Result result(const GameState& state);
+
+    // Field bitboards: one pass over a side's live slots, after which occupancy, readiness
+    // and faction questions are bit operations. Bit i is slot i; factions are packed
+    // one nibble each, TECHNO in the lowest.
+    struct FieldMasks {
+        uint8_t occupied = 0;
+        uint8_t ready = 0;        // champions that can attack: in play since last turn, not attacked yet
+        uint8_t buffed = 0;       // carrying the Tensor Concordia buff
+        uint16_t factions = 0;
+
+        uint8_t faction(Card::Faction f) const {
+            return f == Card::FACTION_NONE ? 0 : (factions >> 4 * (f - 1)) & 0xF;
+        }
+        int count(Card::Faction f) const { return std::popcount(faction(f)); }
+        bool concordia() const {
+            // Every nibble non-zero: fold each nibble onto its low bit
+            unsigned folded = factions | factions >> 1 | factions >> 2 | factions >> 3;
+            return (folded & 0x1111) == 0x1111;
+        }
+        // Standard rules: 2 cards = level 1, 3 cards = level 2, 4 cards = level 3
+        bool synergy(Card::Faction f, const RuleSet& rules) const { return count(f) >= rules.synergyCards; }
+        int synergyLevel(Card::Faction f, const RuleSet& rules) const { return rules.synergyLevel(count(f)); }
+    };
+    static_assert(MAX_FIELD_SIZE <= 4, "FieldMasks packs a faction's slots into one nibble");
+
+    // Inline so callers that only want one mask don't pay for the others
+    inline FieldMasks fieldMasks(const GameState& state, Side side) {
+        const Field& ownField = field(state, side);
+        const CardPool& cards = state.cards;
+        FieldMasks masks;
+        masks.occupied = ownField.liveMask();
+        for (unsigned live = masks.occupied; live; live &= live - 1) {
+            int i = std::countr_zero(live);
+            CardHandle h = ownField[i];
+            uint8_t bit = static_cast<uint8_t>(1u << i);
+            if (cards.type[h] != Card::CHAMPION) continue;
+            masks.ready |= (cards.turnsInPlay[h] > 0 && !cards.attacked[h]) ? bit : 0;
+            masks.buffed |= cards.buffed[h] ? bit : 0;
+            if (cards.faction[h] != Card::FACTION_NONE) {
+                masks.factions |= static_cast<uint16_t>(bit << 4 * (cards.faction[h] - 1));
+            }
+        }
+        return masks;
+    }
+
+    // Where the move code reads its constants. The functions below that depend on
+    // the rules are templates over one of these, compiled for both in rules.cpp.
+    // Standard hands back the constexpr RuleSet::STANDARD, so the field size,
+    // synergy thresholds and gauge cap fold into the code as literals; Configured
+    // reads the state's own RuleSet. The plain overloads pick the instantiation
+    // from state.rules, one compare per call, and tight loops (Rollout) pick
+    // once and call the template directly.
+    struct Standard {
+        static constexpr const RuleSet& of(const GameState&) { return RuleSet::STANDARD; }
+    };
+    struct Configured {
+        static const RuleSet& of(const GameState& state) { return *state.rules; }
+    };
+    inline bool isStandard(const GameState& state) { return state.rules == &RuleSet::STANDARD; }
+
+    // Synergy: the stat reset and scheduling live here, what each faction grants is in effects.h
+    int synergyLevel(const GameState& state, Side side, Card::Faction faction);
+    void applySynergyEffects(GameState& state, Side side, Card::Faction faction, int level);
+    template <class Policy> bool applySynergies(GameState& state, Side side);
+    bool applySynergies(GameState& state, Side side);  // true if Tensor Concordia is active
+
+    // Moves
+    template <class Policy> bool isLegal(const GameState& state, const Action& action);
+    template <class Policy> void legalActions(const GameState& state, std::vector<Action>& out);
+    template <class Policy> Outcome apply(GameState& state, const Action& action);
+    template <class Policy> Outcome applyUnchecked(GameState& state, const Action& action);
+    bool isLegal(const GameState& state, const Action& action);
+    void legalActions(const GameState& state, std::vector<Action>& out);
+    Outcome apply(GameState& state, const Action& action);
+    // apply() without the isLegal() check, for callers that generated the action from the legal moves
+    Outcome applyUnchecked(GameState& state, const Action& action);
+    bool drawCard(GameState& state, Side side);  // false (and game decided on HP) when the deck is empty
+
+    // Resample what observer can't see: the opponent's hand goes back into the
+    // deck and the same number of cards is redrawn from seed. The deck is left
+    // lazy, so later draws stay uniform over the unseen cards.
+    void determinize(GameState& state, Side observer, uint64_t seed);
+
+    // Tensor peak: the minigame only stakes the player's resources. consequenceIndex picks one
+    // of the RuleSet's stakes and is clamped to stakeCount.
+    template <class Policy> void resolveTensorPeak(GameState& state, bool playerWon, int consequenceIndex);
+    template <class Policy> void resolveTensorPeak(GameState& state, std::mt19937& rng);
+    void resolveTensorPeak(GameState& state, bool playerWon, int consequenceIndex);
+    void resolveTensorPeak(GameState& state, std::mt19937& rng);  // random headless minigame and choice
+
+    // apply() + headless peak resolution, what the simulator uses
+    template <class Policy> Outcome step(GameState& state, const Action& action, std::mt19937& rng);
+    Outcome step(GameState& state, const Action& action, std::mt19937& rng);
+
+    // Consistency checks every reachable state must pass; returns the first one
+    // broken, or nullptr. peakPending allows a full gauge that awaits resolveTensorPeak().
+    const char* checkInvariants(const GameState& state, bool peakPending = false);
+}
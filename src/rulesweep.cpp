@@ -0,0 +1,367 @@
+// Balance sweeps over the rule constants.
+//
+//   rulesweep [games] [agent] [name=values ...] [threads=N] [report=path]
+//
+// Every name=values argument varies one RuleSet constant. values is a single
+// number, a list ("8,10,12") or a range ("6:14" or "6:14:2", first:last:step).
+// The sweep plays the Cartesian product of everything given, with the shipped
+// value for anything not mentioned. Stakes are a list of tables, each a
+// "/"-separated row of e2 (win or lose 2 energy) and h1 (1 health) entries:
+// stakes=e2/h1/e3/h2/e1,h1/h1/h2.
+//
+// agent plays both sides (default solver:2000):
+//   random        the simulator's random player (Rollout::randomAction)
+//   solver[:N]    TurnSolver with a budget of N positions per turn (default 50000)
+//
+// Every variant plays the same seeds, so variants differ only in their rules.
+// Games run on every core, and results are kept by game index, so a run is
+// reproducible whatever the thread count. For each variant the report gives
+// the first player's win rate with a 95% interval (the side that moves first
+// is the only asymmetry between two copies of one agent, so this is the
+// balance figure), draws, game length in turns and plies, and how many games
+// hit the ply limit. The report is a markdown table (rulesweep_report.md by
+// default); invalid variants are listed with the reason and skipped.
+
+#include "rules.h"
+#include "rollout.h"
+#include "turnflow.h"
+#include "effects.h"
+#include <cmath>
+#include <fstream>
+
+namespace {
+    constexpr int MAX_PLIES = 2000;      // a game still going after this many moves is a draw
+    constexpr size_t MAX_VARIANTS = 4096;
+
+    struct Constant {
+        const char* name;
+        int RuleSet::*field;
+    };
+
+    constexpr Constant CONSTANTS[] = {
+        {"health", &RuleSet::startingHealth},
+        {"energy", &RuleSet::startingEnergy},
+        {"hand", &RuleSet::startingHand},
+        {"tensor_start", &RuleSet::tensorStart},
+        {"tensor_cap", &RuleSet::tensorCap},
+        {"concordia_attack", &RuleSet::concordiaAttack},
+        {"concordia_health", &RuleSet::concordiaHealth},
+        {"synergy_cards", &RuleSet::synergyCards},
+        {"synergy_max", &RuleSet::synergyMaxLevel},
+        {"field", &RuleSet::fieldSize},
+        {"champions", &RuleSet::champions},
+        {"artifacts", &RuleSet::artifacts},
+        {"tensors", &RuleSet::tensors}
+    };
+
+    // One swept constant: an int field and its values, or the stake tables
+    struct Axis {
+        std::string name;
+        std::vector<std::string> labels;
+        int RuleSet::*field = nullptr;
+        std::vector<int> values;
+        std::vector<RuleSet> tables;  // stakes only
+
+        void apply(RuleSet& rules, size_t i) const {
+            if (field) {
+                rules.*field = values[i];
+            } else {
+                rules.stakes = tables[i].stakes;
+                rules.stakeCount = tables[i].stakeCount;
+            }
+        }
+    };
+
+    bool parseInt(const std::string& text, int& value) {
+        char* end = nullptr;
+        long parsed = std::strtol(text.c_str(), &end, 10);
+        if (text.empty() || *end != '\0' || parsed < -1000000 || parsed > 1000000) return false;
+        value = static_cast<int>(parsed);
+        return true;
+    }
+
+    bool parseValues(const std::string& text, std::vector<int>& values) {
+        std::vector<std::string> parts;
+        std::stringstream range(text);
+        for (std::string part; std::getline(range, part, ':');) parts.push_back(part);
+
+        if (parts.size() == 2 || parts.size() == 3) {
+            int first, last, step = 1;
+            if (!parseInt(parts[0], first) || !parseInt(parts[1], last)) return false;
+            if (parts.size() == 3 && (!parseInt(parts[2], step) || step <= 0)) return false;
+            if (last < first) return false;
+            for (int v = first; v <= last; v += step) values.push_back(v);
+            return true;
+        }
+        std::stringstream list(text);
+        for (std::string item; std::getline(list, item, ',');) {
+            int value;
+            if (!parseInt(item, value)) return false;
+            values.push_back(value);
+        }
+        return !values.empty();
+    }
+
+    bool parseStakes(const std::string& text, std::vector<RuleSet>& tables) {
+        std::stringstream list(text);
+        for (std::string item; std::getline(list, item, ',');) {
+            RuleSet table;
+            table.stakeCount = 0;
+            std::stringstream row(item);
+            for (std::string entry; std::getline(row, entry, '/');) {
+                int value;
+                if (entry.size() < 2 || (entry[0] != 'e' && entry[0] != 'h') || !parseInt(entry.substr(1), value)) return false;
+                if (table.stakeCount == static_cast<int>(RuleSet::MAX_STAKES)) return false;
+                table.stakes[table.stakeCount++] = {entry[0] == 'h', value};
+            }
+            if (table.stakeCount == 0) return false;
+            tables.push_back(table);
+        }
+        return !tables.empty();
+    }
+
+    bool parseAxis(const std::string& arg, Axis& axis) {
+        size_t eq = arg.find('=');
+        axis.name = arg.substr(0, eq);
+        std::string text = arg.substr(eq + 1);
+
+        if (axis.name == "stakes") {
+            if (!parseStakes(text, axis.tables)) return false;
+            std::stringstream list(text);
+            for (std::string item; std::getline(list, item, ',');) axis.labels.push_back(item);
+            return true;
+        }
+        for (const Constant& constant : CONSTANTS) {
+            if (axis.name != constant.name) continue;
+            if (!parseValues(text, axis.values)) return false;
+            for (int value : axis.values) axis.labels.push_back(std::to_string(value));
+            axis.field = constant.field;
+            return true;
+        }
+        return false;
+    }
+
+    struct Variant {
+        RuleSet rules;
+        std::string label;          // the swept values, e.g. "health=8 field=3"
+        const char* invalid = nullptr;
+    };
+
+    struct GameRecord {
+        Rules::Result result = Rules::ONGOING;  // ONGOING when the ply limit cut it off
+        int turns = 0;
+        int plies = 0;
+    };
+
+    struct AgentSpec {
+        bool random = false;
+        int budget = 2000;
+    };
+
+    bool parseAgent(const std::string& text, AgentSpec& spec) {
+        if (text == "random") {
+            spec.random = true;
+            return true;
+        }
+        if (text.rfind("solver", 0) != 0) return false;
+        if (text == "solver") {
+            spec.budget = TurnSolver::DEFAULT_MAX_POSITIONS;
+            return true;
+        }
+        return text[6] == ':' && parseInt(text.substr(7), spec.budget) && spec.budget > 0;
+    }
+
+    GameRecord playGame(const RuleSet& rules, const AgentSpec& agent, uint32_t seed) {
+        GameState state;
+        std::mt19937 rng(seed);
+        Rules::setupGame(state, rng, Rules::LAZY_DECK, rules);
+        Rollout::Rng policy(seed);
+        TurnFlow::SolverAgent solvers[2] = {
+            TurnFlow::SolverAgent(nullptr, agent.budget),
+            TurnFlow::SolverAgent(nullptr, agent.budget)
+        };
+
+        GameRecord record;
+        while (Rules::result(state) == Rules::ONGOING && record.plies < MAX_PLIES) {
+            Rules::Side side = Rules::toMove(state);
+            Rules::Action action = agent.random ? Rollout::randomAction(state, policy) : solvers[side].choose(state);
+            if (!Rules::step(state, action, rng).legal) {
+                action = Rules::Action::endTurn();  // a broken agent forfeits its turn, not the sweep
+                Rules::step(state, action, rng);
+            }
+            if (action.type == Rules::Action::END_TURN) record.turns++;
+            record.plies++;
+        }
+        record.result = Rules::result(state);
+        return record;
+    }
+
+    struct Summary {
+        int games = 0;
+        int firstWins = 0;
+        int secondWins = 0;
+        int draws = 0;
+        int cutOff = 0;
+        double turns = 0;
+        double plies = 0;
+    };
+
+    Summary summarise(const GameRecord* records, int games) {
+        Summary summary;
+        summary.games = games;
+        for (int g = 0; g < games; g++) {
+            const GameRecord& record = records[g];
+            summary.firstWins += record.result == Rules::PLAYER_WIN;
+            summary.secondWins += record.result == Rules::ENEMY_WIN;
+            summary.draws += record.result == Rules::DRAW || record.result == Rules::ONGOING;
+            summary.cutOff += record.result == Rules::ONGOING;
+            summary.turns += record.turns;
+            summary.plies += record.plies;
+        }
+        summary.turns /= games;
+        summary.plies /= games;
+        return summary;
+    }
+
+    // First-player score (draws count half) and its normal-approximation 95% half-width
+    std::pair<double, double> firstScore(const Summary& s) {
+        double p = (s.firstWins + 0.5 * s.draws) / s.games;
+        return {p, 1.96 * std::sqrt(p * (1 - p) / s.games)};
+    }
+
+    void writeReport(std::ostream& out, const std::vector<Variant>& variants, const std::vector<GameRecord>& records,
+                     int games, const std::string& agent, double seconds) {
+        out << "# Rule Sweep\n\n";
+        out << variants.size() << " variants, " << games << " games each, " << agent << " on both sides, "
+            << std::fixed << std::setprecision(1) << seconds << " s\n\n";
+        out << "First = the side that moves first. Score counts draws as half; balance is its distance from 50%.\n\n";
+        out << "| Variant | First wins | Second wins | Draws | First score | Balance | Turns | Plies | Cut off |\n";
+        out << "|---|---|---|---|---|---|---|---|---|\n";
+
+        auto pct = [&](double x) { return 100.0 * x; };
+        for (size_t v = 0; v < variants.size(); v++) {
+            const Variant& variant = variants[v];
+            out << "| " << variant.label << " | ";
+            if (variant.invalid) {
+                out << "invalid: " << variant.invalid << " | | | | | | | |\n";
+                continue;
+            }
+            Summary s = summarise(&records[v * games], games);
+            auto [score, interval] = firstScore(s);
+            out << std::setprecision(1)
+                << pct(static_cast<double>(s.firstWins) / games) << "% | "
+                << pct(static_cast<double>(s.secondWins) / games) << "% | "
+                << pct(static_cast<double>(s.draws) / games) << "% | "
+                << pct(score) << "% ± " << pct(interval) << " | "
+                << pct(std::abs(score - 0.5)) << " | "
+                << s.turns << " | " << s.plies << " | " << s.cutOff << " |\n";
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    int games = 200;
+    std::string agentName = "solver:2000";
+    std::string reportPath = "rulesweep_report.md";
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<Axis> axes;
+
+    int positional = 0;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.find('=') == std::string::npos) {
+            if (positional == 0) games = std::atoi(arg.c_str());
+            else if (positional == 1) agentName = arg;
+            else {
+                std::cerr << "Unexpected argument '" << arg << "'\n";
+                return 1;
+            }
+            positional++;
+        } else if (arg.rfind("threads=", 0) == 0) {
+            threads = std::atoi(arg.c_str() + 8);
+        } else if (arg.rfind("report=", 0) == 0) {
+            reportPath = arg.substr(7);
+        } else {
+            Axis axis;
+            if (!parseAxis(arg, axis)) {
+                std::cerr << "Bad sweep '" << arg << "'; constants are:";
+                for (const Constant& constant : CONSTANTS) std::cerr << " " << constant.name;
+                std::cerr << " stakes\n";
+                return 1;
+            }
+            axes.push_back(std::move(axis));
+        }
+    }
+
+    AgentSpec agent;
+    if (!parseAgent(agentName, agent)) {
+        std::cerr << "Unknown agent '" << agentName << "' (random, solver[:N])\n";
+        return 1;
+    }
+    if (games <= 0 || threads <= 0) {
+        std::cerr << "Need a positive game and thread count\n";
+        return 1;
+    }
+
+    // The same script file the game uses, since balance work usually touches both
+    std::string effectsError;
+    if (!Effects::loadDefaultFile(effectsError)) {
+        std::cerr << effectsError << "\n";
+        return 1;
+    }
+
+    size_t count = 1;
+    for (const Axis& axis : axes) {
+        count *= axis.labels.size();
+        if (count > MAX_VARIANTS) {
+            std::cerr << "More than " << MAX_VARIANTS << " variants; narrow the ranges\n";
+            return 1;
+        }
+    }
+
+    // Cartesian product, the last axis varying fastest
+    std::vector<Variant> variants(count);
+    for (size_t v = 0; v < count; v++) {
+        Variant& variant = variants[v];
+        size_t rest = v;
+        for (size_t a = axes.size(); a-- > 0;) {
+            size_t i = rest % axes[a].labels.size();
+            rest /= axes[a].labels.size();
+            axes[a].apply(variant.rules, i);
+            variant.label = axes[a].name + "=" + axes[a].labels[i] + (variant.label.empty() ? "" : " " + variant.label);
+        }
+        if (variant.label.empty()) variant.label = "standard";
+        variant.invalid = variant.rules.validate();
+    }
+
+    std::cerr << "Sweeping " << count << " variants x " << games << " games with " << agentName << " on " << threads << " threads\n";
+    std::vector<GameRecord> records(count * games);
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> done{0};
+    auto start = std::chrono::steady_clock::now();
+    auto worker = [&] {
+        for (size_t job; (job = next.fetch_add(1)) < records.size();) {
+            const Variant& variant = variants[job / games];
+            if (!variant.invalid) {
+                records[job] = playGame(variant.rules, agent, static_cast<uint32_t>(1000 + job % games));
+            }
+            size_t finished = done.fetch_add(1) + 1;
+            if (finished % 1000 == 0) std::cerr << finished << "/" << records.size() << " games\r";
+        }
+    };
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; t++) pool.emplace_back(worker);
+    for (std::thread& thread : pool) thread.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::ostringstream text;
+    writeReport(text, variants, records, games, agentName, seconds);
+    std::cout << text.str();
+    std::ofstream report(reportPath);
+    if (!report || !(report << text.str())) {
+        std::cerr << "Cannot write " << reportPath << "\n";
+        return 1;
+    }
+    std::cout << "\nReport written to " << reportPath << "\n";
+    return 0;
+}
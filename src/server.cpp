@@ -0,0 +1,483 @@
+#include "server.h"
+#include "turnflow.h"
+#include <cerrno>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+    constexpr int MAX_EVENTS = 256;
+    constexpr size_t READ_CHUNK = 16384;
+    constexpr size_t MAX_READ_PER_WAKEUP = 4 * READ_CHUNK;  // level-triggered: the rest waits for the next wakeup
+    constexpr size_t MAX_PENDING_OUTPUT = 1 << 20;  // drop clients that stop reading
+
+    Protocol::Outcome outcomeFor(Rules::Result result, Rules::Side side) {
+        if (result == Rules::DRAW) return Protocol::DRAW;
+        bool won = (result == Rules::PLAYER_WIN) == (side == Rules::PLAYER);
+        return won ? Protocol::WIN : Protocol::LOSS;
+    }
+
+    int openListener(uint16_t port) {
+        int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+        if (fd < 0) return -1;
+        int on = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+        setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on));
+
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_ANY);
+        addr.sin_port = htons(port);
+        if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || listen(fd, SOMAXCONN) != 0) {
+            close(fd);
+            return -1;
+        }
+        return fd;
+    }
+}
+
+struct MatchServer::Connection {
+    int fd = -1;
+    std::vector<uint8_t> input;
+    std::vector<uint8_t> output;
+    size_t sent = 0;
+    Match* match = nullptr;
+    Rules::Side side = Rules::PLAYER;
+    bool awaitingWrite = false;  // socket buffer full, EPOLLOUT armed
+    bool dirty = false;     // queued for the end-of-batch flush
+    bool closing = false;
+};
+
+struct MatchServer::Match {
+    uint32_t id = 0;
+    GameState state;
+    std::mt19937 rng;
+    TurnFlow::Match flow;  // suspended between moves, waiting on seats[flow.request().side]
+    Connection* seats[2] = {nullptr, nullptr};
+};
+
+struct MatchServer::Worker {
+    MatchServer& server;
+    uint32_t index;
+    int listenFd = -1;
+    int epollFd = -1;
+    int wakeFd = -1;
+
+    std::unordered_map<int, std::unique_ptr<Connection>> connections;
+    std::unordered_map<uint32_t, std::unique_ptr<Match>> matches;
+    Connection* waiting = nullptr;
+    uint32_t matchesCreated = 0;
+    std::mt19937 rng;
+
+    std::vector<Connection*> dirty;
+    std::vector<Connection*> closing;
+
+    Worker(MatchServer& owner, uint32_t workerIndex)
+        : server(owner), index(workerIndex), rng(owner.seed + workerIndex) {}
+
+    ~Worker() {
+        for (auto& entry : connections) {
+            close(entry.first);
+        }
+        if (listenFd >= 0) close(listenFd);
+        if (epollFd >= 0) close(epollFd);
+        if (wakeFd >= 0) close(wakeFd);
+    }
+
+    bool open(uint16_t port) {
+        listenFd = openListener(port);
+        epollFd = epoll_create1(0);
+        wakeFd = eventfd(0, EFD_NONBLOCK);
+        if (listenFd < 0 || epollFd < 0 || wakeFd < 0) return false;
+        return watch(listenFd, EPOLLIN) && watch(wakeFd, EPOLLIN);
+    }
+
+    bool watch(int fd, uint32_t events, int op = EPOLL_CTL_ADD) {
+        epoll_event ev{};
+        ev.events = events;
+        ev.data.fd = fd;
+        return epoll_ctl(epollFd, op, fd, &ev) == 0;
+    }
+
+    void wake() {
+        uint64_t one = 1;
+        ssize_t ignored = write(wakeFd, &one, sizeof(one));
+        (void)ignored;
+    }
+
+    void run() {
+        epoll_event events[MAX_EVENTS];
+        while (true) {
+            int count = epoll_wait(epollFd, events, MAX_EVENTS, -1);
+            if (count < 0) {
+                if (errno == EINTR) continue;
+                return;
+            }
+
+            for (int i = 0; i < count; i++) {
+                int fd = events[i].data.fd;
+                if (fd == wakeFd) return;
+                if (fd == listenFd) {
+                    acceptAll();
+                    continue;
+                }
+
+                auto found = connections.find(fd);
+                if (found == connections.end() || found->second->closing) continue;
+                Connection* conn = found->second.get();
+                if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+                    drop(conn);
+                    continue;
+                }
+                if (events[i].events & EPOLLIN) {
+                    receive(conn);
+                }
+                if ((events[i].events & EPOLLOUT) && !conn->closing) {
+                    conn->awaitingWrite = false;
+                    watch(fd, EPOLLIN, EPOLL_CTL_MOD);
+                    markDirty(conn);
+                }
+            }
+
+            // Everything queued during this batch goes out in one send per client
+            flushDirty();
+            if (waiting && waiting->output.empty()) {
+                meetInLobby();
+                flushDirty();
+            }
+            for (Connection* conn : closing) {
+                epoll_ctl(epollFd, EPOLL_CTL_DEL, conn->fd, nullptr);
+                close(conn->fd);
+                connections.erase(conn->fd);
+            }
+            closing.clear();
+        }
+    }
+
+    void flushDirty() {
+        // Indexed: a failed send can drop a client and queue its opponent
+        for (size_t d = 0; d < dirty.size(); d++) {
+            Connection* conn = dirty[d];
+            conn->dirty = false;
+            if (!conn->closing) flush(conn);
+        }
+        dirty.clear();
+    }
+
+    // A client still unpaired at the end of a batch is parked in the shared lobby
+    // (out of this worker's epoll) so another worker can adopt it. Otherwise
+    // clients that landed on different workers would never meet.
+    void meetInLobby() {
+        std::unique_ptr<Connection> parked;
+        {
+            std::lock_guard<std::mutex> lock(server.lobbyMutex);
+            if (!server.lobby) {
+                auto found = connections.find(waiting->fd);
+                epoll_ctl(epollFd, EPOLL_CTL_DEL, waiting->fd, nullptr);
+                server.lobby = std::move(found->second);
+                connections.erase(found);
+                waiting = nullptr;
+                return;
+            }
+            parked = std::move(server.lobby);
+        }
+        Connection* opponent = adopt(std::move(parked));
+        Connection* local = waiting;
+        waiting = nullptr;
+        startMatch(opponent, local);
+    }
+
+    Connection* adopt(std::unique_ptr<Connection> conn) {
+        Connection* adopted = conn.get();
+        watch(adopted->fd, EPOLLIN);  // a hangup while parked shows up as soon as it is watched again
+        connections[adopted->fd] = std::move(conn);
+        return adopted;
+    }
+
+    void acceptAll() {
+        while (true) {
+            int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK);
+            if (fd < 0) return;  // EAGAIN, or a transient error we retry on the next event
+            int on = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+            if (!watch(fd, EPOLLIN)) {
+                close(fd);
+                continue;
+            }
+            auto conn = std::make_unique<Connection>();
+            conn->fd = fd;
+            connections[fd] = std::move(conn);
+            server.counters.connections++;
+        }
+    }
+
+    // Reads at most MAX_READ_PER_WAKEUP so one flooding client cannot starve the rest of the
+    // batch, and handles frames chunk by chunk so input never holds more than one partial frame
+    void receive(Connection* conn) {
+        uint8_t buffer[READ_CHUNK];
+        size_t budget = MAX_READ_PER_WAKEUP;
+        bool hangup = false;
+        while (budget > 0) {
+            ssize_t got = recv(conn->fd, buffer, std::min(sizeof(buffer), budget), 0);
+            if (got > 0) {
+                budget -= got;
+                conn->input.insert(conn->input.end(), buffer, buffer + got);
+                if (!consumeFrames(conn)) return;
+                continue;
+            }
+            if (got < 0 && errno == EINTR) continue;
+            hangup = !(got < 0 && (errno == EAGAIN || errno == EWOULDBLOCK));  // orderly shutdown or hard error
+            break;
+        }
+
+        // Frames that arrived before the hangup (e.g. a resignation) still count
+        if (hangup) drop(conn);
+    }
+
+    // Handles every complete frame in input; false once the connection has been dropped
+    bool consumeFrames(Connection* conn) {
+        size_t offset = 0;
+        while (!conn->closing) {
+            Protocol::Frame frame;
+            bool malformed;
+            size_t used = Protocol::parseFrame(conn->input.data() + offset, conn->input.size() - offset, frame, malformed);
+            if (malformed) {
+                drop(conn);
+                return false;
+            }
+            if (used == 0) break;
+            handle(conn, frame);
+            offset += used;
+        }
+        if (conn->closing) return false;
+        conn->input.erase(conn->input.begin(), conn->input.begin() + offset);
+
+        // What is left is one partial frame, which can never be longer than a whole one
+        if (conn->input.size() > Protocol::MAX_FRAME) {
+            drop(conn);
+            return false;
+        }
+        return true;
+    }
+
+    void handle(Connection* conn, const Protocol::Frame& frame) {
+        switch (frame.type) {
+            case Protocol::HELLO: {
+                Protocol::Hello hello;
+                if (!Protocol::payloadAs(frame, hello) || hello.magic != Protocol::MAGIC ||
+                    hello.version != Protocol::VERSION) {
+                    drop(conn);
+                    return;
+                }
+                if (conn->match || conn == waiting) {
+                    reject(conn);
+                } else if (waiting) {
+                    Connection* opponent = waiting;
+                    waiting = nullptr;
+                    startMatch(opponent, conn);
+                } else if (auto parked = takeFromLobby()) {
+                    startMatch(adopt(std::move(parked)), conn);
+                } else {
+                    waiting = conn;
+                    send(conn, Protocol::WAITING);
+                }
+                break;
+            }
+            case Protocol::ACTION: {
+                Protocol::ActionMessage message;
+                if (!Protocol::payloadAs(frame, message)) {
+                    drop(conn);
+                    return;
+                }
+                play(conn, Protocol::unpackAction(message));
+                break;
+            }
+            case Protocol::RESIGN:
+                if (conn->match) {
+                    Rules::Result result = conn->side == Rules::PLAYER ? Rules::ENEMY_WIN : Rules::PLAYER_WIN;
+                    finish(conn->match, result);
+                }
+                break;
+            default:
+                drop(conn);  // server-bound traffic only
+                break;
+        }
+    }
+
+    std::unique_ptr<Connection> takeFromLobby() {
+        std::lock_guard<std::mutex> lock(server.lobbyMutex);
+        return std::move(server.lobby);
+    }
+
+    void startMatch(Connection* first, Connection* second) {
+        auto match = std::make_unique<Match>();
+        match->id = index + matchesCreated++ * static_cast<uint32_t>(server.workerCount);
+        match->rng.seed(rng());
+        Rules::setupGame(match->state, match->rng);
+        match->flow = TurnFlow::play(match->state);
+
+        // Coin flip for who moves first
+        if (match->rng() & 1) std::swap(first, second);
+        match->seats[Rules::PLAYER] = first;
+        match->seats[Rules::ENEMY] = second;
+        for (int side = 0; side < 2; side++) {
+            Connection* seat = match->seats[side];
+            seat->match = match.get();
+            seat->side = static_cast<Rules::Side>(side);
+
+            Protocol::MatchStart start{match->id, static_cast<uint8_t>(side == Rules::PLAYER)};
+            Protocol::appendFrame(seat->output, Protocol::MATCH_START, start);
+            Protocol::appendState(seat->output, match->state, seat->side);
+            markDirty(seat);
+        }
+        server.counters.matchesStarted++;
+        matches[match->id] = std::move(match);
+    }
+
+    void play(Connection* conn, const Rules::Action& action) {
+        Match* match = conn->match;
+        if (!match || match->flow.request().side != conn->side || !Rules::isLegal(match->state, action)) {
+            reject(conn);
+            return;
+        }
+
+        // Nobody at the table plays the peak minigame, so it is settled with the match's own rng
+        match->flow.decide(action);
+        while (!match->flow.done() && match->flow.request().type == TurnFlow::TENSOR_PEAK) {
+            match->flow.resolvePeak(TurnFlow::randomPeak(match->state, match->rng));
+        }
+        server.counters.actions++;
+        for (Connection* seat : match->seats) {
+            Protocol::appendState(seat->output, match->state, seat->side);
+            markDirty(seat);
+        }
+
+        Rules::Result result = Rules::result(match->state);
+        if (result != Rules::ONGOING) {
+            finish(match, result);
+        }
+    }
+
+    void finish(Match* match, Rules::Result result) {
+        for (Connection* seat : match->seats) {
+            send(seat, Protocol::GAME_OVER, Protocol::GameOver{static_cast<uint8_t>(outcomeFor(result, seat->side))});
+            seat->match = nullptr;
+        }
+        server.counters.matchesFinished++;
+        matches.erase(match->id);
+    }
+
+    void reject(Connection* conn) {
+        server.counters.rejected++;
+        send(conn, Protocol::REJECTED);
+    }
+
+    void drop(Connection* conn) {
+        if (conn->closing) return;
+        conn->closing = true;
+        closing.push_back(conn);
+        if (waiting == conn) waiting = nullptr;
+
+        if (Match* match = conn->match) {
+            Connection* other = match->seats[Rules::opponent(conn->side)];
+            send(other, Protocol::GAME_OVER, Protocol::GameOver{Protocol::OPPONENT_LEFT});
+            other->match = nullptr;
+            server.counters.matchesFinished++;
+            matches.erase(match->id);
+        }
+    }
+
+    template <typename... Payload>
+    void send(Connection* conn, Protocol::MessageType type, const Payload&... payload) {
+        Protocol::appendFrame(conn->output, type, payload...);
+        markDirty(conn);
+    }
+
+    void markDirty(Connection* conn) {
+        if (!conn->dirty) {
+            conn->dirty = true;
+            dirty.push_back(conn);
+        }
+    }
+
+    void flush(Connection* conn) {
+        if (conn->awaitingWrite) return;
+        while (conn->sent < conn->output.size()) {
+            ssize_t wrote = ::send(conn->fd, conn->output.data() + conn->sent,
+                                   conn->output.size() - conn->sent, MSG_NOSIGNAL);
+            if (wrote > 0) {
+                conn->sent += wrote;
+                continue;
+            }
+            if (wrote < 0 && errno == EINTR) continue;
+            if (wrote < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                if (conn->output.size() > MAX_PENDING_OUTPUT) {
+                    drop(conn);
+                    return;
+                }
+                // Kernel buffer full: wait for EPOLLOUT instead of spinning
+                conn->awaitingWrite = true;
+                watch(conn->fd, EPOLLIN | EPOLLOUT, EPOLL_CTL_MOD);
+                return;
+            }
+            drop(conn);
+            return;
+        }
+        conn->output.clear();
+        conn->sent = 0;
+    }
+};
+
+MatchServer::MatchServer(uint16_t port, int threads, uint32_t seed)
+    : listenPort(port), seed(seed) {
+    workerCount = threads > 0 ? threads : std::max(1u, std::thread::hardware_concurrency());
+}
+
+MatchServer::~MatchServer() {
+    stop();
+}
+
+bool MatchServer::start() {
+    // Decks intern card names; do it once here so workers only ever read the table
+    Protocol::seedCardNames();
+
+    for (size_t i = 0; i < workerCount; i++) {
+        auto worker = std::make_unique<Worker>(*this, static_cast<uint32_t>(i));
+        if (!worker->open(listenPort)) {
+            workers.clear();
+            return false;
+        }
+        if (listenPort == 0) {
+            // Ephemeral port: the remaining workers share whatever the first one got
+            sockaddr_in addr{};
+            socklen_t length = sizeof(addr);
+            getsockname(worker->listenFd, reinterpret_cast<sockaddr*>(&addr), &length);
+            listenPort = ntohs(addr.sin_port);
+        }
+        workers.push_back(std::move(worker));
+    }
+
+    for (auto& worker : workers) {
+        pool.emplace_back(&Worker::run, worker.get());
+    }
+    return true;
+}
+
+void MatchServer::stop() {
+    for (auto& worker : workers) {
+        worker->wake();
+    }
+    for (auto& thread : pool) {
+        thread.join();
+    }
+    pool.clear();
+    workers.clear();
+    if (lobby) {
+        close(lobby->fd);
+        lobby.reset();
+    }
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include "protocol.h"
+#include <atomic>
+#include <mutex>
+
+// Authoritative match server (Linux only: epoll + SO_REUSEPORT).
+//
+// One worker per core, each with its own listening socket on the same port, so
+// the kernel spreads new connections across workers. A worker pairs the clients
+// it accepted and owns those matches outright: no state is shared between
+// workers except the stats counters and a one-seat lobby where a client that
+// found no opponent on its own worker waits to be adopted by another one.
+// All sockets are non-blocking; a slow client only grows its own output buffer.
+class MatchServer {
+public:
+    struct Stats {
+        std::atomic<uint64_t> connections{0};
+        std::atomic<uint64_t> matchesStarted{0};
+        std::atomic<uint64_t> matchesFinished{0};
+        std::atomic<uint64_t> actions{0};
+        std::atomic<uint64_t> rejected{0};
+    };
+
+    MatchServer(uint16_t port, int threads = 0, uint32_t seed = 0);  // threads 0 = one per core
+    ~MatchServer();
+
+    bool start();   // binds every worker's socket, false if any fails
+    void stop();    // wakes the workers and joins them
+    uint16_t port() const { return listenPort; }
+    int threads() const { return static_cast<int>(workerCount); }
+    const Stats& stats() const { return counters; }
+
+private:
+    struct Connection;
+    struct Match;
+    struct Worker;
+
+    uint16_t listenPort;
+    size_t workerCount;
+    uint32_t seed;
+    Stats counters;
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> pool;
+    std::mutex lobbyMutex;
+    std::unique_ptr<Connection> lobby;
+};
@@ -0,0 +1,259 @@
+#include "snapshot.h"
+#include "rules.h"
+#include <fstream>
+
+namespace {
+    // Slicing-by-8 tables: table[k][b] is the CRC of byte b followed by k zero bytes
+    using CrcTables = std::array<std::array<uint32_t, 256>, 8>;
+
+    CrcTables makeCrcTables() {
+        CrcTables tables{};
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            tables[0][i] = c;
+        }
+        for (uint32_t i = 0; i < 256; i++) {
+            for (int k = 1; k < 8; k++) {
+                uint32_t prev = tables[k - 1][i];
+                tables[k][i] = tables[0][prev & 0xFF] ^ (prev >> 8);
+            }
+        }
+        return tables;
+    }
+
+    Snapshot::PackedCard pack(const CardPool& cards, CardHandle card) {
+        Snapshot::PackedCard p{};
+        p.nameId = cards.nameId[card];
+        p.type = cards.type[card];
+        p.faction = cards.faction[card];
+        p.role = cards.role[card];
+        p.flags = (cards.attacked[card] ? 1 : 0) | (cards.buffed[card] ? 2 : 0);
+        p.cost = cards.cost[card];
+        p.attack = cards.attack[card];
+        p.health = cards.health[card];
+        p.effect = cards.effect[card];
+        p.turnsInPlay = cards.turnsInPlay[card];
+        p.originalAttack = cards.originalAttack[card];
+        p.originalHealth = cards.originalHealth[card];
+        return p;
+    }
+
+    Card unpack(const Snapshot::PackedCard& p) {
+        Card card(static_cast<Card::Type>(p.type), p.nameId, p.cost, p.attack, p.health, p.effect);
+        card.faction = static_cast<Card::Faction>(p.faction);
+        card.role = static_cast<Card::Role>(p.role);
+        card.hasAttackedThisTurn = p.flags & 1;
+        card.hasSynergyBuff = p.flags & 2;
+        card.turnsInPlay = p.turnsInPlay;
+        card.originalAttack = p.originalAttack;
+        card.originalHealth = p.originalHealth;
+        return card;
+    }
+
+    // Card lists in the order they are stored; the two fields follow them, live slots only.
+    // Cards are stored by value, so a reader rebuilds the pool in this order.
+    std::array<const std::vector<CardHandle>*, 3> containers(const GameState& s) {
+        return {&s.deck, &s.playerHand, &s.enemyHand};
+    }
+    std::array<std::vector<CardHandle>*, 3> containers(GameState& s) {
+        return {&s.deck, &s.playerHand, &s.enemyHand};
+    }
+    std::array<const Field*, 2> fields(const GameState& s) {
+        return {&s.playerField, &s.enemyField};
+    }
+    std::array<Field*, 2> fields(GameState& s) {
+        return {&s.playerField, &s.enemyField};
+    }
+
+    // Type, faction and role index name tables, effect tables and bitboard shifts, so all three are checked
+    bool validCard(const Snapshot::PackedCard& packed) {
+        return packed.nameId < CardNames::count() && packed.type <= Card::TENSOR &&
+               packed.faction <= Card::VIRTU_MACHINA && packed.role <= Card::MAGE;
+    }
+}
+
+uint32_t Snapshot::crc32(const uint8_t* data, size_t size) {
+    static const CrcTables t = makeCrcTables();
+    uint32_t c = 0xFFFFFFFFu;
+    for (; size >= 8; data += 8, size -= 8) {
+        uint32_t lo, hi;
+        std::memcpy(&lo, data, 4);
+        std::memcpy(&hi, data + 4, 4);
+        lo ^= c;
+        c = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^ t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24] ^
+            t[3][hi & 0xFF] ^ t[2][(hi >> 8) & 0xFF] ^ t[1][(hi >> 16) & 0xFF] ^ t[0][hi >> 24];
+    }
+    for (; size > 0; data++, size--) {
+        c = t[0][(c ^ *data) & 0xFF] ^ (c >> 8);
+    }
+    return c ^ 0xFFFFFFFFu;
+}
+
+size_t Snapshot::size(const GameState& state, bool withRng) {
+    size_t cards = 0;
+    for (const auto* cardList : containers(state)) {
+        cards += cardList->size();
+    }
+    for (const auto* field : fields(state)) {
+        cards += field->count();
+    }
+    return sizeof(Header) + sizeof(Scalars) + cards * sizeof(PackedCard) +
+           (state.lazyDeck ? sizeof(state.drawState) : 0) + (withRng ? sizeof(std::mt19937) : 0);
+}
+
+size_t Snapshot::write(const GameState& state, const std::mt19937* rng, std::vector<uint8_t>& out) {
+    out.resize(size(state, rng != nullptr));
+    uint8_t* at = out.data() + sizeof(Header);
+
+    Scalars scalars{};
+    scalars.playerHealth = state.playerHealth;
+    scalars.enemyHealth = state.enemyHealth;
+    scalars.playerEnergy = state.playerEnergy;
+    scalars.enemyEnergy = state.enemyEnergy;
+    scalars.tensorCurrent = state.tensor.current;
+    scalars.tensorMaximum = state.tensor.maximum;
+    scalars.isPlayerTurn = state.isPlayerTurn;
+    auto lists = containers(state);
+    for (size_t i = 0; i < lists.size(); i++) {
+        scalars.counts[i] = static_cast<uint8_t>(lists[i]->size());
+    }
+    for (size_t i = 0; i < 2; i++) {
+        scalars.counts[lists.size() + i] = static_cast<uint8_t>(fields(state)[i]->count());
+    }
+    std::memcpy(at, &scalars, sizeof(scalars));
+    at += sizeof(scalars);
+
+    for (const auto* cardList : lists) {
+        for (const auto& card : *cardList) {
+            PackedCard packed = pack(state.cards, card);
+            std::memcpy(at, &packed, sizeof(packed));
+            at += sizeof(packed);
+        }
+    }
+    for (const auto* field : fields(state)) {
+        for (unsigned live = field->liveMask(); live; live &= live - 1) {
+            int slot = std::countr_zero(live);
+            PackedCard packed = pack(state.cards, (*field)[slot]);
+            packed.reserved[0] = static_cast<uint8_t>(slot + 1);
+            std::memcpy(at, &packed, sizeof(packed));
+            at += sizeof(packed);
+        }
+    }
+
+    if (state.lazyDeck) {
+        std::memcpy(at, &state.drawState, sizeof(state.drawState));
+        at += sizeof(state.drawState);
+    }
+
+    if (rng) {
+        std::memcpy(at, rng, sizeof(*rng));
+        at += sizeof(*rng);
+    }
+
+    Header header{};
+    header.magic = MAGIC;
+    header.version = VERSION;
+    header.flags = (rng ? FLAG_RNG : 0) | (state.lazyDeck ? FLAG_LAZY_DECK : 0);
+    header.payloadSize = static_cast<uint32_t>(out.size() - sizeof(Header));
+    header.checksum = crc32(out.data() + sizeof(Header), header.payloadSize);
+    std::memcpy(out.data(), &header, sizeof(header));
+    return out.size();
+}
+
+bool Snapshot::read(const uint8_t* data, size_t size, GameState& state, std::mt19937* rng) {
+    Header header;
+    if (size < sizeof(header)) return false;
+    std::memcpy(&header, data, sizeof(header));
+    if (header.magic != MAGIC) return false;
+    // Version 1 predates fixed field slots and the lazy deck: its fields are packed from
+    // slot 0 and it never carries a draw state, so it is converted on the way in
+    bool packedFields = header.version == VERSION_PACKED_FIELDS;
+    if (header.version != VERSION && !packedFields) return false;
+    if (packedFields && (header.flags & FLAG_LAZY_DECK)) return false;
+    if (header.flags & ~(FLAG_RNG | FLAG_LAZY_DECK)) return false;
+    if (header.payloadSize != size - sizeof(header)) return false;
+
+    const uint8_t* payload = data + sizeof(header);
+    if (crc32(payload, header.payloadSize) != header.checksum) return false;
+
+    Scalars scalars;
+    if (header.payloadSize < sizeof(scalars)) return false;
+    std::memcpy(&scalars, payload, sizeof(scalars));
+
+    size_t cards = 0;
+    for (uint8_t count : scalars.counts) cards += count;
+    if (cards > CardPool::CAPACITY) return false;
+    size_t drawBytes = (header.flags & FLAG_LAZY_DECK) ? sizeof(uint64_t) : 0;
+    size_t rngBytes = (header.flags & FLAG_RNG) ? sizeof(std::mt19937) : 0;
+    if (header.payloadSize != sizeof(scalars) + cards * sizeof(PackedCard) + drawBytes + rngBytes) return false;
+
+    // Decode into a scratch state so a bad snapshot leaves the caller's untouched
+    GameState loaded;
+    loaded.playerHealth = scalars.playerHealth;
+    loaded.enemyHealth = scalars.enemyHealth;
+    loaded.playerEnergy = scalars.playerEnergy;
+    loaded.enemyEnergy = scalars.enemyEnergy;
+    loaded.tensor.current = scalars.tensorCurrent;
+    loaded.tensor.maximum = scalars.tensorMaximum;
+    loaded.isPlayerTurn = scalars.isPlayerTurn != 0;
+    if (loaded.tensor.maximum <= 0 || loaded.tensor.current < 0 || loaded.tensor.current > loaded.tensor.maximum) return false;
+
+    const uint8_t* at = payload + sizeof(scalars);
+    auto lists = containers(loaded);
+    for (size_t i = 0; i < lists.size(); i++) {
+        lists[i]->reserve(scalars.counts[i]);
+        for (int c = 0; c < scalars.counts[i]; c++) {
+            PackedCard packed;
+            std::memcpy(&packed, at, sizeof(packed));
+            at += sizeof(packed);
+            if (!validCard(packed)) return false;
+            lists[i]->push_back(loaded.cards.add(unpack(packed)));
+        }
+    }
+    for (size_t i = 0; i < 2; i++) {
+        Field& field = *fields(loaded)[i];
+        for (int c = 0; c < scalars.counts[lists.size() + i]; c++) {
+            PackedCard packed;
+            std::memcpy(&packed, at, sizeof(packed));
+            at += sizeof(packed);
+            if (!validCard(packed) || packed.type != Card::CHAMPION || field.full()) return false;
+            int slot = packedFields ? std::countr_one(field.liveMask()) : packed.reserved[0] - 1;
+            if (slot < 0 || slot >= static_cast<int>(MAX_FIELD_SIZE) || field.occupied(slot)) return false;
+            field.place(slot, loaded.cards.add(unpack(packed)));
+        }
+    }
+
+    if (drawBytes) {
+        loaded.lazyDeck = true;
+        std::memcpy(&loaded.drawState, at, sizeof(loaded.drawState));
+        at += sizeof(loaded.drawState);
+    }
+
+    // Whatever got through the checksum must still be a position the rules can reach
+    // (a save may be taken while a tensor peak waits for its minigame)
+    if (Rules::checkInvariants(loaded, true)) return false;
+
+    if (rngBytes && rng) {
+        std::memcpy(rng, at, sizeof(*rng));
+    }
+    state = std::move(loaded);
+    return true;
+}
+
+bool Snapshot::saveFile(const std::string& path, const GameState& state, const std::mt19937* rng) {
+    std::vector<uint8_t> buffer;
+    write(state, rng, buffer);
+    std::ofstream out(path, std::ios::binary);
+    out.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+    return static_cast<bool>(out);
+}
+
+bool Snapshot::loadFile(const std::string& path, GameState& state, std::mt19937* rng) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    std::vector<uint8_t> buffer((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    return read(buffer.data(), buffer.size(), state, rng);
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include "game.h"
+
+// Versioned, checksummed binary snapshots of a GameState (optionally with the
+// match RNG). Every section is a fixed-width record written with memcpy into a
+// caller-owned buffer, so the simulator can checkpoint positions in a tight
+// loop without allocating once the buffer has grown.
+//
+// Layout (little-endian):
+//   Header  magic, version, flags, payload size, CRC-32 of the payload
+//   Scalars health/energy/turn/tensor and the five container lengths
+//   Cards   deck, player hand, enemy hand, player field, enemy field; field
+//           cards carry their slot + 1 in reserved[0]
+//   Draw    the lazy deck's 64-bit draw state when FLAG_LAZY_DECK is set
+//   RNG     raw std::mt19937 state when FLAG_RNG is set
+namespace Snapshot {
+    constexpr uint32_t MAGIC = 0x53534354;  // "TCSS"
+    constexpr uint16_t VERSION = 2;
+    constexpr uint16_t VERSION_PACKED_FIELDS = 1;  // still read: fields packed from slot 0, no lazy deck
+    constexpr uint16_t FLAG_RNG = 1;
+    constexpr uint16_t FLAG_LAZY_DECK = 2;
+
+    constexpr const char* DEFAULT_SAVE = "tensor_save.bin";
+
+    #pragma pack(push, 1)
+    struct Header {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t flags;
+        uint32_t payloadSize;
+        uint32_t checksum;
+    };
+
+    struct Scalars {
+        int16_t playerHealth;
+        int16_t enemyHealth;
+        int16_t playerEnergy;
+        int16_t enemyEnergy;
+        int8_t tensorCurrent;
+        int8_t tensorMaximum;
+        uint8_t isPlayerTurn;
+        uint8_t counts[5];  // deck, playerHand, enemyHand, playerField, enemyField
+    };
+
+    struct PackedCard {
+        uint16_t nameId;
+        uint8_t type;
+        uint8_t faction;
+        uint8_t role;
+        uint8_t flags;      // bit 0 attacked this turn, bit 1 synergy buff
+        int8_t cost;
+        int8_t attack;
+        int8_t health;
+        int8_t effect;
+        int8_t turnsInPlay;
+        int8_t originalAttack;
+        int8_t originalHealth;
+        uint8_t reserved[3];
+    };
+    #pragma pack(pop)
+
+    static_assert(sizeof(PackedCard) == 16, "PackedCard must stay 16 bytes");
+    static_assert(std::is_trivially_copyable<std::mt19937>::value, "RNG state is copied raw");
+
+    uint32_t crc32(const uint8_t* data, size_t size);
+
+    size_t size(const GameState& state, bool withRng);
+
+    // Appends nothing: out is resized to exactly the snapshot and overwritten
+    size_t write(const GameState& state, const std::mt19937* rng, std::vector<uint8_t>& out);
+
+    // Version 1 snapshots are converted on load. Fails on bad magic/version, truncation, checksum mismatch, unknown card names or
+    // enum values, non-champions on a field, or a state Rules::checkInvariants rejects.
+    // rng is only restored when the snapshot carries one and rng is non-null.
+    bool read(const uint8_t* data, size_t size, GameState& state, std::mt19937* rng);
+
+    bool saveFile(const std::string& path, const GameState& state, const std::mt19937* rng);
+    bool loadFile(const std::string& path, GameState& state, std::mt19937* rng);
+}
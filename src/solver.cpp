@@ -0,0 +1,206 @@
+#include "solver.h"
+#include "evaluator.h"
+
+namespace {
+    constexpr float WIN_SCORE = 1000.0f;
+    constexpr float EVALUATOR_SCALE = 100.0f;  // evaluator values are in [-1, 1]
+
+}
+
+TurnSolver::TurnSolver(const Evaluator* evaluator, int maxPositions)
+    : evaluator(evaluator), maxPositions(maxPositions) {}
+
+size_t TurnSolver::KeyHash::operator()(const Key& key) const {
+    uint64_t hash = 1469598103934665603ull;
+    for (uint32_t word : key) {
+        hash ^= word;
+        hash *= 1099511628211ull;
+    }
+    return static_cast<size_t>(hash);
+}
+
+void TurnSolver::turnKey(const GameState& state, Key& key) {
+    Rules::Side side = Rules::toMove(state);
+    Rules::Side opp = Rules::opponent(side);
+    const CardPool& cards = state.cards;
+    // Every card field a rule or script can read, packed at its stored width (int8 stats, uint16
+    // name ids, flags and enums under 16), so no two positions share a key. Left out is what
+    // the mover's turn cannot change: the deck, the opponent's hand and whose turn it is.
+    auto word = [&key](uint32_t value) { key.push_back(value); };
+    auto stats = [&cards](CardHandle card) {
+        return uint8_t(cards.attack[card]) | uint8_t(cards.health[card]) << 8 |
+               uint8_t(cards.originalAttack[card]) << 16 | uint32_t(uint8_t(cards.originalHealth[card])) << 24;
+    };
+    auto flags = [&cards](CardHandle card) {
+        return cards.attacked[card] | uint8_t(cards.turnsInPlay[card]) << 8 | cards.buffed[card] << 16 |
+               cards.faction[card] << 24;
+    };
+
+    key.clear();
+    word(static_cast<uint32_t>(Rules::energy(state, side)));
+    word(static_cast<uint32_t>(Rules::health(state, side)));
+    word(static_cast<uint32_t>(Rules::health(state, opp)));
+    word(static_cast<uint32_t>(state.tensor.current));
+    word(static_cast<uint32_t>(state.tensor.maximum));
+
+    // Hand order survives erase(), so equal play sets give equal sequences
+    word(static_cast<uint32_t>(Rules::hand(state, side).size()));
+    for (CardHandle card : Rules::hand(state, side)) {
+        word(cards.type[card] | cards.role[card] << 4 | uint8_t(cards.cost[card]) << 8 |
+             uint8_t(cards.effect[card]) << 16 | cards.faction[card] << 24);
+        word(stats(card));
+        word(cards.nameId[card] | cards.attacked[card] << 16 | cards.buffed[card] << 17 |
+             uint32_t(uint8_t(cards.turnsInPlay[card])) << 24);
+    }
+    // Actions name field slots, so the slot layout is part of the key
+    word(Rules::field(state, side).liveMask());
+    for (CardHandle card : Rules::field(state, side)) {
+        word(stats(card));
+        word(flags(card));
+    }
+    word(Rules::field(state, opp).liveMask() | 0x100u);  // tagged so it can't pass for an own-field card
+    for (CardHandle card : Rules::field(state, opp)) {
+        word(stats(card));
+        word(flags(card));
+    }
+}
+
+float TurnSolver::heuristic(const GameState& state, Rules::Side side) {
+    Rules::Side opp = Rules::opponent(side);
+
+    switch (Rules::result(state)) {
+        case Rules::PLAYER_WIN: return side == Rules::PLAYER ? WIN_SCORE : -WIN_SCORE;
+        case Rules::ENEMY_WIN:  return side == Rules::ENEMY ? WIN_SCORE : -WIN_SCORE;
+        case Rules::DRAW:       return 0.0f;
+        case Rules::ONGOING:    break;
+    }
+
+    const CardPool& cards = state.cards;
+    float score = 3.0f * (Rules::health(state, side) - Rules::health(state, opp));
+    for (CardHandle card : Rules::field(state, side)) {
+        score += cards.attack[card] + 0.5f * cards.health[card];
+    }
+    // Surviving enemy attackers are what hits us next turn
+    for (CardHandle card : Rules::field(state, opp)) {
+        score -= 1.5f * cards.attack[card] + 0.5f * cards.health[card];
+    }
+    score += 0.3f * Rules::energy(state, side);
+    score += 0.2f * Rules::hand(state, side).size();
+    return score;
+}
+
+uint32_t TurnSolver::expand(const GameState& state, bool peak) {
+    turnKey(state, scratchKey);
+    auto found = memo.find(scratchKey);
+    if (found != memo.end()) {
+        return found->second;
+    }
+
+    uint32_t index = nodes.size();
+    nodes.emplace_back();
+    nodes[index].peak = peak;
+    memo.emplace(scratchKey, index);
+
+    bool terminal = Rules::result(state) != Rules::ONGOING;
+    if (evaluator && !terminal) {
+        features.resize((index + 1) * Evaluator::NUM_FEATURES);
+        Evaluator::extractFeatures(state, side, &features[index * Evaluator::NUM_FEATURES]);
+        pendingLeaves.push_back(index);
+    } else {
+        nodes[index].leafValue = heuristic(state, side);
+    }
+
+    if (cancel && cancel->load(std::memory_order_relaxed)) {
+        cancelled = true;
+    }
+    if (terminal || peak || cancelled || static_cast<int>(nodes.size()) >= maxPositions) {
+        return index;
+    }
+
+    Rules::legalActions(state, scratch);
+    std::vector<Rules::Action> actions(scratch.begin(), scratch.end() - 1);  // END_TURN is the leaf itself
+
+    std::vector<Edge> local;
+    local.reserve(actions.size());
+    for (const auto& action : actions) {
+        GameState next = state;
+        bool peakNext = Rules::apply(next, action).tensorPeak;
+        local.push_back({action, expand(next, peakNext)});
+    }
+
+    nodes[index].firstEdge = edges.size();
+    nodes[index].edgeCount = local.size();
+    edges.insert(edges.end(), local.begin(), local.end());
+    return index;
+}
+
+float TurnSolver::bestValue(uint32_t index) {
+    Node& node = nodes[index];
+    if (node.solved) {
+        return node.best;
+    }
+
+    float best = node.leafValue;
+    int bestEdge = -1;
+    for (uint32_t e = 0; e < node.edgeCount; e++) {
+        float value = bestValue(edges[node.firstEdge + e].child);
+        if (value > best) {
+            best = value;
+            bestEdge = e;
+        }
+    }
+
+    // nodes may have grown while recursing, so don't reuse the reference
+    nodes[index].best = best;
+    nodes[index].bestEdge = bestEdge;
+    nodes[index].solved = true;
+    return best;
+}
+
+TurnSolver::Plan TurnSolver::solve(const GameState& state) {
+    nodes.clear();
+    edges.clear();
+    features.clear();
+    pendingLeaves.clear();
+    memo.clear();
+    cancelled = false;
+    side = Rules::toMove(state);
+
+    uint32_t root = expand(state, false);
+    if (cancelled) {
+        Plan plan;
+        plan.complete = false;
+        plan.positions = nodes.size();
+        plan.actions.push_back(Rules::Action::endTurn());
+        return plan;
+    }
+
+    // Score every distinct leaf in one batched forward pass
+    if (evaluator && !pendingLeaves.empty()) {
+        std::vector<float> batch(pendingLeaves.size() * Evaluator::NUM_FEATURES);
+        for (size_t i = 0; i < pendingLeaves.size(); i++) {
+            std::copy_n(&features[pendingLeaves[i] * Evaluator::NUM_FEATURES], Evaluator::NUM_FEATURES,
+                        &batch[i * Evaluator::NUM_FEATURES]);
+        }
+        std::vector<float> values(pendingLeaves.size());
+        evaluator->evaluate(batch.data(), pendingLeaves.size(), values.data());
+        for (size_t i = 0; i < pendingLeaves.size(); i++) {
+            nodes[pendingLeaves[i]].leafValue = values[i] * EVALUATOR_SCALE;
+        }
+    }
+
+    Plan plan;
+    plan.score = bestValue(root);
+    plan.positions = nodes.size();
+
+    uint32_t at = root;
+    while (nodes[at].bestEdge >= 0) {
+        const Edge& edge = edges[nodes[at].firstEdge + nodes[at].bestEdge];
+        plan.actions.push_back(edge.action);
+        at = edge.child;
+    }
+    if (!nodes[at].peak) {
+        plan.actions.push_back(Rules::Action::endTurn());
+    }
+    return plan;
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include "rules.h"
+#include <atomic>
+
+class Evaluator;
+
+// Exhaustive planner for the side to move's current turn.
+// Every ordering of plays, artifact targets and attacks is enumerated, with
+// transpositions merged through a table keyed on the turn-relevant state
+// (energy, hand, both fields, attacked flags), so each distinct position is
+// expanded and scored once. Leaf positions are scored in a single batch by the
+// Evaluator when one is supplied, otherwise by a static heuristic. An action
+// that fills the tensor gauge ends the line: the minigame decides what the
+// rest of the turn has to work with, so the plan stops there and the caller
+// solves again once the peak is resolved.
+class TurnSolver {
+public:
+    struct Plan {
+        std::vector<Rules::Action> actions;  // ends with END_TURN, or with the action that sets off a tensor peak
+        float score = 0.0f;                  // from the mover's point of view
+        int positions = 0;                   // distinct positions expanded
+        bool complete = true;                // false if the search was cancelled part way
+    };
+
+    static constexpr int DEFAULT_MAX_POSITIONS = 50000;
+
+    explicit TurnSolver(const Evaluator* evaluator = nullptr, int maxPositions = DEFAULT_MAX_POSITIONS);
+
+    Plan solve(const GameState& state);
+
+    // Checked while expanding; once set, solve() returns early with complete = false
+    void setCancelFlag(const std::atomic<bool>* flag) { cancel = flag; }
+
+    // Everything about a position that the rest of the turn depends on, as words:
+    // equal keys are the same position for planning, whatever their hashes
+    using Key = std::vector<uint32_t>;
+    struct KeyHash {
+        size_t operator()(const Key& key) const;  // FNV-1a over the words
+    };
+
+    static float heuristic(const GameState& state, Rules::Side side);
+    static void turnKey(const GameState& state, Key& key);
+
+private:
+    struct Edge {
+        Rules::Action action;
+        uint32_t child;
+    };
+
+    struct Node {
+        uint32_t firstEdge = 0;
+        uint32_t edgeCount = 0;
+        float leafValue = 0.0f;   // value of ending the turn here
+        float best = 0.0f;
+        int bestEdge = -1;        // -1 = end the turn here
+        bool solved = false;
+        bool peak = false;        // reached by filling the tensor gauge; not expanded
+    };
+
+    uint32_t expand(const GameState& state, bool peak);
+    float bestValue(uint32_t node);
+
+    const Evaluator* evaluator;
+    int maxPositions;
+    const std::atomic<bool>* cancel = nullptr;
+    bool cancelled = false;
+    Rules::Side side = Rules::PLAYER;
+
+    std::vector<Node> nodes;
+    std::vector<Edge> edges;
+    std::vector<float> features;          // one row per node when batching through the evaluator
+    std::vector<uint32_t> pendingLeaves;  // non-terminal nodes waiting for the evaluator
+    std::unordered_map<Key, uint32_t, KeyHash> memo;
+    std::vector<Rules::Action> scratch;
+    Key scratchKey;
+};
@@ -0,0 +1,94 @@
+#include "game.h"
+#include "evaluator.h"
+#include "turnflow.h"
+
+namespace {
+    struct SpectatorSpeed {
+        const char* label;
+        int drawEvery;   // redraw the board every Nth event, 0 = summary only
+        int delayMs;     // pause after each redraw
+    };
+
+    constexpr std::array<SpectatorSpeed, 4> SPEEDS = {{
+        {"1x", 1, 1000},
+        {"4x", 4, 250},
+        {"16x", 16, 60},
+        {"Instant (summary only)", 0, 0}
+    }};
+}
+
+// Both sides are solver agents answering the same match coroutine the game uses; the
+// board is only redrawn every few events so fast speeds don't wait on curses.
+void Game::playSpectatorMatch() {
+    std::vector<std::string> speedOptions;
+    for (const auto& speed : SPEEDS) {
+        speedOptions.push_back(speed.label);
+    }
+    int choice = showMenu(speedOptions, "Spectator Speed");
+    if (choice < 0) return;
+    const SpectatorSpeed& speed = SPEEDS[choice];
+
+    GameState match;
+    Rules::setupGame(match, rng);
+    TurnFlow::Match flow = TurnFlow::play(match);
+    TurnFlow::SolverAgent agents[2] = {TurnFlow::SolverAgent(evaluator.get()), TurnFlow::SolverAgent(evaluator.get())};
+    agents[0].setBook(book.get());
+    agents[1].setBook(book.get());
+
+    int events = 0;
+    int turns = 0;
+    bool aborted = false;
+    auto start = std::chrono::steady_clock::now();
+
+    nodelay(stdscr, TRUE);
+    while (!flow.done() && !aborted) {
+        if (flow.request().type == TurnFlow::TENSOR_PEAK) {
+            flow.resolvePeak(TurnFlow::randomPeak(match, rng));
+            continue;
+        }
+
+        TurnFlow::SolverAgent& agent = agents[flow.request().side];
+        if (agent.startingTurn()) {
+            turns++;
+        }
+        bool enemy = flow.request().side == Rules::ENEMY;
+        Rules::Action action = agent.choose(match);
+        std::string event = GameUI::describeAction(match, action);
+        flow.decide(action);
+        events++;
+
+        if (speed.drawEvery > 0 && events % speed.drawEvery == 0) {
+            match.printGameState();
+            GameUI::drawStatusBar("Turn " + std::to_string(turns) + " - " +
+                                  (enemy ? "Enemy: " : "Player: ") + event + "  (ESC to stop)");
+            refresh();
+            napms(speed.delayMs);
+        }
+
+        if (getch() == 27) {
+            aborted = true;
+        }
+    }
+    nodelay(stdscr, FALSE);
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const char* winner = "Match stopped";
+    switch (Rules::result(match)) {
+        case Rules::PLAYER_WIN: winner = "Player AI wins"; break;
+        case Rules::ENEMY_WIN:  winner = "Enemy AI wins"; break;
+        case Rules::DRAW:       winner = "Draw"; break;
+        case Rules::ONGOING:    break;
+    }
+
+    clear();
+    box(stdscr, 0, 0);
+    mvprintw(2, (COLS-20)/2, "=== MATCH SUMMARY ===");
+    mvprintw(LINES/2-2, (COLS-30)/2, "%s", winner);
+    mvprintw(LINES/2, (COLS-30)/2, "Turns: %d  Events: %d", turns, events);
+    mvprintw(LINES/2+1, (COLS-30)/2, "Health: %d vs %d", match.playerHealth, match.enemyHealth);
+    mvprintw(LINES/2+2, (COLS-30)/2, "Cards left: %zu", match.deck.size());
+    mvprintw(LINES/2+3, (COLS-30)/2, "Time: %.2fs", seconds);
+    mvprintw(LINES-2, (COLS-30)/2, "Press any key to continue...");
+    refresh();
+    getch();
+}
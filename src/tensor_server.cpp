@@ -0,0 +1,60 @@
+// Headless match server: pairs clients as they connect and referees their games.
+//
+//   tensor_server [port] [threads]
+//
+// Prints throughput every few seconds; Ctrl+C stops it.
+
+#include "server.h"
+#include "effects.h"
+#include <csignal>
+
+namespace {
+    std::atomic<bool> interrupted{false};
+
+    void onSignal(int) {
+        interrupted = true;
+    }
+}
+
+int main(int argc, char** argv) {
+    uint16_t port = argc > 1 ? static_cast<uint16_t>(std::atoi(argv[1])) : Protocol::DEFAULT_PORT;
+    int threads = argc > 2 ? std::atoi(argv[2]) : 0;
+
+    std::string effectsError;
+    if (!Effects::loadDefaultFile(effectsError)) {
+        std::cerr << effectsError << "\n";
+        return 1;
+    }
+
+    MatchServer server(port, threads, static_cast<uint32_t>(std::random_device{}()));
+    if (!server.start()) {
+        std::cerr << "Cannot listen on port " << port << "\n";
+        return 1;
+    }
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+    std::cout << "Listening on port " << server.port() << " with " << server.threads() << " workers\n";
+
+    const auto& stats = server.stats();
+    uint64_t lastActions = 0;
+    auto last = std::chrono::steady_clock::now();
+    while (!interrupted) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        auto now = std::chrono::steady_clock::now();
+        double seconds = std::chrono::duration<double>(now - last).count();
+        if (seconds < 5.0) continue;
+
+        uint64_t actions = stats.actions;
+        uint64_t live = stats.matchesStarted - stats.matchesFinished;
+        std::cout << "connections " << stats.connections << "  live matches " << live
+                  << "  finished " << stats.matchesFinished << "  actions/s "
+                  << std::fixed << std::setprecision(0) << (actions - lastActions) / seconds
+                  << "  rejected " << stats.rejected << "\n";
+        lastActions = actions;
+        last = now;
+    }
+
+    server.stop();
+    std::cout << "Stopped after " << stats.matchesFinished << " matches\n";
+    return 0;
+}
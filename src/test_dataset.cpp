@@ -0,0 +1,204 @@
+#include "testing.h"
+#include "dataset.h"
+#include <filesystem>
+#include <fstream>
+
+namespace {
+    std::string tempPath(const char* name) {
+        return (std::filesystem::temp_directory_path() / name).string();
+    }
+
+    std::vector<uint8_t> readBytes(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        return std::vector<uint8_t>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    void writeBytes(const std::string& path, const std::vector<uint8_t>& bytes) {
+        std::ofstream out(path, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    }
+
+    // Rows cycle through a few dozen real positions; row i's game id is i so every row is distinct
+    std::vector<Dataset::PositionRow> samplePositions() {
+        std::vector<Dataset::PositionRow> rows;
+        GameState state;
+        for (uint32_t seed = 1; seed <= 40; seed++) {
+            Testing::playRandom(state, seed, seed % 30);
+            rows.emplace_back();
+            Dataset::encode(state, rows.back());
+        }
+        return rows;
+    }
+
+    Rules::Action sampleAction(uint64_t row) {
+        switch (row % 3) {
+            case 0: return Rules::Action::play(row % 5, -1);
+            case 1: return Rules::Action::attack(row % MAX_FIELD_SIZE, static_cast<int>(row % 2) - 1);
+            default: return Rules::Action::endTurn();
+        }
+    }
+
+    // A file of two row groups, the second one partial; written once and removed at exit
+    struct SampleFile {
+        std::string path = tempPath("tensor_test_dataset.tcd");
+
+        SampleFile() {
+            std::vector<Dataset::PositionRow> positions = samplePositions();
+            Dataset::Writer writer;
+            writer.open(path);
+            for (uint64_t row = 0; row < Dataset::GROUP_ROWS + 1000; row++) {
+                writer.append(positions[row % positions.size()], sampleAction(row), row % 2 ? 1 : -1, row);
+            }
+            writer.close();
+        }
+        ~SampleFile() { std::filesystem::remove(path); }
+    };
+
+    const std::string& sampleFile() {
+        static const SampleFile file;
+        return file.path;
+    }
+
+    template <typename Edit>
+    bool opensAfter(Edit edit) {
+        std::vector<uint8_t> bytes = readBytes(sampleFile());
+        edit(bytes);
+        std::string path = tempPath("tensor_test_corrupt.tcd");
+        writeBytes(path, bytes);
+        Dataset::Reader reader;
+        bool opened = reader.open(path);
+        reader.close();
+        std::filesystem::remove(path);
+        return opened;
+    }
+
+    template <typename T>
+    void poke(std::vector<uint8_t>& bytes, uint64_t at, T value) {
+        std::memcpy(&bytes[at], &value, sizeof(value));
+    }
+
+    uint64_t indexOffset(const std::vector<uint8_t>& bytes) {
+        Dataset::Footer footer;
+        std::memcpy(&footer, bytes.data() + bytes.size() - sizeof(footer), sizeof(footer));
+        return footer.indexOffset;
+    }
+}
+
+TEST(dataset_round_trip) {
+    std::vector<Dataset::PositionRow> positions = samplePositions();
+    Dataset::Reader reader;
+    CHECK(reader.open(sampleFile()));
+    CHECK(reader.rows() == Dataset::GROUP_ROWS + 1000);
+    CHECK(reader.groups() == 2);
+    for (uint64_t row = 0; row < reader.rows(); row += 997) {
+        CHECK(std::memcmp(&reader.position(row), &positions[row % positions.size()], sizeof(Dataset::PositionRow)) == 0);
+        Rules::Action action = Dataset::unpackAction(reader.action(row));
+        Rules::Action expected = sampleAction(row);
+        CHECK(action.type == expected.type && action.index == expected.index && action.target == expected.target);
+        CHECK(reader.outcome(row) == (row % 2 ? 1 : -1));
+        CHECK(reader.game(row) == row);
+    }
+    uint64_t count = 0;
+    const uint32_t* games = reader.groupColumn<uint32_t>(1, Dataset::GAME, count);
+    CHECK(count == 1000 && games[0] == Dataset::GROUP_ROWS);
+}
+
+TEST(dataset_decode_keeps_slots) {
+    // encode(decode(row)) must give the row back, field slots included
+    for (const Dataset::PositionRow& row : samplePositions()) {
+        GameState state;
+        CHECK(Dataset::decode(row, state));
+        Dataset::PositionRow again;
+        Dataset::encode(state, again);
+        CHECK(std::memcmp(&row, &again, sizeof(row)) == 0);
+    }
+}
+
+TEST(dataset_decode_rejects_corrupt_rows) {
+    // Reader::open checks the layout, not the rows, so decode sees whatever the file holds
+    std::vector<Dataset::PositionRow> rows = samplePositions();
+    auto found = std::find_if(rows.begin(), rows.end(), [](const Dataset::PositionRow& row) {
+        return row.handCount[0] > 0 && row.fieldSlots[1] != 0;
+    });
+    CHECK(found != rows.end());
+    if (found == rows.end()) return;
+    const Dataset::PositionRow& row = *found;
+    int slot = std::countr_zero(unsigned(row.fieldSlots[1]));
+
+    GameState state;
+    auto decodesAfter = [&](auto edit) {
+        Dataset::PositionRow crafted = row;
+        edit(crafted);
+        return Dataset::decode(crafted, state);
+    };
+    CHECK(decodesAfter([](Dataset::PositionRow& r) { r.handCount[0] = 200; }));
+    CHECK(state.playerHand.size() == Dataset::HAND_SLOTS);
+    CHECK(state.cards.size <= CardPool::CAPACITY);
+
+    CHECK(!decodesAfter([](Dataset::PositionRow& r) { r.hand[0][0].typeFaction = (Card::TENSOR + 1) << 4; }));
+    CHECK(!decodesAfter([](Dataset::PositionRow& r) { r.hand[0][0].typeFaction = Card::VIRTU_MACHINA + 1; }));
+    CHECK(!decodesAfter([&](Dataset::PositionRow& r) { r.field[1][slot].roleFlags = (Card::MAGE + 1) << 4; }));
+}
+
+TEST(dataset_rejects_corrupt_files) {
+    CHECK(opensAfter([](std::vector<uint8_t>&) {}));
+    CHECK(!opensAfter([](std::vector<uint8_t>& bytes) { bytes.resize(bytes.size() / 2); }));
+    CHECK(!opensAfter([](std::vector<uint8_t>& bytes) { bytes.resize(sizeof(Dataset::FileHeader)); }));
+    CHECK(!opensAfter([](std::vector<uint8_t>& bytes) { bytes[0] ^= 1; }));
+
+    auto fromEnd = [&](std::vector<uint8_t>& bytes, size_t member) { return bytes.size() - sizeof(Dataset::Footer) + member; };
+    CHECK(!opensAfter([&](std::vector<uint8_t>& bytes) {
+        poke<uint64_t>(bytes, fromEnd(bytes, offsetof(Dataset::Footer, groups)), 1ull << 60);  // groups * 112 wraps
+    }));
+    CHECK(!opensAfter([&](std::vector<uint8_t>& bytes) {
+        poke<uint64_t>(bytes, fromEnd(bytes, offsetof(Dataset::Footer, indexOffset)), ~0ull);
+    }));
+    CHECK(!opensAfter([&](std::vector<uint8_t>& bytes) {
+        poke<uint64_t>(bytes, fromEnd(bytes, offsetof(Dataset::Footer, rows)), Dataset::GROUP_ROWS * 3ull);
+    }));
+
+    // Index entries: the second group's columns, row counts and first row
+    auto group = [](std::vector<uint8_t>& bytes, int g, size_t member) {
+        return indexOffset(bytes) + g * sizeof(Dataset::GroupIndex) + member;
+    };
+    size_t offsets = offsetof(Dataset::GroupIndex, offsets);
+    CHECK(!opensAfter([&](std::vector<uint8_t>& bytes) {
+        poke<uint64_t>(bytes, group(bytes, 1, offsets + 8 * Dataset::POSITION), indexOffset(bytes));  // runs into the index
+    }));
+    CHECK(!opensAfter([&](std::vector<uint8_t>& bytes) {
+        poke<uint64_t>(bytes, group(bytes, 1, offsets + 8 * Dataset::GAME), bytes.size() * 4);  // past the end
+    }));
+    CHECK(!opensAfter([&](std::vector<uint8_t>& bytes) {
+        uint64_t offset;
+        std::memcpy(&offset, &bytes[group(bytes, 0, offsets + 8 * Dataset::ACTION)], sizeof(offset));
+        poke<uint64_t>(bytes, group(bytes, 0, offsets + 8 * Dataset::ACTION), offset + 4);  // misaligned
+    }));
+    CHECK(!opensAfter([&](std::vector<uint8_t>& bytes) {
+        poke<uint64_t>(bytes, group(bytes, 0, offsetof(Dataset::GroupIndex, rows)), 1000);  // lookups assume full groups
+    }));
+    CHECK(!opensAfter([&](std::vector<uint8_t>& bytes) {
+        poke<uint64_t>(bytes, group(bytes, 1, offsetof(Dataset::GroupIndex, firstRow)), 5);
+    }));
+}
+
+TEST(dataset_rejects_other_versions) {
+    // Version 1 packed field cards from index 0 and had no slot mask; those files are regenerated, not read
+    for (uint16_t version : {uint16_t(1), uint16_t(Dataset::SCHEMA_VERSION + 1)}) {
+        CHECK(!opensAfter([=](std::vector<uint8_t>& bytes) {
+            poke<uint16_t>(bytes, offsetof(Dataset::FileHeader, version), version);
+        }));
+    }
+}
+
+#ifndef _WIN32
+TEST(dataset_reports_write_failure) {
+    // Every write to /dev/full fails with ENOSPC, at the latest when the stream is flushed
+    Dataset::Writer writer;
+    if (!writer.open("/dev/full")) return;
+    Dataset::PositionRow row{};
+    for (int i = 0; i < 1000; i++) {
+        writer.append(row, Rules::Action::endTurn(), 1, i);
+    }
+    CHECK(!writer.close());
+}
+#endif
@@ -0,0 +1,219 @@
+#include "testing.h"
+#include "effects.h"
+
+namespace {
+    std::string compileError(const std::string& source) {
+        std::string error;
+        if (Effects::load(source, error)) {
+            Effects::load(Effects::BUILTIN, error);
+            return "";
+        }
+        return error;
+    }
+
+    std::string repeat(const std::string& text, int times) {
+        std::string out;
+        for (int i = 0; i < times; i++) out += text;
+        return out;
+    }
+
+    bool failsWith(const std::string& source, const std::string& message) {
+        std::string error = compileError(source);
+        if (error.find(message) != std::string::npos) return true;
+        std::cout << "  expected \"" << message << "\", got \"" << error << "\"\n";
+        return false;
+    }
+
+    // A fresh match with empty hands, the player to move with energy to spare
+    GameState emptyHands() {
+        GameState state;
+        std::mt19937 rng(1);
+        Rules::setupGame(state, rng);
+        state.playerHand.clear();
+        state.enemyHand.clear();
+        state.playerEnergy = 20;
+        return state;
+    }
+
+    Card champion(Card::Faction faction, int attack = 2, int health = 2) {
+        Card card(Card::CHAMPION, "Test Champion", 1, attack, health, 0);
+        card.faction = faction;
+        return card;
+    }
+
+    // Puts card in the player's hand and plays it
+    CardHandle play(GameState& state, const Card& card, int target = -1) {
+        CardHandle handle = state.cards.add(card);
+        state.playerHand.push_back(handle);
+        CHECK(Rules::apply(state, Rules::Action::play(state.playerHand.size() - 1, target)).legal);
+        return handle;
+    }
+}
+
+TEST(effects_builtin_compiles) {
+    CHECK(compileError(Effects::BUILTIN).empty());
+    CHECK(Effects::entry(Effects::PLAY, Card::TENSOR) != 0);
+    CHECK(Effects::entry(Effects::FIELD, Card::TECHNO) != 0);
+}
+
+TEST(effects_compile_errors) {
+    const std::string play = "on play TENSOR:\n";
+    CHECK(failsWith(play + "    gauge_max += 1\n", "line 2: gauge_max is read-only"));
+    CHECK(failsWith(play + "    level = 2\n", "level is read-only"));
+    CHECK(failsWith(play + "    concordia_attack -= 1\n", "concordia_attack is read-only"));
+    CHECK(failsWith(play + "    target.faction = 1\n", "faction is read-only"));
+    CHECK(failsWith(play + "    mana += 1\n", "unknown variable 'mana'"));
+    CHECK(failsWith(play + "    target.speed += 1\n", "unknown card field 'speed'"));
+    CHECK(failsWith(play + "    energy 1\n", "expected '=', '+=' or '-='"));
+    CHECK(failsWith(play + "    energy += 40000\n", "constant out of range"));
+    CHECK(failsWith(play + "    if energy > 1\n        gauge += 1\n", "'if' without 'end'"));
+    CHECK(failsWith(play + "    energy += (1\n", "expected ')'"));
+    CHECK(failsWith("on draw TENSOR:\n    energy += 1\n", "unknown scope 'draw'"));
+    CHECK(failsWith("on field:\n    energy += 1\n", "field needs a faction"));
+    CHECK(failsWith("on play \"Netrunner:\n    energy += 1\n", "unterminated string"));
+    CHECK(failsWith("on end_turn EXEC:\n    target.attack += 1\n", "no cards in end_turn sections"));
+    CHECK(failsWith(play + "    energy += 1\n" + play + "    gauge += 1\n", "section defined twice"));
+    CHECK(failsWith("\n\n" + play + "    health += 1\n    bogus += 1\n", "line 5:"));
+}
+
+TEST(effects_bound_stack_and_nesting) {
+    const std::string play = "on play TENSOR:\n    energy += ";
+    // Each open "1 + (" leaves a value on the interpreter's stack
+    CHECK(failsWith(play + repeat("1 + (", 20) + "1" + repeat(")", 20) + "\n", "expression too deep"));
+    CHECK(compileError(play + repeat("1 + (", 8) + "1" + repeat(")", 8) + "\n").empty());
+
+    // Plain nesting costs no stack but does cost the parser's recursion
+    CHECK(failsWith(play + repeat("(", 100000) + "1" + repeat(")", 100000) + "\n", "nested too deeply"));
+    CHECK(failsWith(play + repeat("-", 100000) + "1\n", "nested too deeply"));
+    CHECK(failsWith("on play TENSOR:\n" + repeat("    if 1\n", 100000), "nested too deeply"));
+    CHECK(compileError(play + repeat("(", 30) + "1" + repeat(")", 30) + "\n").empty());
+}
+
+TEST(effects_failed_load_keeps_active_script) {
+    std::string error;
+    CHECK(Effects::load(Effects::BUILTIN, error));
+    uint32_t tensor = Effects::entry(Effects::PLAY, Card::TENSOR);
+    CHECK(!Effects::load("on play TENSOR:\n    gauge_max = 1\n", error));
+    CHECK(Effects::entry(Effects::PLAY, Card::TENSOR) == tensor);
+
+    CHECK(Effects::load("on play CHAMPION:\n    energy += 1\n", error));
+    CHECK(Effects::entry(Effects::PLAY, Card::TENSOR) == 0);
+    CHECK(Effects::load(Effects::BUILTIN, error));
+}
+
+TEST(effects_builtin_matches_the_original_rules) {
+    // Odd artifacts add to attack, even ones to health
+    GameState state = emptyHands();
+    CardHandle champ = play(state, champion(Card::FACTION_NONE));
+    int slot = std::countr_zero(unsigned(state.playerField.liveMask()));
+    play(state, Card(Card::ARTIFACT, "Test Artifact", 1, 0, 0, 3), slot);
+    CHECK(state.cards.attack[champ] == 5 && state.cards.health[champ] == 2);
+    play(state, Card(Card::ARTIFACT, "Test Artifact", 1, 0, 0, 2), slot);
+    CHECK(state.cards.attack[champ] == 5 && state.cards.health[champ] == 4);
+
+    // Tensor shards pay their effect in energy and feed the gauge by one
+    int energy = state.playerEnergy, gauge = state.tensor.current;
+    play(state, Card(Card::TENSOR, "Test Shard", 0, 0, 0, 2));
+    CHECK(state.playerEnergy == energy + 2 && state.tensor.current == gauge + 1);
+
+    // Synergy level is the faction's count less one: Techno adds it to attack, Cyber to health
+    state = emptyHands();
+    CardHandle techno = play(state, champion(Card::TECHNO));
+    play(state, champion(Card::TECHNO));
+    CHECK(state.cards.attack[techno] == 3);
+    play(state, champion(Card::TECHNO));
+    CHECK(state.cards.attack[techno] == 4 && state.cards.health[techno] == 2);
+    state = emptyHands();
+    CardHandle cyber = play(state, champion(Card::CYBER));
+    play(state, champion(Card::CYBER));
+    CHECK(state.cards.attack[cyber] == 2 && state.cards.health[cyber] == 3);
+
+    // Exec lowers the cost of Exec cards in hand, never below zero
+    state = emptyHands();
+    CardHandle pricey = state.cards.add(champion(Card::EXEC));
+    state.cards.cost[pricey] = 3;
+    state.playerHand.push_back(pricey);
+    play(state, champion(Card::EXEC));
+    play(state, champion(Card::EXEC));
+    CHECK(state.cards.cost[pricey] == 2);
+
+    // Virtu-Machina pays its level in energy at the end of the turn and feeds the gauge
+    state = emptyHands();
+    play(state, champion(Card::VIRTU_MACHINA));
+    play(state, champion(Card::VIRTU_MACHINA));
+    energy = state.playerEnergy;
+    gauge = state.tensor.current;
+    Rules::apply(state, Rules::Action::endTurn());
+    CHECK(state.playerEnergy == energy + 1 + 1 && state.tensor.current == gauge + 1);
+
+    // One champion of every faction: Tensor Concordia, +3/+3 each
+    state = emptyHands();
+    std::vector<CardHandle> four;
+    for (int f = Card::TECHNO; f <= Card::VIRTU_MACHINA; f++) {
+        four.push_back(play(state, champion(static_cast<Card::Faction>(f))));
+    }
+    for (CardHandle card : four) {
+        CHECK(state.cards.attack[card] == 5 && state.cards.health[card] == 5 && state.cards.buffed[card]);
+    }
+}
+
+TEST(effects_named_section_overrides_its_type) {
+    std::string error;
+    CHECK(Effects::load(std::string(Effects::BUILTIN) + "\non play \"Test Overclock\":\n    energy += 7\n", error));
+    GameState state = emptyHands();
+    int energy = state.playerEnergy, gauge = state.tensor.current;
+    play(state, Card(Card::TENSOR, "Test Overclock", 0, 0, 0, 2));
+    CHECK(state.playerEnergy == energy + 7 && state.tensor.current == gauge);
+    play(state, Card(Card::TENSOR, "Test Shard", 0, 0, 0, 2));
+    CHECK(state.playerEnergy == energy + 7 + 2 && state.tensor.current == gauge + 1);
+    CHECK(Effects::load(Effects::BUILTIN, error));
+}
+
+TEST(effects_hostile_script_keeps_invariants) {
+    // Every write here is legal to compile and out of range for the engine
+    const char* hostile = R"(
+on play ARTIFACT:
+    target.health -= 10
+    target.attack -= 10
+    target.turns = 5
+on play CHAMPION:
+    energy -= 5
+    enemy_energy -= 5
+    target.turns = -3
+on play TENSOR:
+    gauge = -1
+on hand EXEC:
+    target.cost = -9
+on field TECHNO:
+    target.health = 0
+on field CYBER:
+    target.attack = -100
+on end_turn VIRTU_MACHINA:
+    gauge += 100
+on concordia:
+    target.attack -= 50
+)";
+    std::string error;
+    CHECK(Effects::load(hostile, error));
+    std::vector<Rules::Action> actions;
+    int plies = 0;
+    for (uint32_t seed = 1; seed <= 200; seed++) {
+        std::mt19937 rng(seed);
+        GameState state;
+        Rules::setupGame(state, rng);
+        while (Rules::result(state) == Rules::ONGOING && plies++ < 1000000) {
+            Rules::legalActions(state, actions);
+            Rules::Action action = actions[rng() % actions.size()];
+            Rules::Outcome outcome = Rules::apply(state, action);
+            const char* broken = Rules::checkInvariants(state, outcome.tensorPeak);
+            CHECK(broken == nullptr);
+            if (broken) {
+                std::cout << "  " << broken << "\n";
+                break;
+            }
+            if (outcome.tensorPeak) Rules::resolveTensorPeak(state, rng);
+        }
+    }
+    CHECK(plies > 1000);
+    CHECK(Effects::load(Effects::BUILTIN, error));
+}
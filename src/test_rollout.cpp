@@ -0,0 +1,107 @@
+#include "testing.h"
+#include "rollout.h"
+
+namespace {
+    bool sameAction(const Rules::Action& a, const Rules::Action& b) {
+        return a.type == b.type && a.index == b.index && a.target == b.target;
+    }
+
+    // A smaller field and dearer synergies, so the Configured instantiation sees other numbers
+    RuleSet variant() {
+        RuleSet rules;
+        rules.fieldSize = 3;
+        rules.synergyCards = 3;
+        rules.tensorStart = 4;
+        return rules;
+    }
+    const RuleSet VARIANT = variant();
+
+    // Walks random matches and hands every ongoing position to check
+    template <typename Check>
+    void forEachPosition(const RuleSet& rules, int games, Check check) {
+        std::vector<Rules::Action> actions;
+        for (uint32_t seed = 1; seed <= static_cast<uint32_t>(games); seed++) {
+            std::mt19937 rng(seed);
+            GameState state;
+            Rules::setupGame(state, rng, Rules::LAZY_DECK, rules);
+            for (int ply = 0; ply < 300 && Rules::result(state) == Rules::ONGOING; ply++) {
+                check(state);
+                Rules::legalActions(state, actions);
+                Rules::step(state, actions[rng() % actions.size()], rng);
+            }
+        }
+    }
+
+    void checkLegalAndInvariant(const RuleSet& rules) {
+        Rollout::Rng rng(7);
+        std::vector<Rules::Action> legal;
+        int positions = 0;
+        forEachPosition(rules, 60, [&](const GameState& state) {
+            positions++;
+            Rules::legalActions(state, legal);
+            for (int draw = 0; draw < 8; draw++) {
+                Rules::Action action = Rollout::randomAction(state, rng);
+                bool listed = std::any_of(legal.begin(), legal.end(), [&](const Rules::Action& a) { return sameAction(a, action); });
+                CHECK(listed);
+                CHECK(Rules::isLegal(state, action));
+
+                GameState next = state;
+                Rules::Outcome outcome = Rules::applyUnchecked(next, action);
+                CHECK(outcome.legal);
+                CHECK(Rules::checkInvariants(next, outcome.tensorPeak) == nullptr);
+                if (!listed) return;  // one report per position is enough
+            }
+        });
+        CHECK(positions > 1000);
+    }
+}
+
+TEST(rollout_random_action_is_legal_standard) {
+    checkLegalAndInvariant(RuleSet::STANDARD);
+}
+
+TEST(rollout_random_action_is_legal_configured) {
+    checkLegalAndInvariant(VARIANT);
+}
+
+TEST(rollout_random_action_covers_legal_moves) {
+    // Ends the turn 15% of the time when anything else is legal, otherwise uniform over the rest
+    Rollout::Rng rng(11);
+    std::vector<Rules::Action> legal;
+    int checked = 0;
+    forEachPosition(RuleSet::STANDARD, 6, [&](const GameState& state) {
+        Rules::legalActions(state, legal);
+        if (legal.size() < 3 || checked >= 20) return;
+        checked++;
+        const int draws = 20000;
+        std::vector<int> counts(legal.size());
+        for (int draw = 0; draw < draws; draw++) {
+            Rules::Action action = Rollout::randomAction(state, rng);
+            for (size_t i = 0; i < legal.size(); i++) {
+                if (sameAction(legal[i], action)) counts[i]++;
+            }
+        }
+        size_t others = legal.size() - 1;  // END_TURN is listed last
+        CHECK(std::abs(counts.back() / float(draws) - 0.15f) < 0.02f);
+        for (size_t i = 0; i < others; i++) {
+            float expected = 0.85f / others;
+            CHECK(std::abs(counts[i] / float(draws) - expected) < 0.25f * expected + 0.01f);
+        }
+    });
+    CHECK(checked == 20);
+}
+
+TEST(rollout_playouts_finish) {
+    Rollout::Rng rng(3);
+    std::mt19937 peakRng(3);
+    for (uint32_t seed = 1; seed <= 50; seed++) {
+        std::mt19937 setup(seed);
+        GameState state;
+        Rules::setupGame(state, setup, Rules::LAZY_DECK, seed % 2 ? RuleSet::STANDARD : VARIANT);
+        int plies = 0;
+        Rules::Result result = Rollout::playout(state, rng, peakRng, plies);
+        CHECK(result != Rules::ONGOING);
+        CHECK(plies <= Rollout::MAX_PLIES);
+        CHECK(Rules::checkInvariants(state) == nullptr);
+    }
+}
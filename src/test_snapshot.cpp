@@ -0,0 +1,167 @@
+#include "testing.h"
+#include "snapshot.h"
+
+namespace {
+    // A mid-game position with champions on both fields, so every section of the format is used
+    // gap asks for a player field with an empty slot below a live one
+    GameState midGame(Rules::DeckOrder order = Rules::LAZY_DECK, bool gap = false) {
+        GameState state;
+        for (uint32_t seed = 1;; seed++) {
+            Testing::playRandom(state, seed, 40, order);
+            unsigned live = state.playerField.liveMask();
+            if (Rules::result(state) == Rules::ONGOING && state.playerField.count() && state.enemyField.count() &&
+                (!gap || (live & (live + 1)) != 0)) {
+                return state;
+            }
+        }
+    }
+
+    size_t fieldOffset(const GameState& state) {
+        size_t cards = state.deck.size() + state.playerHand.size() + state.enemyHand.size();
+        return sizeof(Snapshot::Header) + sizeof(Snapshot::Scalars) + cards * sizeof(Snapshot::PackedCard);
+    }
+
+    // Recomputes the checksum so a test reaches the checks behind it
+    void reseal(std::vector<uint8_t>& bytes) {
+        Snapshot::Header header;
+        std::memcpy(&header, bytes.data(), sizeof(header));
+        header.checksum = Snapshot::crc32(bytes.data() + sizeof(header), header.payloadSize);
+        std::memcpy(bytes.data(), &header, sizeof(header));
+    }
+
+    template <typename Edit>
+    bool readsAfter(const GameState& state, Edit edit) {
+        std::vector<uint8_t> bytes;
+        Snapshot::write(state, nullptr, bytes);
+        edit(bytes);
+        reseal(bytes);
+        GameState loaded;
+        return Snapshot::read(bytes.data(), bytes.size(), loaded, nullptr);
+    }
+}
+
+TEST(snapshot_round_trip) {
+    GameState state = midGame();
+    std::mt19937 rng(99);
+    rng.discard(17);
+    std::vector<uint8_t> bytes;
+    CHECK(Snapshot::write(state, &rng, bytes) == Snapshot::size(state, true));
+
+    GameState loaded;
+    std::mt19937 restored;
+    CHECK(Snapshot::read(bytes.data(), bytes.size(), loaded, &restored));
+    CHECK(restored == rng);
+    CHECK(loaded.playerHealth == state.playerHealth && loaded.enemyEnergy == state.enemyEnergy);
+    CHECK(loaded.tensor.current == state.tensor.current && loaded.tensor.maximum == state.tensor.maximum);
+    CHECK(loaded.playerField.liveMask() == state.playerField.liveMask());
+    CHECK(loaded.enemyField.liveMask() == state.enemyField.liveMask());
+    CHECK(loaded.playerHand.size() == state.playerHand.size() && loaded.deck.size() == state.deck.size());
+
+    // Writing the loaded state again gives the same bytes
+    std::vector<uint8_t> again;
+    Snapshot::write(loaded, &restored, again);
+    CHECK(again == bytes);
+}
+
+TEST(snapshot_rejects_truncation_and_bit_flips) {
+    GameState state = midGame();
+    std::vector<uint8_t> bytes;
+    Snapshot::write(state, nullptr, bytes);
+    GameState loaded;
+    for (size_t size = 0; size < bytes.size(); size++) {
+        CHECK(!Snapshot::read(bytes.data(), size, loaded, nullptr));
+    }
+    for (size_t at = 0; at < bytes.size(); at += 7) {
+        std::vector<uint8_t> flipped = bytes;
+        flipped[at] ^= 0x10;
+        CHECK(!Snapshot::read(flipped.data(), flipped.size(), loaded, nullptr));
+    }
+}
+
+TEST(snapshot_failed_read_leaves_state_alone) {
+    GameState state = midGame();
+    std::vector<uint8_t> bytes;
+    Snapshot::write(state, nullptr, bytes);
+    bytes.back() ^= 1;
+    GameState target = midGame();
+    int health = target.playerHealth;
+    size_t deck = target.deck.size();
+    CHECK(!Snapshot::read(bytes.data(), bytes.size(), target, nullptr));
+    CHECK(target.playerHealth == health && target.deck.size() == deck);
+}
+
+TEST(snapshot_rejects_bad_cards) {
+    GameState state = midGame();
+    size_t deckCard = sizeof(Snapshot::Header) + sizeof(Snapshot::Scalars);
+    size_t fieldCard = fieldOffset(state);
+    CHECK(readsAfter(state, [](std::vector<uint8_t>&) {}));
+
+    auto setByte = [](size_t at, size_t member, uint8_t value) {
+        return [=](std::vector<uint8_t>& bytes) { bytes[at + member] = value; };
+    };
+    CHECK(!readsAfter(state, setByte(deckCard, offsetof(Snapshot::PackedCard, type), Card::TENSOR + 1)));
+    CHECK(!readsAfter(state, setByte(deckCard, offsetof(Snapshot::PackedCard, faction), Card::VIRTU_MACHINA + 1)));
+    CHECK(!readsAfter(state, setByte(deckCard, offsetof(Snapshot::PackedCard, role), Card::MAGE + 1)));
+    CHECK(!readsAfter(state, [&](std::vector<uint8_t>& bytes) {
+        uint16_t unknown = static_cast<uint16_t>(CardNames::count());
+        std::memcpy(&bytes[deckCard + offsetof(Snapshot::PackedCard, nameId)], &unknown, sizeof(unknown));
+    }));
+    CHECK(!readsAfter(state, setByte(fieldCard, offsetof(Snapshot::PackedCard, type), Card::ARTIFACT)));
+    CHECK(!readsAfter(state, setByte(fieldCard, offsetof(Snapshot::PackedCard, reserved), MAX_FIELD_SIZE + 1)));
+}
+
+TEST(snapshot_rejects_bad_gauge_and_state) {
+    GameState state = midGame();
+    size_t scalars = sizeof(Snapshot::Header);
+    auto setScalar = [&](size_t member, auto value) {
+        return [=](std::vector<uint8_t>& bytes) { std::memcpy(&bytes[scalars + member], &value, sizeof(value)); };
+    };
+    CHECK(!readsAfter(state, setScalar(offsetof(Snapshot::Scalars, tensorMaximum), int8_t(0))));
+    CHECK(!readsAfter(state, setScalar(offsetof(Snapshot::Scalars, tensorCurrent), int8_t(-1))));
+    CHECK(!readsAfter(state, setScalar(offsetof(Snapshot::Scalars, tensorCurrent), int8_t(state.tensor.maximum + 1))));
+    // Negative energy decodes fine but no reachable position has it
+    CHECK(!readsAfter(state, setScalar(offsetof(Snapshot::Scalars, playerEnergy), int16_t(-3))));
+}
+
+TEST(snapshot_converts_version_1) {
+    // Version 1 had no slots: field cards were packed from slot 0 and reserved[0] was zero
+    GameState state = midGame(Rules::SHUFFLED_DECK, true);
+    std::vector<uint8_t> bytes;
+    Snapshot::write(state, nullptr, bytes);
+    Snapshot::Header header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    header.version = Snapshot::VERSION_PACKED_FIELDS;
+    std::memcpy(bytes.data(), &header, sizeof(header));
+    for (size_t at = fieldOffset(state); at < bytes.size(); at += sizeof(Snapshot::PackedCard)) {
+        bytes[at + offsetof(Snapshot::PackedCard, reserved)] = 0;
+    }
+    reseal(bytes);
+
+    GameState loaded;
+    CHECK(Snapshot::read(bytes.data(), bytes.size(), loaded, nullptr));
+    int count = state.playerField.count();
+    CHECK(loaded.playerField.count() == count && loaded.playerField.liveMask() == (1u << count) - 1);
+    int slot = 0;
+    for (CardHandle card : state.playerField) {
+        CHECK(loaded.cards.attack[loaded.playerField[slot++]] == state.cards.attack[card]);
+    }
+}
+
+TEST(snapshot_rejects_other_versions) {
+    GameState lazy = midGame(Rules::LAZY_DECK);
+    CHECK(lazy.lazyDeck);
+    auto setVersion = [](uint16_t version) {
+        return [=](std::vector<uint8_t>& bytes) {
+            std::memcpy(&bytes[offsetof(Snapshot::Header, version)], &version, sizeof(version));
+        };
+    };
+    CHECK(!readsAfter(lazy, setVersion(Snapshot::VERSION_PACKED_FIELDS)));  // version 1 had no lazy deck
+    CHECK(!readsAfter(lazy, setVersion(0)));
+    CHECK(!readsAfter(lazy, setVersion(Snapshot::VERSION + 1)));
+
+    // A current snapshot must say where every field card goes
+    size_t fieldCard = fieldOffset(lazy);
+    CHECK(!readsAfter(lazy, [=](std::vector<uint8_t>& bytes) {
+        bytes[fieldCard + offsetof(Snapshot::PackedCard, reserved)] = 0;
+    }));
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include "rules.h"
+
+// Minimal unit test registry for the tests runner (tests.cpp).
+//
+// A test file defines its cases with TEST(name) { ... } and checks with
+// CHECK(expr); a failed check is reported with its file and line and the case
+// carries on, so one run lists every broken expectation. Cases register
+// themselves at static initialisation, so adding a file to the build line is
+// all it takes to run it.
+namespace Testing {
+    using Case = void (*)();
+
+    struct Registration {
+        Registration(const char* name, Case run);
+    };
+
+    void fail(const char* file, int line, const char* expression);
+
+    // Shared fixture: a standard match played from seed by random legal moves
+    // (peaks resolved headless) for up to plies moves, stopping early if it ends
+    void playRandom(GameState& state, uint32_t seed, int plies, Rules::DeckOrder order = Rules::LAZY_DECK);
+}
+
+#define TEST(name) \
+    static void test_##name(); \
+    static const Testing::Registration registration_##name(#name, test_##name); \
+    static void test_##name()
+
+#define CHECK(expression) \
+    ((expression) ? static_cast<void>(0) : Testing::fail(__FILE__, __LINE__, #expression))
@@ -0,0 +1,62 @@
+// Unit tests for the file formats, the rollout policy and the effect compiler.
+//
+//   tests              run every case
+//   tests <substring>  run the cases whose name contains it
+//
+// Prints each failed check and a summary; the exit code is 1 if anything failed.
+
+#include "testing.h"
+
+namespace {
+    struct Registered {
+        const char* name;
+        Testing::Case run;
+    };
+
+    std::vector<Registered>& registry() {
+        static std::vector<Registered> cases;
+        return cases;
+    }
+
+    int failures = 0;
+}
+
+Testing::Registration::Registration(const char* name, Case run) {
+    registry().push_back({name, run});
+}
+
+void Testing::fail(const char* file, int line, const char* expression) {
+    std::cout << "  " << file << ":" << line << ": CHECK(" << expression << ") failed\n";
+    failures++;
+}
+
+void Testing::playRandom(GameState& state, uint32_t seed, int plies, Rules::DeckOrder order) {
+    std::mt19937 rng(seed);
+    Rules::setupGame(state, rng, order);
+    std::vector<Rules::Action> actions;
+    for (int ply = 0; ply < plies && Rules::result(state) == Rules::ONGOING; ply++) {
+        Rules::legalActions(state, actions);
+        Rules::step(state, actions[rng() % actions.size()], rng);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::string filter = argc > 1 ? argv[1] : "";
+    auto cases = registry();
+    std::sort(cases.begin(), cases.end(), [](const Registered& a, const Registered& b) {
+        return std::strcmp(a.name, b.name) < 0;
+    });
+
+    int run = 0, failed = 0;
+    for (const Registered& test : cases) {
+        if (!filter.empty() && std::string(test.name).find(filter) == std::string::npos) continue;
+        int before = failures;
+        test.run();
+        run++;
+        bool passed = failures == before;
+        failed += !passed;
+        std::cout << (passed ? "pass " : "FAIL ") << test.name << "\n";
+    }
+    std::cout << run << " tests, " << failed << " failed, " << failures << " failed checks\n";
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,544 @@
+// Tournament runner for comparing AI variants.
+//
+//   tournament [seeds] [agents] [report] [threads]                  round robin
+//   tournament swiss <rounds> [seeds] [agents] [report] [threads]   Swiss pairing
+//
+// agents is a comma-separated list (default "random,greedy,solver:200,solver"):
+//   random            uniform legal moves, ends the turn 15% of the time
+//   greedy            best single action by the static heuristic, repeated until nothing helps
+//   solver[:N]        TurnSolver with a budget of N positions per turn (default 50000)
+//   net[:N]           the same with the trained evaluator (tensor_ai.bin)
+//   mcts[:N[:T]]      Mcts with N playouts per search (default 2000) on T threads sharing one tree
+//   rootmcts[:N[:T]]  the same with a private tree per thread, merged at the root
+//
+// Every pairing plays each seed twice with the sides swapped: both games use
+// the same shuffled deck and the same tensor peak draws, so luck of the deal
+// cancels out. Games run in parallel; results are kept by job index, so a run
+// is reproducible whatever the thread count. Ratings are a Bradley-Terry Elo
+// fit with bootstrap 95% intervals (resampling whole seed pairs) and Glicko,
+// one rating period per seed so each period stays small.
+
+#include "turnflow.h"
+#include "mcts.h"
+#include "evaluator.h"
+#include "effects.h"
+#include <fstream>
+
+namespace {
+    struct AgentSpec {
+        enum Kind { RANDOM, GREEDY, SOLVER, MCTS } kind = SOLVER;
+        std::string name;
+        int budget = TurnSolver::DEFAULT_MAX_POSITIONS;
+        bool useNet = false;
+        int threads = 1;
+        Mcts::Mode mode = Mcts::TREE_PARALLEL;
+    };
+
+    class RandomAgent : public TurnFlow::Agent {
+    public:
+        explicit RandomAgent(uint32_t seed) : rng(seed) {}
+
+        // Same behaviour policy as the trainer's random games
+        Rules::Action choose(const GameState& state) override {
+            Rules::legalActions(state, actions);
+            if (actions.size() == 1 || rng() % 100 < 15) {
+                return actions.back();
+            }
+            return actions[rng() % (actions.size() - 1)];
+        }
+
+    private:
+        std::mt19937 rng;
+        std::vector<Rules::Action> actions;
+    };
+
+    class GreedyAgent : public TurnFlow::Agent {
+    public:
+        Rules::Action choose(const GameState& state) override {
+            Rules::Side side = Rules::toMove(state);
+            Rules::legalActions(state, actions);
+            Rules::Action best = actions.back();  // END_TURN unless something scores higher
+            float bestScore = TurnSolver::heuristic(state, side);
+            for (size_t i = 0; i + 1 < actions.size(); i++) {
+                GameState next = state;
+                Rules::apply(next, actions[i]);
+                float score = TurnSolver::heuristic(next, side);
+                if (score > bestScore) {
+                    bestScore = score;
+                    best = actions[i];
+                }
+            }
+            return best;
+        }
+
+    private:
+        std::vector<Rules::Action> actions;
+    };
+
+    bool parseAgent(const std::string& text, AgentSpec& spec) {
+        spec = AgentSpec{};
+        spec.name = text;
+        std::string kind = text.substr(0, text.find(':'));
+        if (kind == "mcts" || kind == "rootmcts") {
+            spec.budget = Mcts::DEFAULT_ITERATIONS;
+        }
+        size_t colon = text.find(':');
+        if (colon != std::string::npos) {
+            spec.budget = std::atoi(text.c_str() + colon + 1);
+            if (spec.budget <= 0) return false;
+            if (size_t second = text.find(':', colon + 1); second != std::string::npos) {
+                spec.threads = std::atoi(text.c_str() + second + 1);
+                if (spec.threads <= 0 || spec.threads > Mcts::MAX_THREADS) return false;
+            }
+        }
+        if (kind == "random") {
+            spec.kind = AgentSpec::RANDOM;
+        } else if (kind == "greedy") {
+            spec.kind = AgentSpec::GREEDY;
+        } else if (kind == "solver" || kind == "net") {
+            spec.kind = AgentSpec::SOLVER;
+            spec.useNet = kind == "net";
+        } else if (kind == "mcts" || kind == "rootmcts") {
+            spec.kind = AgentSpec::MCTS;
+            spec.mode = kind == "mcts" ? Mcts::TREE_PARALLEL : Mcts::ROOT_PARALLEL;
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    std::unique_ptr<TurnFlow::Agent> makeAgent(const AgentSpec& spec, const Evaluator* net, uint32_t seed) {
+        switch (spec.kind) {
+            case AgentSpec::RANDOM: return std::make_unique<RandomAgent>(seed);
+            case AgentSpec::GREEDY: return std::make_unique<GreedyAgent>();
+            case AgentSpec::MCTS: {
+                Mcts::Options options;
+                options.iterations = spec.budget;
+                options.threads = spec.threads;
+                options.mode = spec.mode;
+                options.seed = seed;
+                return std::make_unique<MctsAgent>(options);
+            }
+            case AgentSpec::SOLVER: break;
+        }
+        return std::make_unique<TurnFlow::SolverAgent>(spec.useNet ? net : nullptr, spec.budget);
+    }
+
+    // Two agents meeting on one seed; each plays both sides of it
+    struct Job {
+        int a, b;
+        uint32_t seed;
+        int period;
+    };
+
+    struct GameRecord {
+        Rules::Result result = Rules::ONGOING;
+        double seconds[2] = {};   // thinking time of PLAYER and ENEMY
+        int moves[2] = {};
+    };
+
+    struct JobResult {
+        GameRecord games[2];   // games[0]: a is PLAYER, games[1]: b is PLAYER
+        double scoreA() const {
+            double score = 0;
+            for (int g = 0; g < 2; g++) {
+                Rules::Result result = games[g].result;
+                Rules::Result aWins = g == 0 ? Rules::PLAYER_WIN : Rules::ENEMY_WIN;
+                score += result == aWins ? 1.0 : result == Rules::DRAW ? 0.5 : 0.0;
+            }
+            return score;
+        }
+    };
+
+    GameRecord playGame(const AgentSpec& playerSpec, const AgentSpec& enemySpec, uint32_t seed, const Evaluator* net) {
+        std::mt19937 deckRng(seed);
+        std::mt19937 peakRng(seed ^ 0x9E3779B9u);
+        GameState state;
+        Rules::setupGame(state, deckRng);
+
+        // Agents are seeded by side, not by identity, so a swapped rematch sees the same dice
+        std::unique_ptr<TurnFlow::Agent> agents[2] = {
+            makeAgent(playerSpec, net, seed * 2 + 1),
+            makeAgent(enemySpec, net, seed * 2 + 2)
+        };
+
+        GameRecord record;
+        TurnFlow::Match match = TurnFlow::play(state);
+        while (!match.done()) {
+            if (match.request().type == TurnFlow::TENSOR_PEAK) {
+                match.resolvePeak(TurnFlow::randomPeak(state, peakRng));
+                continue;
+            }
+            Rules::Side side = match.request().side;
+            auto start = std::chrono::steady_clock::now();
+            Rules::Action action = agents[side]->choose(state);
+            record.seconds[side] += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            record.moves[side]++;
+            if (!Rules::isLegal(state, action)) {
+                action = Rules::Action::endTurn();  // a broken agent forfeits its turn, not the run
+            }
+            match.decide(action);
+        }
+        record.result = Rules::result(state);
+        return record;
+    }
+
+    void runJobs(const std::vector<Job>& jobs, std::vector<JobResult>& results, const std::vector<AgentSpec>& agents,
+                 const Evaluator* net, int threads) {
+        results.assign(jobs.size(), JobResult{});
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> finished{0};
+        auto work = [&]() {
+            for (size_t i = next++; i < jobs.size(); i = next++) {
+                const Job& job = jobs[i];
+                results[i].games[0] = playGame(agents[job.a], agents[job.b], job.seed, net);
+                results[i].games[1] = playGame(agents[job.b], agents[job.a], job.seed, net);
+                size_t done = ++finished;
+                if (done % 50 == 0 || done == jobs.size()) {
+                    std::cerr << "\r  " << done << "/" << jobs.size() << " seed pairs" << std::flush;
+                }
+            }
+        };
+        std::vector<std::thread> pool;
+        for (int t = 1; t < threads; t++) {
+            pool.emplace_back(work);
+        }
+        work();
+        for (auto& thread : pool) {
+            thread.join();
+        }
+        std::cerr << "\n";
+    }
+
+    // Bradley-Terry maximum likelihood by minorization-maximization, draws as half
+    // a win each. One virtual draw against a fixed 1500 anchor keeps winless or
+    // unbeaten agents finite. Returns Elo with a mean of 1500.
+    std::vector<double> fitElo(const std::vector<Job>& jobs, const std::vector<JobResult>& results,
+                               const std::vector<size_t>& sample, int agents) {
+        std::vector<double> wins(agents, 0.5);
+        std::vector<std::vector<double>> games(agents, std::vector<double>(agents, 0.0));
+        for (size_t index : sample) {
+            const Job& job = jobs[index];
+            double scoreA = results[index].scoreA();
+            wins[job.a] += scoreA;
+            wins[job.b] += 2.0 - scoreA;
+            games[job.a][job.b] += 2.0;
+            games[job.b][job.a] += 2.0;
+        }
+
+        std::vector<double> strength(agents, 1.0);
+        for (int iteration = 0; iteration < 200; iteration++) {
+            double change = 0;
+            for (int i = 0; i < agents; i++) {
+                double denominator = 1.0 / (strength[i] + 1.0);  // the anchor's virtual game
+                for (int j = 0; j < agents; j++) {
+                    if (j != i && games[i][j] > 0) {
+                        denominator += games[i][j] / (strength[i] + strength[j]);
+                    }
+                }
+                double updated = wins[i] / denominator;
+                change = std::max(change, std::abs(std::log(updated / strength[i])));
+                strength[i] = updated;
+            }
+            if (change < 1e-9) break;
+        }
+
+        std::vector<double> elo(agents);
+        double mean = 0;
+        for (int i = 0; i < agents; i++) {
+            elo[i] = 400.0 * std::log10(strength[i]);
+            mean += elo[i] / agents;
+        }
+        for (double& rating : elo) {
+            rating += 1500.0 - mean;
+        }
+        return elo;
+    }
+
+    // Glicko (Glickman 1999): every game in a period is scored against the
+    // opponents' ratings as they stood at the start of that period.
+    struct Glicko {
+        double rating = 1500.0;
+        double deviation = 350.0;
+    };
+
+    std::vector<Glicko> rateGlicko(const std::vector<Job>& jobs, const std::vector<JobResult>& results, int agents) {
+        const double q = std::log(10.0) / 400.0;
+        const double pi = 3.14159265358979323846;
+        auto g = [&](double deviation) {
+            return 1.0 / std::sqrt(1.0 + 3.0 * q * q * deviation * deviation / (pi * pi));
+        };
+
+        std::vector<Glicko> ratings(agents);
+        int lastPeriod = 0;
+        for (const auto& job : jobs) lastPeriod = std::max(lastPeriod, job.period);
+
+        for (int period = 0; period <= lastPeriod; period++) {
+            std::vector<double> sumScore(agents, 0.0), sumInfo(agents, 0.0);
+            std::vector<Glicko> before = ratings;
+            for (size_t i = 0; i < jobs.size(); i++) {
+                const Job& job = jobs[i];
+                if (job.period != period) continue;
+                double scores[2] = {results[i].scoreA(), 2.0 - results[i].scoreA()};
+                int sides[2] = {job.a, job.b};
+                for (int s = 0; s < 2; s++) {
+                    const Glicko& self = before[sides[s]];
+                    const Glicko& other = before[sides[1 - s]];
+                    double weight = g(other.deviation);
+                    double expected = 1.0 / (1.0 + std::pow(10.0, -weight * (self.rating - other.rating) / 400.0));
+                    sumScore[sides[s]] += weight * (scores[s] - 2.0 * expected);      // two games per job
+                    sumInfo[sides[s]] += 2.0 * weight * weight * expected * (1.0 - expected);
+                }
+            }
+            for (int a = 0; a < agents; a++) {
+                if (sumInfo[a] <= 0) continue;
+                double dSquaredInverse = q * q * sumInfo[a];
+                double precision = 1.0 / (before[a].deviation * before[a].deviation) + dSquaredInverse;
+                ratings[a].rating = before[a].rating + q / precision * sumScore[a];
+                ratings[a].deviation = std::sqrt(1.0 / precision);
+            }
+        }
+        return ratings;
+    }
+
+    struct AgentTotals {
+        int games = 0;
+        int wins = 0;
+        int draws = 0;
+        int losses = 0;
+        double seconds = 0;
+        int moves = 0;
+        double points = 0;   // Swiss standings: 1 per seed pair won, 0.5 if split
+    };
+
+    std::vector<AgentTotals> tally(const std::vector<Job>& jobs, const std::vector<JobResult>& results, int agents) {
+        std::vector<AgentTotals> totals(agents);
+        for (size_t i = 0; i < jobs.size(); i++) {
+            const Job& job = jobs[i];
+            for (int g = 0; g < 2; g++) {
+                const GameRecord& game = results[i].games[g];
+                int player = g == 0 ? job.a : job.b;
+                int enemy = g == 0 ? job.b : job.a;
+                for (int side = 0; side < 2; side++) {
+                    int agent = side == Rules::PLAYER ? player : enemy;
+                    Rules::Result win = side == Rules::PLAYER ? Rules::PLAYER_WIN : Rules::ENEMY_WIN;
+                    AgentTotals& t = totals[agent];
+                    t.games++;
+                    t.seconds += game.seconds[side];
+                    t.moves += game.moves[side];
+                    if (game.result == Rules::DRAW) {
+                        t.draws++;
+                    } else if (game.result == win) {
+                        t.wins++;
+                    } else {
+                        t.losses++;
+                    }
+                }
+            }
+            double scoreA = results[i].scoreA();
+            totals[job.a].points += scoreA > 1.0 ? 1.0 : scoreA == 1.0 ? 0.5 : 0.0;
+            totals[job.b].points += scoreA < 1.0 ? 1.0 : scoreA == 1.0 ? 0.5 : 0.0;
+        }
+        return totals;
+    }
+
+    // Pairs agents of neighbouring standing, avoiding rematches where possible; the
+    // lowest-ranked agent without a bye sits out when the field is odd.
+    std::vector<std::pair<int, int>> swissPairings(const std::vector<AgentTotals>& totals,
+                                                   std::set<std::pair<int, int>>& played, std::vector<bool>& hadBye) {
+        int agents = static_cast<int>(totals.size());
+        std::vector<int> order(agents);
+        for (int i = 0; i < agents; i++) order[i] = i;
+        std::stable_sort(order.begin(), order.end(), [&](int x, int y) { return totals[x].points > totals[y].points; });
+
+        if (agents % 2) {
+            for (int i = agents - 1; i >= 0; i--) {
+                if (!hadBye[order[i]] || i == 0) {
+                    hadBye[order[i]] = true;
+                    order.erase(order.begin() + i);
+                    break;
+                }
+            }
+        }
+
+        std::vector<std::pair<int, int>> pairs;
+        std::vector<bool> used(order.size(), false);
+        for (size_t i = 0; i < order.size(); i++) {
+            if (used[i]) continue;
+            size_t partner = order.size();
+            for (size_t j = i + 1; j < order.size(); j++) {
+                if (used[j]) continue;
+                if (partner == order.size()) partner = j;  // fallback: the nearest, even if it is a rematch
+                if (!played.count({std::min(order[i], order[j]), std::max(order[i], order[j])})) {
+                    partner = j;
+                    break;
+                }
+            }
+            if (partner == order.size()) break;
+            used[i] = used[partner] = true;
+            pairs.push_back({order[i], order[partner]});
+            played.insert({std::min(order[i], order[partner]), std::max(order[i], order[partner])});
+        }
+        return pairs;
+    }
+
+    void writeReport(std::ostream& out, const std::vector<AgentSpec>& agents, const std::vector<Job>& jobs,
+                     const std::vector<JobResult>& results, const std::string& format, double seconds) {
+        int count = static_cast<int>(agents.size());
+        std::vector<size_t> all(jobs.size());
+        for (size_t i = 0; i < all.size(); i++) all[i] = i;
+        std::vector<double> elo = fitElo(jobs, results, all, count);
+
+        // Bootstrap over seed pairs for the Elo intervals
+        const int RESAMPLES = 200;
+        std::mt19937 rng(2024);
+        std::vector<std::vector<double>> samples(count);
+        std::vector<size_t> sample(jobs.size());
+        for (int r = 0; r < RESAMPLES && !jobs.empty(); r++) {
+            for (auto& index : sample) index = rng() % jobs.size();
+            std::vector<double> fitted = fitElo(jobs, results, sample, count);
+            for (int a = 0; a < count; a++) samples[a].push_back(fitted[a]);
+        }
+
+        std::vector<Glicko> glicko = rateGlicko(jobs, results, count);
+        std::vector<AgentTotals> totals = tally(jobs, results, count);
+
+        std::vector<int> order(count);
+        for (int i = 0; i < count; i++) order[i] = i;
+        std::sort(order.begin(), order.end(), [&](int x, int y) { return elo[x] > elo[y]; });
+
+        out << "# Tournament report\n\n"
+            << format << ", " << jobs.size() << " seed pairs, " << jobs.size() * 2 << " games in "
+            << std::fixed << std::setprecision(1) << seconds << "s\n\n"
+            << "| Agent | Elo | 95% CI | Glicko | +/- 2RD | W-D-L | Score | ms/move |\n"
+            << "|---|---|---|---|---|---|---|---|\n";
+        for (int a : order) {
+            std::vector<double>& s = samples[a];
+            std::sort(s.begin(), s.end());
+            double low = s.empty() ? elo[a] : s[s.size() * 25 / 1000];
+            double high = s.empty() ? elo[a] : s[std::min(s.size() - 1, s.size() * 975 / 1000)];
+            const AgentTotals& t = totals[a];
+            double score = t.games ? (t.wins + 0.5 * t.draws) / t.games : 0.0;
+            out << "| " << agents[a].name << " | " << std::setprecision(0) << elo[a]
+                << " | " << low << " to " << high
+                << " | " << glicko[a].rating << " | " << 2 * glicko[a].deviation
+                << " | " << t.wins << "-" << t.draws << "-" << t.losses
+                << " | " << std::setprecision(1) << 100.0 * score << "%"
+                << " | " << std::setprecision(2) << (t.moves ? 1000.0 * t.seconds / t.moves : 0.0) << " |\n";
+        }
+
+        // Row agent's score against each column agent
+        out << "\n| Score vs | ";
+        for (int b : order) out << agents[b].name << " | ";
+        out << "\n|---|";
+        for (int i = 0; i < count; i++) out << "---|";
+        out << "\n";
+        for (int a : order) {
+            out << "| " << agents[a].name << " | ";
+            for (int b : order) {
+                double score = 0, games = 0;
+                for (size_t i = 0; i < jobs.size(); i++) {
+                    if (jobs[i].a == a && jobs[i].b == b) score += results[i].scoreA();
+                    else if (jobs[i].a == b && jobs[i].b == a) score += 2.0 - results[i].scoreA();
+                    else continue;
+                    games += 2;
+                }
+                if (games > 0) out << std::setprecision(1) << 100.0 * score / games << "% | ";
+                else out << "- | ";
+            }
+            out << "\n";
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    int arg = 1;
+    bool swiss = argc > 1 && std::string(argv[1]) == "swiss";
+    int rounds = 0;
+    if (swiss) {
+        rounds = argc > 2 ? std::atoi(argv[2]) : 5;
+        arg = 3;
+    }
+    int seeds = argc > arg ? std::atoi(argv[arg]) : 100;
+    std::string agentList = argc > arg + 1 ? argv[arg + 1] : "random,greedy,solver:200,solver";
+    std::string reportPath = argc > arg + 2 ? argv[arg + 2] : "tournament_report.md";
+    int threads = argc > arg + 3 ? std::atoi(argv[arg + 3]) : std::max(1u, std::thread::hardware_concurrency());
+
+    std::vector<AgentSpec> agents;
+    std::stringstream list(agentList);
+    for (std::string item; std::getline(list, item, ',');) {
+        AgentSpec spec;
+        if (!parseAgent(item, spec)) {
+            std::cerr << "Unknown agent '" << item << "' (random, greedy, solver[:N], net[:N])\n";
+            return 1;
+        }
+        agents.push_back(spec);
+    }
+    if (agents.size() < 2 || seeds <= 0 || threads <= 0) {
+        std::cerr << "Need at least two agents and a positive seed and thread count\n";
+        return 1;
+    }
+
+    // Balance changes in tensor_effects.txt are what a tournament is usually for
+    std::string effectsError;
+    if (!Effects::loadDefaultFile(effectsError)) {
+        std::cerr << effectsError << "\n";
+        return 1;
+    }
+
+    Evaluator net;
+    bool needNet = std::any_of(agents.begin(), agents.end(), [](const AgentSpec& a) { return a.useNet; });
+    if (needNet && !net.load(Evaluator::DEFAULT_WEIGHTS)) {
+        std::cerr << "net agents need " << Evaluator::DEFAULT_WEIGHTS << " (run the trainer first)\n";
+        return 1;
+    }
+
+    std::vector<Job> jobs;
+    std::vector<JobResult> results;
+    std::string format;
+    auto start = std::chrono::steady_clock::now();
+    int count = static_cast<int>(agents.size());
+
+    if (!swiss) {
+        format = "Round robin, " + std::to_string(seeds) + " seeds per pairing";
+        for (int s = 0; s < seeds; s++) {
+            for (int a = 0; a < count; a++) {
+                for (int b = a + 1; b < count; b++) {
+                    jobs.push_back({a, b, static_cast<uint32_t>(1000 + s), s});
+                }
+            }
+        }
+        std::cerr << "Round robin: " << count << " agents, " << jobs.size() << " seed pairs on " << threads << " threads\n";
+        runJobs(jobs, results, agents, &net, threads);
+    } else {
+        format = "Swiss, " + std::to_string(rounds) + " rounds of " + std::to_string(seeds) + " seeds per pairing";
+        std::set<std::pair<int, int>> played;
+        std::vector<bool> hadBye(count, false);
+        for (int round = 0; round < rounds; round++) {
+            std::vector<AgentTotals> totals = tally(jobs, results, count);
+            std::vector<Job> roundJobs;
+            for (const auto& pair : swissPairings(totals, played, hadBye)) {
+                for (int s = 0; s < seeds; s++) {
+                    roundJobs.push_back({pair.first, pair.second, static_cast<uint32_t>(1000 + round * seeds + s), round * seeds + s});
+                }
+            }
+            std::cerr << "Round " << round + 1 << ": " << roundJobs.size() << " seed pairs\n";
+            std::vector<JobResult> roundResults;
+            runJobs(roundJobs, roundResults, agents, &net, threads);
+            jobs.insert(jobs.end(), roundJobs.begin(), roundJobs.end());
+            results.insert(results.end(), roundResults.begin(), roundResults.end());
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::ostringstream text;
+    writeReport(text, agents, jobs, results, format, seconds);
+    std::cout << text.str();
+    std::ofstream report(reportPath);
+    if (!report || !(report << text.str())) {
+        std::cerr << "Cannot write " << reportPath << "\n";
+        return 1;
+    }
+    std::cout << "\nReport written to " << reportPath << "\n";
+    return 0;
+}
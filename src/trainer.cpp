@@ -0,0 +1,220 @@
+// Offline trainer for the AI evaluator.
+// Plays headless self-play games through Rules, streams every decision into a
+// memory-mapped Dataset file, and fits the value/policy net from that file.
+//
+//   trainer generate <games> [dataset]             self-play into a dataset
+//   trainer train [dataset] [epochs] [weights]     fit weights from a dataset
+//   trainer info [dataset]                         summary of a dataset
+//   trainer [games] [epochs] [weights]             generate + train in one go
+
+#include "evaluator.h"
+#include "dataset.h"
+#include "effects.h"
+
+namespace {
+    // Behaviour policy: the current net greedily when it has weights, random legal moves otherwise.
+    // Ending the turn is only picked when nothing else is wanted so games keep moving.
+    Rules::Action chooseAction(const GameState& state, const std::vector<Rules::Action>& actions,
+                               const Evaluator* net, std::mt19937& rng) {
+        std::uniform_real_distribution<float> coin(0.0f, 1.0f);
+        if (actions.size() == 1 || coin(rng) < 0.15f) {
+            return actions.back();  // END_TURN is always last
+        }
+        if (!net || coin(rng) < 0.2f) {
+            return actions[rng() % (actions.size() - 1)];
+        }
+
+        Rules::Side side = Rules::toMove(state);
+        std::vector<float> batch(actions.size() * Evaluator::NUM_FEATURES);
+        for (size_t i = 0; i < actions.size(); i++) {
+            GameState next = state;
+            Rules::apply(next, actions[i]);
+            Evaluator::extractFeatures(next, side, &batch[i * Evaluator::NUM_FEATURES]);
+        }
+        std::vector<float> values(actions.size());
+        net->evaluate(batch.data(), actions.size(), values.data());
+        return actions[std::max_element(values.begin(), values.end()) - values.begin()];
+    }
+
+    // One self-play game; rows are buffered until the outcome is known
+    void playGame(Dataset::Writer& writer, uint32_t gameId, const Evaluator* net, std::mt19937& rng) {
+        GameState state;
+        Rules::setupGame(state, rng);
+
+        struct Decision {
+            Dataset::PositionRow row;
+            Rules::Action action;
+            Rules::Side side;
+        };
+        std::vector<Decision> decisions;
+        std::vector<Rules::Action> actions;
+
+        while (Rules::result(state) == Rules::ONGOING) {
+            Rules::legalActions(state, actions);
+            Decision decision;
+            decision.action = chooseAction(state, actions, net, rng);
+            decision.side = Rules::toMove(state);
+            Dataset::encode(state, decision.row);
+            decisions.push_back(decision);
+
+            Rules::step(state, decision.action, rng);
+        }
+
+        Rules::Result result = Rules::result(state);
+        for (const auto& d : decisions) {
+            int8_t outcome = 0;
+            if (result != Rules::DRAW) {
+                bool won = (result == Rules::PLAYER_WIN) == (d.side == Rules::PLAYER);
+                outcome = won ? 1 : -1;
+            }
+            writer.append(d.row, d.action, outcome, gameId);
+        }
+    }
+
+    int generate(int games, const std::string& path, const std::string& weights) {
+        std::mt19937 rng(12345);
+        Evaluator net;
+        bool guided = net.load(weights);
+
+        Dataset::Writer writer;
+        if (!writer.open(path)) {
+            std::cerr << "Cannot write " << path << "\n";
+            return 1;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        for (int g = 0; g < games; g++) {
+            playGame(writer, g, guided ? &net : nullptr, rng);
+        }
+        uint64_t rows = writer.rows();
+        if (!writer.close()) {
+            std::cerr << "Failed writing " << path << "\n";
+            return 1;
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << games << " games, " << rows << " positions in "
+                  << std::fixed << std::setprecision(2) << seconds << "s -> " << path
+                  << (guided ? " (guided by " + weights + ")" : "") << "\n";
+        return 0;
+    }
+
+    int train(const std::string& path, int epochs, const std::string& weights) {
+        Dataset::Reader reader;
+        if (!reader.open(path)) {
+            std::cerr << "Cannot read dataset " << path << "\n";
+            return 1;
+        }
+
+        std::mt19937 rng(12345);
+        Evaluator net;
+        bool resumed = net.load(weights);
+        if (!resumed) net.initRandom(rng);
+        std::cout << (resumed ? "Continuing from " : "Training new net into ") << weights
+                  << " on " << reader.rows() << " positions\n";
+
+        const int batchSize = 64;
+        std::vector<float> features(batchSize * Evaluator::NUM_FEATURES);
+        std::vector<float> targets(batchSize);
+        std::vector<int> actions(batchSize);
+        std::vector<uint64_t> order(reader.rows());
+        for (uint64_t i = 0; i < order.size(); i++) order[i] = i;
+
+        GameState scratch;
+        for (int epoch = 0; epoch < epochs; epoch++) {
+            std::shuffle(order.begin(), order.end(), rng);
+            float lossSum = 0.0f;
+            int batches = 0, filled = 0;
+            uint64_t skipped = 0;
+            for (uint64_t row : order) {
+                // A row naming a card type, faction or role the game doesn't have is corrupt
+                if (!Dataset::decode(reader.position(row), scratch)) {
+                    skipped++;
+                    continue;
+                }
+                Evaluator::extractFeatures(scratch, Rules::toMove(scratch), &features[filled * Evaluator::NUM_FEATURES]);
+                targets[filled] = reader.outcome(row);
+                // Only imitate moves made by the eventual winner
+                actions[filled] = reader.outcome(row) > 0 ? reader.action(row).slot : -1;
+                if (++filled < batchSize) continue;
+                lossSum += net.train(features.data(), targets.data(), actions.data(), batchSize, 0.01f);
+                batches++;
+                filled = 0;
+            }
+            std::cout << "epoch " << epoch + 1 << " loss " << (batches ? lossSum / batches : 0.0f);
+            if (skipped) std::cout << ", skipped " << skipped << " corrupt rows";
+            std::cout << "\n";
+        }
+
+        net.quantize();
+        if (!net.save(weights)) {
+            std::cerr << "Failed to write " << weights << "\n";
+            return 1;
+        }
+        std::cout << "Saved " << weights << "\n";
+        return 0;
+    }
+
+    int info(const std::string& path) {
+        Dataset::Reader reader;
+        if (!reader.open(path)) {
+            std::cerr << "Cannot read dataset " << path << "\n";
+            return 1;
+        }
+
+        // Sequential column scans straight out of the mapping
+        uint64_t wins = 0, losses = 0, endTurns = 0, games = 0;
+        uint32_t lastGame = UINT32_MAX;
+        for (size_t g = 0; g < reader.groups(); g++) {
+            uint64_t count;
+            const int8_t* outcomes = reader.groupColumn<int8_t>(g, Dataset::OUTCOME, count);
+            const Dataset::PackedAction* acts = reader.groupColumn<Dataset::PackedAction>(g, Dataset::ACTION, count);
+            const uint32_t* ids = reader.groupColumn<uint32_t>(g, Dataset::GAME, count);
+            for (uint64_t i = 0; i < count; i++) {
+                wins += outcomes[i] > 0;
+                losses += outcomes[i] < 0;
+                endTurns += acts[i].type == Rules::Action::END_TURN;
+                if (ids[i] != lastGame) {
+                    games++;
+                    lastGame = ids[i];
+                }
+            }
+        }
+
+        std::cout << path << ": " << reader.rows() << " positions in " << reader.groups() << " row groups\n"
+                  << "  games: " << games << ", positions/game: "
+                  << std::fixed << std::setprecision(1) << (games ? double(reader.rows()) / games : 0.0) << "\n"
+                  << "  mover won: " << wins << ", mover lost: " << losses << "\n"
+                  << "  end-turn actions: " << endTurns << "\n";
+        return 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::string command = argc > 1 ? argv[1] : "";
+
+    // The dataset is only right for the rules the game plays, tensor_effects.txt included
+    std::string effectsError;
+    if (!Effects::loadDefaultFile(effectsError)) {
+        std::cerr << effectsError << "\n";
+        return 1;
+    }
+
+    if (command == "generate") {
+        int games = argc > 2 ? std::atoi(argv[2]) : 2000;
+        return generate(games, argc > 3 ? argv[3] : Dataset::DEFAULT_PATH, Evaluator::DEFAULT_WEIGHTS);
+    }
+    if (command == "train") {
+        return train(argc > 2 ? argv[2] : Dataset::DEFAULT_PATH,
+                     argc > 3 ? std::atoi(argv[3]) : 10,
+                     argc > 4 ? argv[4] : Evaluator::DEFAULT_WEIGHTS);
+    }
+    if (command == "info") {
+        return info(argc > 2 ? argv[2] : Dataset::DEFAULT_PATH);
+    }
+
+    int games = argc > 1 ? std::atoi(argv[1]) : 2000;
+    int epochs = argc > 2 ? std::atoi(argv[2]) : 10;
+    std::string weights = argc > 3 ? argv[3] : Evaluator::DEFAULT_WEIGHTS;
+    int status = generate(games, Dataset::DEFAULT_PATH, weights);
+    return status ? status : train(Dataset::DEFAULT_PATH, epochs, weights);
+}
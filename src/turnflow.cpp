@@ -0,0 +1,123 @@
+#include "turnflow.h"
+#include "book.h"
+#include "minigame_engine.h"
+
+namespace {
+    using Promise = TurnFlow::Match::promise_type;
+
+    struct ActionAwaiter {
+        Rules::Side side;
+        Promise* promise = nullptr;
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<Promise> h) noexcept {
+            promise = &h.promise();
+            promise->request = {TurnFlow::ACTION, side};
+        }
+        Rules::Action await_resume() const noexcept { return promise->action; }
+    };
+
+    struct PeakAwaiter {
+        Promise* promise = nullptr;
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<Promise> h) noexcept {
+            promise = &h.promise();
+            promise->request = {TurnFlow::TENSOR_PEAK, Rules::PLAYER};
+        }
+        TurnFlow::PeakResult await_resume() const noexcept { return promise->peak; }
+    };
+
+    // Lets the coroutine body reach its own promise to record what happened
+    struct PromiseAwaiter {
+        Promise* promise = nullptr;
+
+        bool await_ready() const noexcept { return false; }
+        bool await_suspend(std::coroutine_handle<Promise> h) noexcept {
+            promise = &h.promise();
+            return false;  // never actually suspends
+        }
+        Promise& await_resume() const noexcept { return *promise; }
+    };
+}
+
+TurnFlow::Match& TurnFlow::Match::operator=(Match&& other) noexcept {
+    if (this != &other) {
+        if (handle) handle.destroy();
+        handle = std::exchange(other.handle, nullptr);
+    }
+    return *this;
+}
+
+TurnFlow::Match::~Match() {
+    if (handle) handle.destroy();
+}
+
+void TurnFlow::Match::decide(const Rules::Action& action) {
+    if (done() || request().type != ACTION) return;
+    handle.promise().action = action;
+    handle.resume();
+}
+
+void TurnFlow::Match::resolvePeak(const PeakResult& peak) {
+    if (done() || request().type != TENSOR_PEAK) return;
+    handle.promise().peak = peak;
+    handle.resume();
+}
+
+TurnFlow::Match TurnFlow::play(GameState& state) {
+    Promise& promise = co_await PromiseAwaiter{};
+
+    while (Rules::result(state) == Rules::ONGOING) {
+        Rules::Side side = Rules::toMove(state);
+        Rules::Action action = co_await ActionAwaiter{side};
+
+        // An illegal answer changes nothing and the same side is asked again
+        Rules::Outcome outcome = Rules::apply(state, action);
+        promise.last = {side, action, outcome};
+        if (!outcome.legal) continue;
+
+        if (outcome.tensorPeak) {
+            PeakResult peak = co_await PeakAwaiter{};
+            Rules::resolveTensorPeak(state, peak.playerWon, peak.consequence);
+        }
+    }
+}
+
+TurnFlow::PeakResult TurnFlow::randomPeak(const GameState& state, std::mt19937& rng) {
+    PeakResult peak;
+    peak.playerWon = Minigames::playRandom(rng);
+    peak.consequence = static_cast<int>(rng() % state.rules->stakeCount);
+    return peak;
+}
+
+TurnFlow::SolverAgent::SolverAgent(const Evaluator* evaluator, int maxPositions)
+    : solver(evaluator, maxPositions) {}
+
+Rules::Action TurnFlow::SolverAgent::choose(const GameState& state) {
+    // The book beats any plan; what is left of a plan assumed the search's own line, so drop it
+    Rules::Action booked;
+    if (book && book->probe(state, booked)) {
+        plan.clear();
+        next = 0;
+        inBook = booked.type != Rules::Action::END_TURN;
+        return booked;
+    }
+    inBook = false;
+
+    if (next >= plan.size()) {
+        plan = solver.solve(state).actions;
+        next = 0;
+        if (plan.empty()) return Rules::Action::endTurn();
+    }
+
+    Rules::Action action = plan[next++];
+    // Plans stop at a tensor peak, so this only catches a plan gone stale; end the turn then
+    if (!Rules::isLegal(state, action)) {
+        action = Rules::Action::endTurn();
+    }
+    if (action.type == Rules::Action::END_TURN) {
+        next = plan.size();
+    }
+    return action;
+}
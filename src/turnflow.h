@@ -0,0 +1,103 @@
+#pragma once
+#include "solver.h"
+#include <coroutine>
+#include <utility>
+
+namespace Book { class Table; }
+
+// The match as a C++20 coroutine.
+//
+// TurnFlow::play() owns the order of play (whose turn it is, applying actions
+// through Rules, resolving tensor peaks) and suspends whenever somebody has to
+// decide something. Whoever holds the Match answers the pending Request: the
+// curses front end from the keyboard, the AI from a TurnSolver plan, the match
+// server from a socket, a replay from a log. A suspended match is just a heap
+// frame, so one thread can keep any number of them in flight.
+namespace TurnFlow {
+    enum RequestType {
+        ACTION,        // request.side picks its next action
+        TENSOR_PEAK    // the gauge peaked: the player's minigame decides the stake
+    };
+
+    struct Request {
+        RequestType type = ACTION;
+        Rules::Side side = Rules::PLAYER;
+    };
+
+    struct PeakResult {
+        bool playerWon = false;
+        int consequence = 0;  // index into the match's RuleSet::stakes
+    };
+
+    // What the last answered ACTION did, for narration
+    struct Step {
+        Rules::Side side = Rules::PLAYER;
+        Rules::Action action;
+        Rules::Outcome outcome;  // outcome.legal is false if the action was refused (and asked again)
+    };
+
+    class Match {
+    public:
+        struct promise_type {
+            Request request;
+            Rules::Action action;
+            PeakResult peak;
+            Step last;
+
+            Match get_return_object() { return Match(std::coroutine_handle<promise_type>::from_promise(*this)); }
+            std::suspend_never initial_suspend() noexcept { return {}; }   // run to the first decision
+            std::suspend_always final_suspend() noexcept { return {}; }   // keep the frame until Match goes
+            void return_void() {}
+            void unhandled_exception() { std::terminate(); }
+        };
+
+        Match() = default;
+        Match(Match&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+        Match& operator=(Match&& other) noexcept;
+        ~Match();
+
+        bool done() const { return !handle || handle.done(); }
+        const Request& request() const { return handle.promise().request; }
+        const Step& lastStep() const { return handle.promise().last; }
+
+        // Answer the pending request and run until the next one (or the end)
+        void decide(const Rules::Action& action);
+        void resolvePeak(const PeakResult& peak);
+
+    private:
+        explicit Match(std::coroutine_handle<promise_type> h) : handle(h) {}
+        std::coroutine_handle<promise_type> handle;
+    };
+
+    // Plays state out until Rules::result() is decided. state must outlive the Match.
+    Match play(GameState& state);
+
+    // Headless minigame with the same odds as Rules::resolveTensorPeak(state, rng)
+    PeakResult randomPeak(const GameState& state, std::mt19937& rng);
+
+    // Policy interface: anything that can answer a side's ACTION requests
+    class Agent {
+    public:
+        virtual ~Agent() = default;
+        virtual Rules::Action choose(const GameState& state) = 0;
+    };
+
+    // AI side: one TurnSolver search per turn, then that plan's actions in order.
+    // With a book, a position the book knows is answered from it instead.
+    class SolverAgent : public Agent {
+    public:
+        explicit SolverAgent(const Evaluator* evaluator = nullptr, int maxPositions = TurnSolver::DEFAULT_MAX_POSITIONS);
+
+        void setBook(const Book::Table* table) { book = table; }
+        bool startingTurn() const { return next >= plan.size() && !inBook; }  // no plan or book line under way
+        void dropPlan() { next = plan.size(); }  // the caller answered from elsewhere, so the plan no longer fits
+        Rules::Action choose(const GameState& state) override;
+
+    private:
+        TurnSolver solver;
+        const Book::Table* book = nullptr;
+        std::vector<Rules::Action> plan;
+        size_t next = 0;
+        bool inBook = false;  // this turn's last action came from the book
+    };
+}
@@ -0,0 +1,165 @@
+// Offline rendering benchmark for the curses front end.
+//
+//   uibench [frames] [COLSxLINES] [seed] [term]
+//
+// Plays seeded random matches and draws every position the way the action
+// menu does (board, menu, status bar, refresh) into a curses screen created
+// with newterm() on a pipe, so nothing reaches a real terminal. The pipe is
+// drained after every frame, which makes the byte counts exact: that is what
+// a kiosk's serial or SSH link has to carry. Section times come from the same
+// FrameStats timers as the in-game HUD. ncurses only (newterm, pipes).
+
+#include "rules.h"
+#include "framestats.h"
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+    struct Summary {
+        double mean = 0;
+        double p50 = 0;
+        double p99 = 0;
+        double max = 0;
+    };
+
+    Summary summarize(std::vector<double> values) {
+        Summary summary;
+        if (values.empty()) return summary;
+        std::sort(values.begin(), values.end());
+        for (double v : values) summary.mean += v;
+        summary.mean /= values.size();
+        summary.p50 = values[values.size() / 2];
+        summary.p99 = values[std::min(values.size() - 1, values.size() * 99 / 100)];
+        summary.max = values.back();
+        return summary;
+    }
+
+    size_t drain(int fd) {
+        char buffer[65536];
+        size_t total = 0;
+        ssize_t got;
+        while ((got = read(fd, buffer, sizeof(buffer))) > 0) {
+            total += got;
+        }
+        return total;
+    }
+
+    // Random legal moves, ending the turn 15% of the time like the trainer's random games
+    Rules::Action randomAction(const GameState& state, std::mt19937& rng, std::vector<Rules::Action>& actions) {
+        Rules::legalActions(state, actions);
+        if (actions.size() == 1 || rng() % 100 < 15) return actions.back();
+        return actions[rng() % (actions.size() - 1)];
+    }
+}
+
+int main(int argc, char** argv) {
+    int frames = argc > 1 ? std::atoi(argv[1]) : 2000;
+    int cols = 120, lines = 40;
+    if (argc > 2 && std::sscanf(argv[2], "%dx%d", &cols, &lines) != 2) {
+        std::cerr << "Screen size must look like 120x40\n";
+        return 1;
+    }
+    uint32_t seed = argc > 3 ? static_cast<uint32_t>(std::strtoul(argv[3], nullptr, 10)) : 1;
+    const char* term = argc > 4 ? argv[4] : "xterm-256color";
+    if (frames <= 0 || cols < 80 || lines < 24) {
+        std::cerr << "Need a positive frame count and at least 80x24\n";
+        return 1;
+    }
+
+    // The write end must never block mid-frame: give the pipe room for any single frame
+    int fds[2];
+    if (pipe(fds) != 0) {
+        std::cerr << "Cannot create pipe\n";
+        return 1;
+    }
+#ifdef F_SETPIPE_SZ
+    fcntl(fds[1], F_SETPIPE_SZ, 1 << 20);
+#endif
+    fcntl(fds[0], F_SETFL, O_NONBLOCK);
+    FILE* output = fdopen(fds[1], "w");
+    FILE* input = std::fopen("/dev/null", "r");
+
+    setenv("COLUMNS", std::to_string(cols).c_str(), 1);
+    setenv("LINES", std::to_string(lines).c_str(), 1);
+    SCREEN* screen = newterm(term, output, input);
+    if (!screen) {
+        std::cerr << "No terminfo entry for " << term << "\n";
+        return 1;
+    }
+    set_term(screen);
+    start_color();
+    GameUI::initializeAllColors();
+    drain(fds[0]);
+
+    FrameStats::enable(true);
+    std::mt19937 rng(seed);
+    GameState state;
+    Rules::setupGame(state, rng);
+    std::vector<Rules::Action> actions;
+
+    std::array<std::vector<double>, FrameStats::SECTION_COUNT> sections;
+    std::vector<double> totals, bytes;
+    int matches = 1;
+    for (int frame = 0; frame < frames; frame++) {
+        if (frame > 0) {
+            Rules::Outcome outcome = Rules::apply(state, randomAction(state, rng, actions));
+            if (outcome.tensorPeak) Rules::resolveTensorPeak(state, rng);
+            if (Rules::result(state) != Rules::ONGOING) {
+                Rules::setupGame(state, rng);
+                matches++;
+            }
+        }
+
+        uint64_t start = FrameStats::now();
+        state.printGameState();
+        GameUI::drawActionMenu(GameUI::ACTION_PLAY);
+        GameUI::drawStatusBar("Your turn - Choose an action");
+        GameUI::drawNavigationHints();
+        refresh();
+        uint64_t elapsed = FrameStats::now() - start;
+        FrameStats::endFrame();
+
+        const FrameStats::Frame& stats = FrameStats::lastFrame();
+        for (int s = 0; s < FrameStats::SECTION_COUNT; s++) {
+            sections[s].push_back(stats.nanos[s] / 1e3);
+        }
+        totals.push_back(elapsed / 1e3);
+        bytes.push_back(static_cast<double>(drain(fds[0])));
+    }
+
+    endwin();
+    delscreen(screen);
+    std::fclose(output);
+    std::fclose(input);
+    close(fds[0]);
+
+    std::cout << "UI benchmark: " << frames << " frames from " << matches << " matches at "
+              << cols << "x" << lines << " (" << term << ")\n\n";
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << std::left << std::setw(18) << "section" << std::right
+              << std::setw(10) << "mean us" << std::setw(10) << "p50 us" << std::setw(10) << "p99 us" << "\n";
+    auto row = [](const char* name, const Summary& s) {
+        std::cout << std::left << std::setw(18) << name << std::right
+                  << std::setw(10) << s.mean << std::setw(10) << s.p50 << std::setw(10) << s.p99 << "\n";
+    };
+    for (int s = 0; s < FrameStats::SECTION_COUNT; s++) {
+        row(FrameStats::SECTION_NAMES[s], summarize(sections[s]));
+    }
+    row("whole frame", summarize(totals));
+
+    Summary frameBytes = summarize(bytes);
+    double total = 0;
+    for (double b : bytes) total += b;
+    std::cout << "\nterminal output: " << std::setprecision(0) << frameBytes.mean << " B/frame mean, "
+              << frameBytes.p50 << " p50, " << frameBytes.max << " max (first frame " << bytes.front()
+              << "), " << total / 1024 << " KiB total\n\n";
+
+    // 8N1 serial: ten bits on the wire per byte
+    std::cout << "time on the wire per mean frame:\n";
+    for (double bitsPerSecond : {9600.0, 38400.0, 115200.0, 1e6}) {
+        double ms = frameBytes.mean * 10 / bitsPerSecond * 1000;
+        std::cout << "  " << std::setw(8) << bitsPerSecond << " bit/s  " << std::setprecision(1)
+                  << std::setw(8) << ms << " ms  (" << std::setw(6) << 1000 / ms << " frames/s)\n" << std::setprecision(0);
+    }
+    return 0;
+}